@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#include "libdm/libdevmapper.h"
+#include "disk_log.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+/*
+ * disk_log_mark_dirty
+ * @dirty: one bit per block of the log
+ * @block_size
+ * @offset: byte offset of the change in the log
+ *
+ * Mark the block holding byte @offset as dirty.
+ */
+void disk_log_mark_dirty(dm_bitset_t dirty, size_t block_size, uint64_t offset)
+{
+	dm_bit_set(dirty, (int) (offset / block_size));
+}
+
+/*
+ * disk_log_write_dirty
+ * @fd: log device or file, usually opened with O_DIRECT
+ * @buffer: in-memory log, aligned for O_DIRECT
+ * @block_size: unit of writes, a multiple of the logical block size
+ * @dirty: one bit per block of @buffer
+ *
+ * Write each run of contiguous dirty blocks of @buffer with a single
+ * write and clear the dirty bits of the blocks written.  Every write
+ * starts and ends on a @block_size boundary.  Blocks of a failed write
+ * stay dirty.
+ *
+ * Returns: number of writes issued, -errno on failure (-EIO for a short write)
+ */
+int disk_log_write_dirty(int fd, const void *buffer, size_t block_size,
+			 dm_bitset_t dirty)
+{
+	int first, end = 0, writes = 0;
+	size_t offset, len;
+	ssize_t r;
+
+	for (first = dm_bit_get_first(dirty); first >= 0;
+	     first = dm_bit_get_next(dirty, end)) {
+		if ((end = dm_bit_get_next_clear(dirty, first)) < 0)
+			end = (int) *dirty;
+
+		offset = (size_t) first * block_size;
+		len = (size_t) (end - first) * block_size;
+
+		r = pwrite(fd, (const char *)buffer + offset, len, (off_t) offset);
+		if (r < 0)
+			return errno ? -errno : -EIO;
+		if (r != (ssize_t) len)
+			return -EIO;
+
+		dm_bit_clear_range(dirty, first, end - first);
+		writes++;
+	}
+
+	return writes;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef _LVM_CLOG_DISK_LOG_H
+#define _LVM_CLOG_DISK_LOG_H
+
+/*
+ * Block-wise writes of the in-memory copy of a disk log.
+ *
+ * Callers include libdevmapper.h (or device_mapper/all.h) for dm_bitset_t
+ * before this header.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+void disk_log_mark_dirty(dm_bitset_t dirty, size_t block_size, uint64_t offset);
+int disk_log_write_dirty(int fd, const void *buffer, size_t block_size,
+			 dm_bitset_t dirty);
+
+#endif /* _LVM_CLOG_DISK_LOG_H */
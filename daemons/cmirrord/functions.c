@@ -11,6 +11,7 @@
  */
 #include "logging.h"
 #include "functions.h"
+#include "disk_log.h"
 #include "base/memory/zalloc.h"
 
 #include <sys/sysmacros.h>
@@ -18,7 +19,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <signal.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
+#include <linux/fs.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -32,6 +35,7 @@
 #define MIRROR_MAGIC 0x4D695272
 #define MIRROR_DISK_VERSION 2
 #define LOG_OFFSET 2
+#define LOG_BITS_START 1024 /* byte offset of the bitmap on disk */
 
 #define RESYNC_HISTORY 50
 #define RESYNC_BUFLEN 270
@@ -90,6 +94,8 @@ struct log_c {
 	uint64_t disk_nr_regions;
 	size_t disk_size;       /* size of disk_buffer in bytes */
 	void *disk_buffer;      /* aligned memory for O_DIRECT */
+	size_t disk_block_size; /* unit of disk log writes */
+	dm_bitset_t disk_dirty; /* disk_buffer blocks not yet written */
 	int idx;
 	char resync_history[RESYNC_HISTORY][RESYNC_BUFLEN];
 };
@@ -113,36 +119,41 @@ static int log_test_bit(dm_bitset_t bs, int bit)
 	return dm_bit(bs, bit) ? 1 : 0;
 }
 
+/*
+ * Mark the disk log block holding the clean_bits bit as dirty: only
+ * dirty blocks are written on the next flush.
+ */
+static void log_mark_dirty(struct log_c *lc, dm_bitset_t bs, int bit)
+{
+	if (lc->disk_dirty && (bs == lc->clean_bits))
+		disk_log_mark_dirty(lc->disk_dirty, lc->disk_block_size,
+				    LOG_BITS_START + (bit >> BYTE_SHIFT));
+}
+
 static void log_set_bit(struct log_c *lc, dm_bitset_t bs, int bit)
 {
 	dm_bit_set(bs, bit);
+	log_mark_dirty(lc, bs, bit);
 	lc->touched = 1;
 }
 
 static void log_clear_bit(struct log_c *lc, dm_bitset_t bs, int bit)
 {
 	dm_bit_clear(bs, bit);
+	log_mark_dirty(lc, bs, bit);
 	lc->touched = 1;
 }
 
 static uint64_t find_next_zero_bit(dm_bitset_t bs, unsigned start)
 {
-	for (; dm_bit(bs, start); start++)
-		if (start >= *bs)
-			return (uint64_t)-1;
+	int bit = dm_bit_get_next_clear(bs, (int) start - 1);
 
-	return start;
+	return (bit < 0) ? (uint64_t)-1 : (uint64_t)bit;
 }
 
 static uint64_t count_bits32(dm_bitset_t bs)
 {
-	unsigned i, size = bs[0]/(unsigned)DM_BITS_PER_INT + 1;
-	unsigned count = 0;
-
-	for (i = 1; i <= size; i++)
-		count += hweight32(bs[i]);
-
-	return (uint64_t)count;
+	return (uint64_t)dm_bit_count(bs);
 }
 
 /*
@@ -192,10 +203,36 @@ static void header_from_disk(struct log_header *mem, struct log_header *disk)
 	memcpy(mem, disk, sizeof(struct log_header));
 }
 
+/*
+ * write_dirty_blocks
+ * @lc
+ *
+ * Write the dirty blocks of disk_buffer, coalescing contiguous blocks.
+ *
+ * Returns: 0 on success, -EIO on failure
+ */
+static int write_dirty_blocks(struct log_c *lc)
+{
+	int r;
+
+	r = disk_log_write_dirty(lc->disk_fd, lc->disk_buffer,
+				 lc->disk_block_size, lc->disk_dirty);
+	if (r < 0) {
+		LOG_ERROR("[%s] rw_log:  write failure: %s",
+			  SHORT_UUID(lc->uuid), strerror(-r));
+		return -EIO; /* Failed disk write */
+	}
+
+	return 0;
+}
+
 static int rw_log(struct log_c *lc, int do_write)
 {
 	int r;
 
+	if (do_write)
+		return write_dirty_blocks(lc);
+
 	r = (int)lseek(lc->disk_fd, 0, SEEK_SET);
 	if (r < 0) {
 		LOG_ERROR("[%s] rw_log:  lseek failure: %s",
@@ -203,17 +240,6 @@ static int rw_log(struct log_c *lc, int do_write)
 		return -errno;
 	}
 
-	if (do_write) {
-		/* FIXME Cope with full set of non-error conditions */
-		r = write(lc->disk_fd, lc->disk_buffer, lc->disk_size);
-		if (r < 0) {
-			LOG_ERROR("[%s] rw_log:  write failure: %s",
-				  SHORT_UUID(lc->uuid), strerror(errno));
-			return -EIO; /* Failed disk write */
-		}
-		return 0;
-	}
-
 	/* Read */
 	/* FIXME Cope with full set of non-error conditions */
 	r = read(lc->disk_fd, lc->disk_buffer, lc->disk_size);
@@ -255,7 +281,8 @@ static int read_log(struct log_c *lc)
 	bitset_size += (lc->region_count % 8) ? 1 : 0;
 
 	/* 'lc->clean_bits + 1' becasue dm_bitset_t leads with a uint32_t */
-	memcpy(lc->clean_bits + 1, (char *)lc->disk_buffer + 1024, bitset_size);
+	memcpy(lc->clean_bits + 1, (char *)lc->disk_buffer + LOG_BITS_START,
+	       bitset_size);
 
 	return 0;
 }
@@ -282,7 +309,8 @@ static int write_log(struct log_c *lc)
 	bitset_size += (lc->region_count % 8) ? 1 : 0;
 
 	/* 'lc->clean_bits + 1' becasue dm_bitset_t leads with a uint32_t */
-	memcpy((char *)lc->disk_buffer + 1024, lc->clean_bits + 1, bitset_size);
+	memcpy((char *)lc->disk_buffer + LOG_BITS_START, lc->clean_bits + 1,
+	       bitset_size);
 
 	if (rw_log(lc, 1)) {
 		lc->log_dev_failed = 1;
@@ -381,7 +409,7 @@ static int _clog_ctr(char *uuid, uint64_t luid,
 	char disk_path[PATH_MAX] = { 0 };
 	int unlink_path = 0;
 	long page_size;
-	int pages;
+	int pages, block_size;
 
 	/* If core log request, then argv[0] will be region_size */
 	if (!strtoll(argv[0], &p, 0) || *p) {
@@ -514,6 +542,22 @@ static int _clog_ctr(char *uuid, uint64_t luid,
 		lc->disk_fd = r;
 		lc->disk_size = pages * page_size;
 
+		/* Track dirtiness per logical block of the log device */
+		if (ioctl(lc->disk_fd, BLKSSZGET, &block_size) ||
+		    (block_size < 512) || (block_size > page_size) ||
+		    (page_size % block_size))
+			block_size = (int) page_size;
+		lc->disk_block_size = (size_t) block_size;
+
+		lc->disk_dirty = dm_bitset_create(NULL, lc->disk_size /
+						  lc->disk_block_size);
+		if (!lc->disk_dirty) {
+			LOG_ERROR("Unable to allocate disk log dirty bitset");
+			r = -ENOMEM;
+			goto fail;
+		}
+		dm_bit_set_range(lc->disk_dirty, 0, *lc->disk_dirty);
+
 		r = posix_memalign(&(lc->disk_buffer), page_size,
 				   lc->disk_size);
 		if (r) {
@@ -533,6 +577,7 @@ fail:
 			LOG_ERROR("Close device error, %s: %s",
 				  disk_path, strerror(errno));
 		free(lc->disk_buffer);
+		free(lc->disk_dirty);
 		free(lc->sync_bits);
 		free(lc->clean_bits);
 		free(lc);
@@ -659,6 +704,7 @@ static int clog_dtr(struct dm_ulog_request *rq)
 		LOG_ERROR("Failed to close disk log: %s",
 			  strerror(errno));
 	free(lc->disk_buffer);
+	free(lc->disk_dirty);
 	free(lc->clean_bits);
 	free(lc->sync_bits);
 	free(lc);
@@ -828,6 +874,8 @@ no_disk:
 	dm_bit_copy(lc->sync_bits, lc->clean_bits);
 
 	if (commit_log && (lc->disk_fd >= 0)) {
+		/* Rewrite the whole log, including the header */
+		dm_bit_set_range(lc->disk_dirty, 0, *lc->disk_dirty);
 		rq->error = write_log(lc);
 		if (rq->error)
 			LOG_ERROR("Failed initial disk log write");
@@ -1880,6 +1928,8 @@ int pull_state(const char *uuid, uint64_t luid,
 	} else if (!strncmp(which, "clean_bits", 9)) {
 		lc->resume_override += 2;
 		memcpy(lc->clean_bits + 1, buf, bitset_size);
+		if (lc->disk_dirty)
+			dm_bit_set_range(lc->disk_dirty, 0, *lc->disk_dirty);
 
 		LOG_DBG("[%s] loading clean_bits:", SHORT_UUID(lc->uuid));
 
@@ -26,6 +26,7 @@
 #include <dlfcn.h>
 #include <pthread.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <sys/time.h>
@@ -142,6 +143,8 @@ static const char *decode_cmd(uint32_t cmd)
 	case DM_EVENT_CMD_DIE:				return "DIE";
 	case DM_EVENT_CMD_GET_STATUS:			return "GET_STATUS";
 	case DM_EVENT_CMD_GET_PARAMETERS:		return "GET_PARAMETERS";
+	case DM_EVENT_CMD_REGISTER_FOR_EVENTS:		return "REGISTER_FOR_EVENTS";
+	case DM_EVENT_CMD_UNREGISTER_FOR_EVENTS:	return "UNREGISTER_FOR_EVENTS";
 	default:					return "unknown";
 	}
 }
@@ -245,6 +248,7 @@ struct thread_status {
 	uint32_t timeout;
 	struct dm_list timeout_list;
 	void *dso_private; /* dso per-thread status variable */
+	unsigned status_slot;	/* Published status slot + 1, 0 for none */
 	/* TODO per-thread mutex */
 };
 
@@ -256,6 +260,11 @@ static DM_LIST_INIT(_timeout_registry);
 static pthread_mutex_t _timeout_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t _timeout_cond = PTHREAD_COND_INITIALIZER;
 
+/* Shared status file, slots are assigned with _global_mutex held. */
+static struct dm_event_status_header *_status_map;
+static size_t _status_map_size;
+static unsigned char _status_slot_used[DM_EVENT_STATUS_SLOTS];
+
 
 /**********
  *   DSO
@@ -745,6 +754,143 @@ static void _exit_dm_lib(void)
 	dm_lib_exit();
 }
 
+/*
+ * Create the file with status published for monitored devices.
+ * Readers fall back to querying the kernel when it is missing,
+ * so failure here only costs them that.
+ */
+static void _init_status_file(void)
+{
+	size_t size = sizeof(struct dm_event_status_header) +
+		DM_EVENT_STATUS_SLOTS * sizeof(struct dm_event_status_slot);
+	void *map;
+	int fd;
+
+	if (!dm_create_dir(DM_EVENT_STATUS_DIR))
+		return;
+
+	/* Fresh inode tells readers to drop mapping of previous instance. */
+	if (unlink(DM_EVENT_STATUS_FILE) && (errno != ENOENT))
+		log_sys_debug("unlink", DM_EVENT_STATUS_FILE);
+
+	if ((fd = open(DM_EVENT_STATUS_FILE, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0) {
+		log_sys_debug("open", DM_EVENT_STATUS_FILE);
+		return;
+	}
+
+	if (ftruncate(fd, size)) {
+		log_sys_debug("ftruncate", DM_EVENT_STATUS_FILE);
+		goto out;
+	}
+
+	if ((map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		log_sys_debug("mmap", DM_EVENT_STATUS_FILE);
+		goto out;
+	}
+
+	_status_map = map;
+	_status_map_size = size;
+	_status_map->slots = DM_EVENT_STATUS_SLOTS;
+	_status_map->slot_size = sizeof(struct dm_event_status_slot);
+	__atomic_store_n(&_status_map->magic, DM_EVENT_STATUS_MAGIC, __ATOMIC_RELEASE);
+out:
+	if (close(fd))
+		log_sys_debug("close", DM_EVENT_STATUS_FILE);
+
+	if (!_status_map && unlink(DM_EVENT_STATUS_FILE))
+		log_sys_debug("unlink", DM_EVENT_STATUS_FILE);
+}
+
+static void _exit_status_file(void)
+{
+	if (!_status_map)
+		return;
+
+	if (unlink(DM_EVENT_STATUS_FILE))
+		log_sys_debug("unlink", DM_EVENT_STATUS_FILE);
+
+	if (munmap(_status_map, _status_map_size))
+		log_sys_debug("munmap", DM_EVENT_STATUS_FILE);
+
+	_status_map = NULL;
+}
+
+static struct dm_event_status_slot *_status_slot(unsigned slot)
+{
+	return (struct dm_event_status_slot *)(_status_map + 1) + slot - 1;
+}
+
+/*
+ * Update slot contents.  Readers retry while the sequence
+ * number is odd or when it changed during their copy.
+ */
+static void _write_status_slot(struct dm_event_status_slot *slot, const char *uuid,
+			       const char *target_type, const char *params)
+{
+	uint32_t seq = slot->seq;
+
+	__atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	if (uuid)
+		(void) dm_strncpy(slot->uuid, uuid, sizeof(slot->uuid));
+
+	if (target_type && params &&
+	    dm_strncpy(slot->target_type, target_type, sizeof(slot->target_type)) &&
+	    dm_strncpy(slot->params, params, sizeof(slot->params)))
+		slot->updated = (uint64_t) time(NULL);
+	else
+		slot->updated = 0;
+
+	__atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/* Mutex must be held when calling this. */
+static void _get_status_slot(struct thread_status *thread)
+{
+	unsigned i;
+
+	if (!_status_map || thread->status_slot)
+		return;
+
+	for (i = 0; i < DM_EVENT_STATUS_SLOTS; ++i)
+		if (!_status_slot_used[i]) {
+			_status_slot_used[i] = 1;
+			thread->status_slot = i + 1;
+			_write_status_slot(_status_slot(thread->status_slot),
+					   thread->device.uuid, NULL, NULL);
+			return;
+		}
+
+	DEBUGLOG("No free status slot for %s.", thread->device.name);
+}
+
+/* Mutex must be held when calling this. */
+static void _put_status_slot(struct thread_status *thread)
+{
+	if (!_status_map || !thread->status_slot)
+		return;
+
+	_write_status_slot(_status_slot(thread->status_slot), "", NULL, NULL);
+	_status_slot_used[thread->status_slot - 1] = 0;
+	thread->status_slot = 0;
+}
+
+/* Publish status of single target device, only monitoring thread writes its slot. */
+static void _publish_status(struct thread_status *thread, struct dm_task *task)
+{
+	uint64_t start, length;
+	char *target_type = NULL, *params = NULL;
+
+	if (!_status_map || !thread->status_slot)
+		return;
+
+	if (dm_get_next_target(task, NULL, &start, &length, &target_type, &params))
+		target_type = NULL; /* Multiple targets are not published */
+
+	_write_status_slot(_status_slot(thread->status_slot), NULL, target_type, params);
+}
+
 static void _exit_timeout(void *unused __attribute__((unused)))
 {
 	_timeout_running = 0;
@@ -954,6 +1100,7 @@ static void _do_process_event(struct thread_status *thread)
 	if (!task)
 		log_error("Lost event in Thr %x.", (int)thread->thread);
 	else {
+		_publish_status(thread, task);
 		thread->dso_data->process_event(task, thread->current_events, &(thread->dso_private));
 		if (task != thread->wait_task)
 			dm_task_destroy(task);
@@ -981,6 +1128,7 @@ static void _monitor_unregister(void *arg)
 	thread->events = 0;	/* Filter is now empty */
 	thread->pending = 0;	/* Event pending resolved */
 	thread->processing = 1;	/* Process unregistering */
+	_put_status_slot(thread);
 
 	_unlock_mutex();
 
@@ -1024,6 +1172,7 @@ static void *_monitor_thread(void *arg)
 	_lock_mutex();
 	thread->status = DM_THREAD_RUNNING;
 	thread->processing = 0;
+	_get_status_slot(thread);
 
 	/* Loop awaiting/analyzing device events. */
 	while (thread->events) {
@@ -1617,6 +1766,84 @@ static int _handle_request(struct dm_event_daemon_message *msg,
 	}
 }
 
+/*
+ * (Un)register a list of devices with one request.
+ *
+ * Each line of the message is one entry formatted like the message of
+ * a single (un)register request, with the message id only in front of
+ * the first line.  The reply holds the result of each entry in order
+ * after the message id.  Returns the first failing result.
+ */
+static int _handle_bulk_request(struct dm_event_daemon_message *msg,
+				struct message_data *message_data)
+{
+	struct dm_event_daemon_message entry_msg;
+	struct message_data entry;
+	char *data = msg->data, *p = data, *line, *next;
+	char *reply = NULL;
+	size_t reply_size, len;
+	unsigned count = 1;
+	int ret = 0, r, size;
+
+	msg->data = NULL;
+
+	if (!data || !_fetch_string(&message_data->id, &p, ' ') ||
+	    !message_data->id) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	for (line = p; (line = strchr(line, '\n')); line++)
+		count++;
+
+	/* Each result is at most ' ' + "-2147483648" */
+	reply_size = strlen(message_data->id) + count * 12 + 1;
+	if (!(reply = malloc(reply_size))) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	len = dm_snprintf(reply, reply_size, "%s", message_data->id);
+
+	for (line = p; line && *line; line = next) {
+		if ((next = strchr(line, '\n')))
+			*next++ = '\0';
+
+		memset(&entry, 0, sizeof(entry));
+		entry_msg.cmd = msg->cmd;
+		entry_msg.data = NULL;
+		entry.msg = &entry_msg;
+
+		if ((size = dm_asprintf(&entry_msg.data, "%s %s",
+					message_data->id, line)) < 0)
+			r = -ENOMEM;
+		else {
+			entry_msg.size = size;
+			if (!_parse_message(&entry))
+				r = -EINVAL;
+			else if (msg->cmd == DM_EVENT_CMD_REGISTER_FOR_EVENTS)
+				r = entry.events_field ? _register_for_event(&entry) : -EINVAL;
+			else
+				r = _unregister_for_event(&entry);
+		}
+
+		_free_message(&entry);
+
+		if (r && !ret)
+			ret = r;
+
+		len += dm_snprintf(reply + len, reply_size - len, " %d", r);
+	}
+
+	msg->data = reply;
+	msg->size = len;
+	reply = NULL;
+out:
+	free(data);
+	free(reply);
+
+	return ret;
+}
+
 /* Process a request passed from the communication thread. */
 static int _do_process_request(struct dm_event_daemon_message *msg)
 {
@@ -1634,7 +1861,10 @@ static int _do_process_request(struct dm_event_daemon_message *msg)
 						DM_EVENT_PROTOCOL_VERSION);
 			free(answer);
 		}
-	} else if (msg->cmd != DM_EVENT_CMD_ACTIVE && !_parse_message(&message_data)) {
+	} else if (msg->cmd == DM_EVENT_CMD_REGISTER_FOR_EVENTS ||
+		   msg->cmd == DM_EVENT_CMD_UNREGISTER_FOR_EVENTS)
+		ret = _handle_bulk_request(msg, &message_data);
+	else if (msg->cmd != DM_EVENT_CMD_ACTIVE && !_parse_message(&message_data)) {
 		stack;
 		ret = -EINVAL;
 	} else
@@ -2253,6 +2483,8 @@ int main(int argc, char *argv[])
 	if (!_systemd_activation && !_open_fifos(&fifos))
 		exit(EXIT_FIFO_FAILURE);
 
+	_init_status_file();
+
 	/* Signal parent, letting them know we are ready to go. */
 	if (!_foreground)
 		kill(getppid(), SIGTERM);
@@ -2302,6 +2534,8 @@ int main(int argc, char *argv[])
 
 	log_notice("dmeventd shutting down.");
 
+	_exit_status_file();
+
 	if (fifos.client >= 0 && close(fifos.client))
 		log_sys_error("client close", fifos.client_path);
 	if (fifos.server >= 0 && close(fifos.server))
@@ -22,6 +22,34 @@
 
 #define DM_EVENT_DEFAULT_TIMEOUT 10
 
+/*
+ * Last status of monitored devices is published by the daemon
+ * in a file readable by root only, which readers map read-only.
+ * Each device owns one slot, its sequence counter is odd while
+ * the daemon updates the slot.
+ */
+#define DM_EVENT_STATUS_DIR	DEFAULT_DM_RUN_DIR "/dmeventd"
+#define DM_EVENT_STATUS_FILE	DM_EVENT_STATUS_DIR "/status"
+#define DM_EVENT_STATUS_MAGIC	0x444d5331	/* "DMS1" */
+#define DM_EVENT_STATUS_SLOTS	1024
+#define DM_EVENT_STATUS_PARAMS	512
+
+struct dm_event_status_header {
+	uint32_t magic;
+	uint32_t slots;
+	uint32_t slot_size;
+	uint32_t padding;
+};
+
+struct dm_event_status_slot {
+	uint32_t seq;
+	uint32_t padding;
+	uint64_t updated;	/* time() of the status, 0 when invalid */
+	char uuid[129];		/* DM_UUID_LEN */
+	char target_type[16];	/* DM_MAX_TYPE_NAME */
+	char params[DM_EVENT_STATUS_PARAMS];
+};
+
 /* Commands for the daemon passed in the message below. */
 enum dm_event_command {
 	DM_EVENT_CMD_ACTIVE = 1,
@@ -35,6 +63,8 @@ enum dm_event_command {
 	DM_EVENT_CMD_DIE,
 	DM_EVENT_CMD_GET_STATUS,
 	DM_EVENT_CMD_GET_PARAMETERS,
+	DM_EVENT_CMD_REGISTER_FOR_EVENTS,	/* protocol version 3 */
+	DM_EVENT_CMD_UNREGISTER_FOR_EVENTS,	/* protocol version 3 */
 };
 
 /* Message passed between client and daemon. */
@@ -21,6 +21,7 @@
 
 #include <fcntl.h>
 #include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
@@ -349,31 +350,13 @@ static int _daemon_write(struct dm_event_fifos *fifos,
 	return bytes == size;
 }
 
-int daemon_talk(struct dm_event_fifos *fifos,
-		struct dm_event_daemon_message *msg, int cmd,
-		const char *dso_name, const char *dev_name,
-		enum dm_event_mask evmask, uint32_t timeout)
+/*
+ * Send msg with its data already filled in and read the reply into it.
+ * Frees the sent data.
+ */
+static int _daemon_exchange(struct dm_event_fifos *fifos,
+			    struct dm_event_daemon_message *msg)
 {
-	int msg_size;
-	memset(msg, 0, sizeof(*msg));
-
-	/*
-	 * Set command and pack the arguments
-	 * into ASCII message string.
-	 */
-	if ((msg_size =
-	     ((cmd == DM_EVENT_CMD_HELLO) ?
-	      dm_asprintf(&(msg->data), "%d:%d HELLO", getpid(), _sequence_nr) :
-	      dm_asprintf(&(msg->data), "%d:%d %s %s %u %" PRIu32,
-			  getpid(), _sequence_nr,
-			  dso_name ? : "-", dev_name ? : "-", evmask, timeout)))
-	    < 0) {
-		log_error("_daemon_talk: message allocation failed.");
-		return -ENOMEM;
-	}
-	msg->cmd = cmd;
-	msg->size = msg_size;
-
 	/*
 	 * Write command and message to and
 	 * read status return code from daemon.
@@ -400,6 +383,34 @@ int daemon_talk(struct dm_event_fifos *fifos,
 	return (int32_t) msg->cmd;
 }
 
+int daemon_talk(struct dm_event_fifos *fifos,
+		struct dm_event_daemon_message *msg, int cmd,
+		const char *dso_name, const char *dev_name,
+		enum dm_event_mask evmask, uint32_t timeout)
+{
+	int msg_size;
+	memset(msg, 0, sizeof(*msg));
+
+	/*
+	 * Set command and pack the arguments
+	 * into ASCII message string.
+	 */
+	if ((msg_size =
+	     ((cmd == DM_EVENT_CMD_HELLO) ?
+	      dm_asprintf(&(msg->data), "%d:%d HELLO", getpid(), _sequence_nr) :
+	      dm_asprintf(&(msg->data), "%d:%d %s %s %u %" PRIu32,
+			  getpid(), _sequence_nr,
+			  dso_name ? : "-", dev_name ? : "-", evmask, timeout)))
+	    < 0) {
+		log_error("_daemon_talk: message allocation failed.");
+		return -ENOMEM;
+	}
+	msg->cmd = cmd;
+	msg->size = msg_size;
+
+	return _daemon_exchange(fifos, msg);
+}
+
 /*
  * start_daemon
  *
@@ -704,6 +715,306 @@ int dm_event_unregister_handler(const struct dm_event_handler *dmevh)
 	return ret;
 }
 
+/*
+ * Entries sent with one bulk request.  dmeventd replies only after it
+ * has (un)registered all of them, while _daemon_read() gives up after
+ * 5 seconds without input, so keep the work behind one reply small.
+ */
+#define BULK_ENTRIES_MAX 16
+
+/*
+ * Send one bulk request for handlers [first, first + count) with
+ * resolved devices in dmts.  Entries without a device are not sent.
+ */
+static int _do_events_bulk(struct dm_event_fifos *fifos, int cmd,
+			   const struct dm_event_handler **dmevhs,
+			   struct dm_task **dmts, unsigned first,
+			   unsigned count, int *results)
+{
+	struct dm_event_daemon_message msg = { 0 };
+	char *data = NULL, *p, *end;
+	size_t size = 64, len;
+	unsigned i, sent = 0;
+	long err;
+	int r = 1;
+
+	for (i = first; i < first + count; ++i)
+		if (dmts[i])
+			size += strlen(dmevhs[i]->dso) + strlen(dm_task_get_uuid(dmts[i])) + 32;
+
+	if (!(data = malloc(size))) {
+		log_error("Failed to allocate bulk event message.");
+		return 0;
+	}
+
+	len = dm_snprintf(data, size, "%d:%d", getpid(), _sequence_nr);
+
+	for (i = first; i < first + count; ++i) {
+		if (!dmts[i])
+			continue;
+		len += dm_snprintf(data + len, size - len, "%s%s %s %u %" PRIu32,
+				   sent++ ? "\n" : " ", dmevhs[i]->dso,
+				   dm_task_get_uuid(dmts[i]), dmevhs[i]->mask,
+				   dmevhs[i]->timeout);
+	}
+
+	if (!sent) {
+		free(data);
+		return 1;
+	}
+
+	msg.cmd = cmd;
+	msg.data = data;
+	msg.size = len;
+
+	if ((err = _daemon_exchange(fifos, &msg)) == -EIO) {
+		log_error("Event %sregistration of %u devices failed.",
+			  (cmd == DM_EVENT_CMD_REGISTER_FOR_EVENTS) ? "" : "de", sent);
+		return 0;
+	}
+
+	/* Skip message id, then one result per sent entry */
+	p = msg.data ? strchr(msg.data, ' ') : NULL;
+
+	for (i = first; i < first + count; ++i) {
+		if (!dmts[i])
+			continue;
+
+		if (p)
+			err = strtol(p, &end, 10);
+
+		if (!p || (end == p)) {
+			log_error("%s: event %sregistration failed: malformed reply.",
+				  dm_task_get_name(dmts[i]),
+				  (cmd == DM_EVENT_CMD_REGISTER_FOR_EVENTS) ? "" : "de");
+			r = 0;
+			continue;
+		}
+		p = end;
+
+		if (err) {
+			log_error("%s: event %sregistration failed: %s.",
+				  dm_task_get_name(dmts[i]),
+				  (cmd == DM_EVENT_CMD_REGISTER_FOR_EVENTS) ? "" : "de",
+				  strerror((int) ((err < 0) ? -err : err)));
+			r = 0;
+		} else if (results)
+			results[i] = 1;
+	}
+
+	free(msg.data);
+
+	return r;
+}
+
+static int _do_events(int cmd, const struct dm_event_handler **dmevhs,
+		      unsigned count, int *results)
+{
+	struct dm_event_fifos fifos = {
+		.client = -1,
+		.server = -1,
+		/* FIXME Make these either configurable or depend directly on dmeventd_path */
+		.client_path = DM_EVENT_FIFO_CLIENT,
+		.server_path = DM_EVENT_FIFO_SERVER
+	};
+	struct dm_task **dmts;
+	unsigned i;
+	int version = 0;
+	int r = 1;
+
+	if (results)
+		memset(results, 0, count * sizeof(*results));
+
+	if (!count)
+		return 1;
+
+	if (!(dmts = zalloc(count * sizeof(*dmts)))) {
+		log_error("Failed to allocate event handler list.");
+		return 0;
+	}
+
+	for (i = 0; i < count; ++i)
+		if (!(dmts[i] = _get_device_info(dmevhs[i])))
+			r = 0;
+
+	if (!_init_client(dmevhs[0]->dmeventd_path, &fifos) ||
+	    !dm_event_get_version(&fifos, &version)) {
+		log_error("Failed to communicate with dmeventd.");
+		r = 0;
+		goto out;
+	}
+
+	if (version < 3) {
+		/* Older dmeventd, one request per handler */
+		fini_fifos(&fifos);
+		fifos.client = fifos.server = -1;
+		for (i = 0; i < count; ++i) {
+			if (!dmts[i])
+				continue;
+			if (((cmd == DM_EVENT_CMD_REGISTER_FOR_EVENTS) ?
+			     dm_event_register_handler(dmevhs[i]) :
+			     dm_event_unregister_handler(dmevhs[i]))) {
+				if (results)
+					results[i] = 1;
+			} else
+				r = 0;
+		}
+		goto out;
+	}
+
+	for (i = 0; i < count; i += BULK_ENTRIES_MAX)
+		if (!_do_events_bulk(&fifos, cmd, dmevhs, dmts, i,
+				     (count - i > BULK_ENTRIES_MAX) ? BULK_ENTRIES_MAX : count - i,
+				     results))
+			r = 0;
+out:
+	fini_fifos(&fifos);
+
+	for (i = 0; i < count; ++i)
+		if (dmts[i])
+			dm_task_destroy(dmts[i]);
+	free(dmts);
+
+	return r;
+}
+
+int dm_event_register_handlers(const struct dm_event_handler **dmevhs,
+			       unsigned count, int *results)
+{
+	return _do_events(DM_EVENT_CMD_REGISTER_FOR_EVENTS, dmevhs, count, results);
+}
+
+int dm_event_unregister_handlers(const struct dm_event_handler **dmevhs,
+				 unsigned count, int *results)
+{
+	return _do_events(DM_EVENT_CMD_UNREGISTER_FOR_EVENTS, dmevhs, count, results);
+}
+
+/* Mapping of the status file published by dmeventd. */
+static const struct dm_event_status_header *_status_map;
+static size_t _status_map_size;
+static dev_t _status_dev;
+static ino_t _status_ino;
+
+static void _unmap_status_file(void)
+{
+	if (_status_map && munmap((void *) _status_map, _status_map_size))
+		log_sys_debug("munmap", DM_EVENT_STATUS_FILE);
+
+	_status_map = NULL;
+}
+
+/* (Re)map the status file when dmeventd (re)created it. */
+static int _map_status_file(void)
+{
+	const struct dm_event_status_header *hdr;
+	struct stat info;
+	void *map;
+	int fd;
+
+	if (stat(DM_EVENT_STATUS_FILE, &info)) {
+		_unmap_status_file();
+		return 0;
+	}
+
+	if (_status_map && (info.st_dev == _status_dev) && (info.st_ino == _status_ino))
+		return 1;
+
+	_unmap_status_file();
+
+	if ((info.st_size < (off_t) sizeof(*hdr)) ||
+	    ((fd = open(DM_EVENT_STATUS_FILE, O_RDONLY)) < 0))
+		return 0;
+
+	map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+	if (close(fd))
+		log_sys_debug("close", DM_EVENT_STATUS_FILE);
+
+	if (map == MAP_FAILED) {
+		log_sys_debug("mmap", DM_EVENT_STATUS_FILE);
+		return 0;
+	}
+
+	hdr = map;
+	if ((__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != DM_EVENT_STATUS_MAGIC) ||
+	    (hdr->slot_size != sizeof(struct dm_event_status_slot)) ||
+	    ((uint64_t) info.st_size < sizeof(*hdr) + (uint64_t) hdr->slots * hdr->slot_size)) {
+		log_debug("Ignoring incompatible %s.", DM_EVENT_STATUS_FILE);
+		if (munmap(map, info.st_size))
+			log_sys_debug("munmap", DM_EVENT_STATUS_FILE);
+		return 0;
+	}
+
+	_status_map = hdr;
+	_status_map_size = info.st_size;
+	_status_dev = info.st_dev;
+	_status_ino = info.st_ino;
+
+	return 1;
+}
+
+int dm_event_get_published_status(const char *uuid,
+				  char *target_type, size_t target_type_size,
+				  char *params, size_t params_size,
+				  time_t *updated)
+{
+	const struct dm_event_status_slot *slot;
+	struct dm_event_status_slot copy;
+	uint32_t seq;
+	unsigned i, retries;
+
+	if (!_map_status_file())
+		return 0;
+
+	slot = (const struct dm_event_status_slot *)(_status_map + 1);
+	for (i = 0; i < _status_map->slots; ++i, ++slot) {
+		/*
+		 * Skip a slot whose uuid differs while it is not being
+		 * updated, and copy only a slot that may match.
+		 */
+		seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+		if (!(seq & 1) && strncmp(slot->uuid, uuid, sizeof(slot->uuid))) {
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+				continue;
+		}
+
+		/* Bounded retries, the daemon may be updating the slot */
+		for (retries = 0; retries < 100; ++retries) {
+			if ((seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE)) & 1)
+				continue;
+			memcpy(&copy, slot, sizeof(copy));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq)
+				break;
+		}
+
+		if (retries == 100)
+			continue;
+
+		copy.uuid[sizeof(copy.uuid) - 1] = 0;
+		if (strcmp(copy.uuid, uuid))
+			continue;
+
+		if (!copy.updated)
+			return 0;
+
+		copy.target_type[sizeof(copy.target_type) - 1] = 0;
+		copy.params[sizeof(copy.params) - 1] = 0;
+
+		if (!dm_strncpy(target_type, copy.target_type, target_type_size) ||
+		    !dm_strncpy(params, copy.params, params_size))
+			return 0;
+
+		*updated = (time_t) copy.updated;
+
+		return 1;
+	}
+
+	return 0;
+}
+
 /* Fetch a string off src and duplicate it into *dest. */
 /* FIXME: move to separate module to share with the daemon. */
 static char *_fetch_string(char **src, const int delimiter)
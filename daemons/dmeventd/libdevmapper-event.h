@@ -23,6 +23,8 @@
 
 #include <stdarg.h>
 #include <stdint.h>
+#include <stddef.h>
+#include <time.h>
 
 /*
  * Event library interface.
@@ -47,7 +49,7 @@ enum dm_event_mask {
 };
 
 #define DM_EVENT_ALL_ERRORS DM_EVENT_ERROR_MASK
-#define DM_EVENT_PROTOCOL_VERSION 2
+#define DM_EVENT_PROTOCOL_VERSION 3
 
 struct dm_task;
 struct dm_event_handler;
@@ -106,6 +108,30 @@ int dm_event_get_registered_device(struct dm_event_handler *dmevh, int next);
 int dm_event_register_handler(const struct dm_event_handler *dmevh);
 int dm_event_unregister_handler(const struct dm_event_handler *dmevh);
 
+/*
+ * (Un)register a list of handlers with as few requests to dmeventd
+ * as possible.  All handlers must use the same dmeventd path.
+ * If results is not NULL, results[i] is set to 1 if the handler
+ * at dmevhs[i] succeeded and to 0 otherwise.
+ * Returns 1 if all handlers succeeded.
+ */
+int dm_event_register_handlers(const struct dm_event_handler **dmevhs,
+			       unsigned count, int *results);
+int dm_event_unregister_handlers(const struct dm_event_handler **dmevhs,
+				 unsigned count, int *results);
+
+/*
+ * Read status of a monitored device with given uuid as last
+ * published by dmeventd, without any ioctl.  Only devices with
+ * a single target are published.  *updated is set to the time
+ * the status was taken.
+ * Returns 1 if the status was found and fits into given buffers.
+ */
+int dm_event_get_published_status(const char *uuid,
+				  char *target_type, size_t target_type_size,
+				  char *params, size_t params_size,
+				  time_t *updated);
+
 /* Set debug level for logging, and whether to log on stdout/stderr or syslog */
 void dm_event_log_set(int debug_log_level, int use_syslog);
 
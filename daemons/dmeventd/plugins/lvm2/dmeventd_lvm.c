@@ -13,11 +13,13 @@
  */
 
 #include "lib/misc/lib.h"
+#include "lib/misc/lvm-string.h"
 #include "dmeventd_lvm.h"
 #include "daemons/dmeventd/libdevmapper-event.h"
 #include "tools/lvm2cmd.h"
 
 #include <pthread.h>
+#include <time.h>
 
 /*
  * register_device() is called first and performs initialisation.
@@ -62,6 +64,175 @@ void dmeventd_lvm2_unlock(void)
 	pthread_mutex_unlock(&_event_mutex);
 }
 
+/*
+ * Queue of commands waiting for the single liblvm2cmd instance.
+ *
+ * A command identical to one still waiting in the queue is not run
+ * twice, its caller takes the result of the queued one.  Commands are
+ * run in arrival order, except that waiting commands for the VG of the
+ * previous command go first, so bursts of events for one VG (e.g. many
+ * thin pools crossing their threshold together) run back to back while
+ * that VG's metadata and devices are hot in the cache.
+ *
+ * There is no dedicated worker thread: the thread whose command is
+ * queued runs queued commands until its own one is done, then leaves
+ * the queue to the next waiting thread.
+ */
+struct cmd_request {
+	struct dm_list list;
+	const char *cmdline;
+	const char *vgname;	/* vg/lv argument of cmdline */
+	size_t vgname_len;
+	uint64_t queued_us;
+	unsigned waiters;	/* merged identical requests */
+	int done;
+	int r;
+};
+
+static pthread_mutex_t _queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _queue_cond = PTHREAD_COND_INITIALIZER;
+static DM_LIST_INIT(_queue);
+static int _queue_running = 0;
+static char _queue_last_vgname[NAME_LEN];
+
+/* Event-to-completion latency of queued commands */
+static struct {
+	unsigned count;
+	unsigned merged;
+	uint64_t total_us;
+	uint64_t max_us;
+} _queue_stats;
+
+static uint64_t _now_us(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts))
+		return 0;
+
+	return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* VG name is the part of the last argument before '/' */
+static void _request_set_vgname(struct cmd_request *req)
+{
+	const char *arg, *slash;
+
+	if (!(arg = strrchr(req->cmdline, ' ')))
+		arg = req->cmdline;
+	else
+		arg++;
+
+	req->vgname = arg;
+	req->vgname_len = (slash = strchr(arg, '/')) ? (size_t) (slash - arg) : strlen(arg);
+}
+
+static int _request_same_vg(const struct cmd_request *req,
+			    const char *vgname, size_t vgname_len)
+{
+	return ((req->vgname_len == vgname_len) &&
+		!strncmp(req->vgname, vgname, vgname_len));
+}
+
+static struct cmd_request *_queue_next(void)
+{
+	struct cmd_request *req;
+
+	dm_list_iterate_items(req, &_queue)
+		if (_request_same_vg(req, _queue_last_vgname, strlen(_queue_last_vgname)))
+			return req;
+
+	return dm_list_item(dm_list_first(&_queue), struct cmd_request);
+}
+
+static void _queue_run_one(struct cmd_request *req)
+{
+	uint64_t latency_us;
+	int r;
+
+	dm_list_del(&req->list);
+	if (req->vgname_len < sizeof(_queue_last_vgname))
+		(void) dm_strncpy(_queue_last_vgname, req->vgname, req->vgname_len + 1);
+	else
+		_queue_last_vgname[0] = '\0';
+	pthread_mutex_unlock(&_queue_mutex);
+
+	dmeventd_lvm2_lock();
+	r = dmeventd_lvm2_run(req->cmdline);
+	dmeventd_lvm2_unlock();
+
+	pthread_mutex_lock(&_queue_mutex);
+	req->r = r;
+	req->done = 1;
+
+	latency_us = _now_us() - req->queued_us;
+	_queue_stats.count++;
+	_queue_stats.total_us += latency_us;
+	if (latency_us > _queue_stats.max_us)
+		_queue_stats.max_us = latency_us;
+
+	log_debug("Command %s finished in " FMTu64 " ms after event%s.",
+		  req->cmdline, latency_us / 1000,
+		  req->waiters ? " (merged)" : "");
+
+	pthread_cond_broadcast(&_queue_cond);
+}
+
+int dmeventd_lvm2_run_queued(const char *cmdline)
+{
+	struct cmd_request *req, *queued = NULL;
+	struct cmd_request own = { .cmdline = cmdline };
+	int r;
+
+	pthread_mutex_lock(&_queue_mutex);
+
+	dm_list_iterate_items(req, &_queue)
+		if (!strcmp(req->cmdline, cmdline)) {
+			queued = req;
+			break;
+		}
+
+	if (queued) {
+		/* Same command is still waiting to run, take its result */
+		queued->waiters++;
+		_queue_stats.merged++;
+		while (!queued->done)
+			pthread_cond_wait(&_queue_cond, &_queue_mutex);
+		r = queued->r;
+		if (!--queued->waiters)
+			pthread_cond_broadcast(&_queue_cond);
+		pthread_mutex_unlock(&_queue_mutex);
+
+		return r;
+	}
+
+	req = &own;
+	req->queued_us = _now_us();
+	_request_set_vgname(req);
+	dm_list_add(&_queue, &req->list);
+
+	while (!req->done) {
+		if (_queue_running) {
+			pthread_cond_wait(&_queue_cond, &_queue_mutex);
+			continue;
+		}
+
+		_queue_running = 1;
+		while (!req->done)
+			_queue_run_one(_queue_next());
+		_queue_running = 0;
+		pthread_cond_broadcast(&_queue_cond);
+	}
+
+	/* Merged callers still reading the result */
+	while (req->waiters)
+		pthread_cond_wait(&_queue_cond, &_queue_mutex);
+
+	pthread_mutex_unlock(&_queue_mutex);
+
+	return req->r;
+}
+
 int dmeventd_lvm2_init(void)
 {
 	int r = 0;
@@ -104,6 +275,12 @@ void dmeventd_lvm2_exit(void)
 
 	if (!--_register_count) {
 		log_debug("lvm plugin shuting down.");
+		if (_queue_stats.count)
+			log_debug("lvm plugin ran %u commands (%u merged), "
+				  "latency average " FMTu64 " ms, max " FMTu64 " ms.",
+				  _queue_stats.count, _queue_stats.merged,
+				  _queue_stats.total_us / _queue_stats.count / 1000,
+				  _queue_stats.max_us / 1000);
 		lvm2_run(_lvm_handle, "_memlock_dec");
 		dm_pool_destroy(_mem_pool);
 		_mem_pool = NULL;
@@ -39,14 +39,13 @@ struct dm_pool *dmeventd_lvm2_pool(void);
 int dmeventd_lvm2_command(struct dm_pool *mem, char *buffer, size_t size,
 			  const char *cmd, const char *device);
 
-#define dmeventd_lvm2_run_with_lock(cmdline) \
-	({\
-		int rc;\
-		dmeventd_lvm2_lock();\
-		rc = dmeventd_lvm2_run(cmdline);\
-		dmeventd_lvm2_unlock();\
-		rc;\
-	})
+/*
+ * Run cmdline through the shared command queue.
+ * Identical commands that are waiting are run only once.
+ */
+int dmeventd_lvm2_run_queued(const char *cmdline);
+
+#define dmeventd_lvm2_run_with_lock(cmdline) dmeventd_lvm2_run_queued(cmdline)
 
 #define dmeventd_lvm2_init_with_pool(name, st) \
 	({\
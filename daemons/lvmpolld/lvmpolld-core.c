@@ -46,6 +46,11 @@ struct lvmpolld_state {
 
 	struct lvmpolld_store *id_to_pdlv_abort;
 	struct lvmpolld_store *id_to_pdlv_poll;
+
+	unsigned max_workers; /* 0 means no limit */
+	unsigned workers;
+	pthread_mutex_t queue_lock;
+	struct dm_list queue; /* polling operations waiting for a worker */
 };
 
 static pthread_key_t key;
@@ -65,7 +70,7 @@ static const char *_strerror_r(int errnum, struct lvmpolld_thread_data *data)
 static void _usage(const char *prog, FILE *file)
 {
 	fprintf(file, "Usage:\n"
-		"%s [-V] [-h] [-f] [-l {all|wire|debug}] [-s path] [-B path] [-p path] [-t secs]\n"
+		"%s [-V] [-h] [-f] [-l {all|wire|debug}] [-s path] [-B path] [-p path] [-t secs] [-w count]\n"
 		"%s --dump [-s path]\n"
 		"   -V|--version     Show version info\n"
 		"   -h|--help        Show this help information\n"
@@ -75,7 +80,8 @@ static void _usage(const char *prog, FILE *file)
 		"   -p|--pidfile     Set path to the pidfile\n"
 		"   -s|--socket      Set path to the communication socket\n"
 		"   -B|--binary      Path to lvm2 binary\n"
-		"   -t|--timeout     Time to wait in seconds before shutdown on idle (missing or 0 = inifinite)\n\n", prog, prog);
+		"   -t|--timeout     Time to wait in seconds before shutdown on idle (missing or 0 = inifinite)\n"
+		"   -w|--workers     Maximum number of concurrently running lvm2 commands (missing or 0 = unlimited)\n\n", prog, prog);
 }
 
 static int _init(struct daemon_state *s)
@@ -97,6 +103,13 @@ static int _init(struct daemon_state *s)
 		return 0;
 	}
 
+	if (pthread_mutex_init(&ls->queue_lock, NULL)) {
+		FATAL(ls, "%s: %s", PD_LOG_PREFIX, "Failed to initialize queue mutex");
+		return 0;
+	}
+
+	dm_list_init(&ls->queue);
+
 	ls->id_to_pdlv_poll = pdst_init("polling");
 	ls->id_to_pdlv_abort = pdst_init("abort");
 
@@ -146,6 +159,28 @@ static void _lvmpolld_global_unlock(struct lvmpolld_state *ls)
 	_lvmpolld_stores_unlock(ls);
 }
 
+/* Finish polling operations which did not get a worker yet */
+static void _drop_queued_pdlvs(struct lvmpolld_state *ls)
+{
+	struct lvmpolld_lv *pdlv, *tmp;
+	struct dm_list queued;
+
+	dm_list_init(&queued);
+
+	pthread_mutex_lock(&ls->queue_lock);
+	dm_list_splice(&queued, &ls->queue);
+	pthread_mutex_unlock(&ls->queue_lock);
+
+	dm_list_iterate_items_gen_safe(pdlv, tmp, &queued, queue_list) {
+		dm_list_del(&pdlv->queue_list);
+		pdst_lock(pdlv->pdst);
+		pdlv_set_error(pdlv, 1);
+		pdlv_set_polling_finished(pdlv, 1);
+		pdst_locked_dec(pdlv->pdst);
+		pdst_unlock(pdlv->pdst);
+	}
+}
+
 static int _fini(struct daemon_state *s)
 {
 	int done;
@@ -154,6 +189,10 @@ static int _fini(struct daemon_state *s)
 
 	DEBUGLOG(s, "fini");
 
+	DEBUGLOG(s, "dropping queued polling operations");
+
+	_drop_queued_pdlvs(ls);
+
 	DEBUGLOG(s, "sending cancel requests");
 
 	_lvmpolld_global_lock(ls);
@@ -185,6 +224,8 @@ static int _fini(struct daemon_state *s)
 
 	pthread_key_delete(key);
 
+	pthread_mutex_destroy(&ls->queue_lock);
+
 	return 1;
 }
 
@@ -370,14 +411,13 @@ static void debug_print(struct lvmpolld_state *ls, const char * const* ptr)
 	}
 }
 
-static void *fork_and_poll(void *args)
+static void fork_and_poll(struct lvmpolld_lv *pdlv)
 {
 	int outfd, errfd, state = 0;
 	struct lvmpolld_thread_data *data;
 	pid_t r;
 
 	int error = 1;
-	struct lvmpolld_lv *pdlv = (struct lvmpolld_lv *) args;
 	struct lvmpolld_state *ls = pdlv->ls;
 
 	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &state);
@@ -479,6 +519,36 @@ err:
 	 */
 	if (r)
 		while(waitpid(r, NULL, 0) < 0 && errno == EINTR);
+}
+
+/*
+ * Worker runs polling of its initial LV and then of any
+ * LVs queued while the limit of workers was reached.
+ */
+static void *poll_worker(void *args)
+{
+	struct lvmpolld_lv *pdlv = (struct lvmpolld_lv *) args;
+	struct lvmpolld_state *ls = pdlv->ls;
+
+	while (pdlv) {
+		fork_and_poll(pdlv);
+
+		pthread_mutex_lock(&ls->queue_lock);
+		if (dm_list_empty(&ls->queue)) {
+			pdlv = NULL;
+			ls->workers--;
+		} else {
+			pdlv = dm_list_struct_base(dm_list_first(&ls->queue),
+						   struct lvmpolld_lv, queue_list);
+			dm_list_del(&pdlv->queue_list);
+			pdlv->tid = pthread_self();
+		}
+		pthread_mutex_unlock(&ls->queue_lock);
+
+		if (pdlv)
+			DEBUGLOG(ls, "%s: %s %s", PD_LOG_PREFIX,
+				 "worker starts queued polling of LV", pdlv->lvname);
+	}
 
 	return NULL;
 }
@@ -600,7 +670,7 @@ static int spawn_detached_thread(struct lvmpolld_lv *pdlv)
 	if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0)
 		return 0;
 
-	r = pthread_create(&pdlv->tid, &attr, fork_and_poll, (void *)pdlv);
+	r = pthread_create(&pdlv->tid, &attr, poll_worker, (void *)pdlv);
 
 	if (pthread_attr_destroy(&attr) != 0)
 		return 0;
@@ -608,6 +678,30 @@ static int spawn_detached_thread(struct lvmpolld_lv *pdlv)
 	return !r;
 }
 
+/*
+ * Start polling in a new worker or queue it when the limit
+ * of workers is reached.  Abort operations are never queued
+ * as they may be needed to finish an already running one.
+ */
+static int schedule_pdlv(struct lvmpolld_state *ls, struct lvmpolld_lv *pdlv,
+			 unsigned abort_polling)
+{
+	int r = 1;
+
+	pthread_mutex_lock(&ls->queue_lock);
+
+	if (!abort_polling && ls->max_workers && ls->workers >= ls->max_workers) {
+		dm_list_add(&ls->queue, &pdlv->queue_list);
+		DEBUGLOG(ls, "%s: %s %s (%u %s)", PD_LOG_PREFIX, "queued polling of LV",
+			 pdlv->lvname, ls->workers, "workers running");
+	} else if ((r = spawn_detached_thread(pdlv)))
+		ls->workers++;
+
+	pthread_mutex_unlock(&ls->queue_lock);
+
+	return r;
+}
+
 static response poll_init(client_handle h, struct lvmpolld_state *ls, request req, enum poll_type type)
 {
 	char *id;
@@ -693,7 +787,7 @@ static response poll_init(client_handle h, struct lvmpolld_state *ls, request re
 			free(id);
 			return reply(LVMPD_RESP_FAILED, REASON_ENOMEM);
 		}
-		if (!spawn_detached_thread(pdlv)) {
+		if (!schedule_pdlv(ls, pdlv, abort_polling)) {
 			ERROR(ls, "%s: %s", PD_LOG_PREFIX, "failed to spawn detached monitoring thread");
 			pdst_locked_remove(pdst, id);
 			pdlv_destroy(pdlv);
@@ -906,6 +1000,7 @@ static struct option long_options[] = {
 	{"socket",	required_argument,	0,		's' },
 	{"timeout",	required_argument,	0,		't' },
 	{"version",	no_argument,		0,		'V' },
+	{"workers",	required_argument,	0,		'w' },
 	{0,		0,			0,		0 }
 };
 
@@ -930,7 +1025,7 @@ int main(int argc, char *argv[])
 		.socket_path = getenv("LVM_LVMPOLLD_SOCKET") ?: LVMPOLLD_SOCKET,
 	};
 
-	while ((opt = getopt_long(argc, argv, "fhVl:p:s:B:t:", long_options, &option_index)) != -1) {
+	while ((opt = getopt_long(argc, argv, "fhVl:p:s:B:t:w:", long_options, &option_index)) != -1) {
 		switch (opt) {
 		case 0 :
 			if (action < ACTION_MAX) {
@@ -980,6 +1075,13 @@ int main(int argc, char *argv[])
 				s.idle = ls.idle = &di;
 			server = 1;
 			break;
+		case 'w': /* --workers */
+			if (!process_timeout_arg(optarg, &ls.max_workers)) {
+				fprintf(stderr, "Invalid value of workers parameter.\n");
+				exit(EXIT_FAILURE);
+			}
+			server = 1;
+			break;
 		}
 	}
 
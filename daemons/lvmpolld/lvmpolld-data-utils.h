@@ -62,6 +62,9 @@ struct lvmpolld_lv {
 	pid_t cmd_pid;
 	pthread_t tid;
 
+	/* protected by lvmpolld_state queue lock */
+	struct dm_list queue_list; /* waiting for a free worker */
+
 	pthread_mutex_t lock;
 
 	/* block of shared variables protected by lock */
@@ -1363,6 +1363,17 @@ int dm_bit_get_next(dm_bitset_t bs, int last_bit);
 int dm_bit_get_last(dm_bitset_t bs);
 int dm_bit_get_prev(dm_bitset_t bs, int last_bit);
 
+/*
+ * Word-at-a-time helpers: out = in1 & ~in2, first/next clear bit (-1 if
+ * none), number of set bits, and setting or clearing len bits from start.
+ */
+void dm_bit_andnot(dm_bitset_t out, dm_bitset_t in1, dm_bitset_t in2);
+int dm_bit_get_first_clear(dm_bitset_t bs);
+int dm_bit_get_next_clear(dm_bitset_t bs, int last_bit);
+unsigned dm_bit_count(dm_bitset_t bs);
+void dm_bit_set_range(dm_bitset_t bs, unsigned start, unsigned len);
+void dm_bit_clear_range(dm_bitset_t bs, unsigned start, unsigned len);
+
 #define DM_BITS_PER_INT ((unsigned)sizeof(int) * CHAR_BIT)
 
 #define dm_bit(bs, i) \
@@ -70,6 +70,98 @@ void dm_bit_union(dm_bitset_t out, dm_bitset_t in1, dm_bitset_t in2)
 		out[i] = in1[i] | in2[i];
 }
 
+void dm_bit_andnot(dm_bitset_t out, dm_bitset_t in1, dm_bitset_t in2)
+{
+	int i;
+
+	for (i = (in1[0] / DM_BITS_PER_INT) + 1; i; i--)
+		out[i] = in1[i] & ~in2[i];
+}
+
+/*
+ * Mask of the valid bits in the last word of a bitset: set_all and
+ * on-disk copies may leave bits beyond bs[0] set in that word.
+ */
+static uint32_t _last_word_mask(dm_bitset_t bs)
+{
+	unsigned bits = bs[0] & (DM_BITS_PER_INT - 1);
+
+	return bits ? (UINT32_C(1) << bits) - 1 : 0;
+}
+
+static unsigned _popcount(uint32_t word)
+{
+#ifdef HAVE___BUILTIN_POPCOUNT
+	return (unsigned) __builtin_popcount(word);
+#else
+	return hweight32(word);
+#endif
+}
+
+unsigned dm_bit_count(dm_bitset_t bs)
+{
+	unsigned i, words = bs[0] / DM_BITS_PER_INT;
+	unsigned count = 0;
+
+	for (i = 1; i <= words; i++)
+		count += _popcount(bs[i]);
+
+	return count + _popcount(bs[words + 1] & _last_word_mask(bs));
+}
+
+/*
+ * Set or clear len bits starting at start: partial words at either end
+ * are masked, whole words in between are filled with memset().
+ */
+static void _bit_fill_range(dm_bitset_t bs, unsigned start, unsigned len,
+			    int set)
+{
+	unsigned first, last, end;
+	uint32_t mask;
+
+	if (start >= bs[0] || !len)
+		return;
+
+	end = (len > bs[0] - start) ? bs[0] : start + len;
+	first = start / DM_BITS_PER_INT;
+	last = (end - 1) / DM_BITS_PER_INT;
+
+	mask = ~UINT32_C(0) << (start & (DM_BITS_PER_INT - 1));
+	if (first == last) {
+		if (end & (DM_BITS_PER_INT - 1))
+			mask &= (UINT32_C(1) << (end & (DM_BITS_PER_INT - 1))) - 1;
+	} else {
+		if (set)
+			bs[first + 1] |= mask;
+		else
+			bs[first + 1] &= ~mask;
+
+		if (last > first + 1)
+			memset(bs + first + 2, set ? -1 : 0,
+			       (last - first - 1) * sizeof(*bs));
+
+		mask = (end & (DM_BITS_PER_INT - 1)) ?
+			(UINT32_C(1) << (end & (DM_BITS_PER_INT - 1))) - 1 :
+			~UINT32_C(0);
+		first = last;
+	}
+
+	if (set)
+		bs[first + 1] |= mask;
+	else
+		bs[first + 1] &= ~mask;
+}
+
+void dm_bit_set_range(dm_bitset_t bs, unsigned start, unsigned len)
+{
+	_bit_fill_range(bs, start, len, 1);
+}
+
+void dm_bit_clear_range(dm_bitset_t bs, unsigned start, unsigned len)
+{
+	_bit_fill_range(bs, start, len, 0);
+}
+
 static int _test_word(uint32_t test, int bit)
 {
 	uint32_t tb = test >> bit;
@@ -133,11 +225,40 @@ int dm_bit_get_prev(dm_bitset_t bs, int last_bit)
 	return -1;
 }
 
+int dm_bit_get_next_clear(dm_bitset_t bs, int last_bit)
+{
+	int bit, word;
+	uint32_t test;
+
+	last_bit++;		/* otherwise we'll return the same bit again */
+
+	while (last_bit < (int) bs[0]) {
+		word = last_bit >> INT_SHIFT;
+		test = ~bs[word + 1];
+		bit = last_bit & (DM_BITS_PER_INT - 1);
+
+		if ((bit = _test_word(test, bit)) >= 0) {
+			bit += word * DM_BITS_PER_INT;
+			return (bit < (int) bs[0]) ? bit : -1;
+		}
+
+		last_bit = last_bit - (last_bit & (DM_BITS_PER_INT - 1)) +
+		    DM_BITS_PER_INT;
+	}
+
+	return -1;
+}
+
 int dm_bit_get_first(dm_bitset_t bs)
 {
 	return dm_bit_get_next(bs, -1);
 }
 
+int dm_bit_get_first_clear(dm_bitset_t bs)
+{
+	return dm_bit_get_next_clear(bs, -1);
+}
+
 int dm_bit_get_last(dm_bitset_t bs)
 {
 	return dm_bit_get_prev(bs, bs[0] + 1);
@@ -401,6 +401,13 @@ int monitor_dev_for_events(struct cmd_context *cmd, const struct logical_volume
 {
 	return 1;
 }
+void monitor_batch_begin(struct cmd_context *cmd)
+{
+}
+int monitor_batch_end(struct cmd_context *cmd)
+{
+	return 1;
+}
 /* fs.c */
 void fs_unlock(void)
 {
@@ -1532,6 +1539,64 @@ int lv_is_active(const struct logical_volume *lv)
 }
 
 #ifdef DMEVENTD
+/*
+ * Registrations collected between monitor_batch_begin() and
+ * monitor_batch_end() and sent to dmeventd with one request.
+ * Unregistrations are never deferred as they must reach dmeventd before
+ * the device is suspended or removed, so collected registrations are
+ * sent ahead of them to keep the order.
+ */
+struct monitor_batch_item {
+	struct dm_list list;
+	struct dm_event_handler *dmevh;
+};
+
+static unsigned _monitor_batch_depth = 0;
+static DM_LIST_INIT(_monitor_batch);
+
+static int _monitor_batch_flush(void)
+{
+	struct monitor_batch_item *item, *tmp;
+	const struct dm_event_handler **dmevhs = NULL;
+	int *results = NULL;
+	unsigned i, count = dm_list_size(&_monitor_batch);
+	int r = 0;
+
+	if (!count)
+		return 1;
+
+	if (!(dmevhs = malloc(count * sizeof(*dmevhs))) ||
+	    !(results = malloc(count * sizeof(*results)))) {
+		log_error("Failed to allocate monitoring batch of %u devices.", count);
+		goto out;
+	}
+
+	i = 0;
+	dm_list_iterate_items(item, &_monitor_batch)
+		dmevhs[i++] = item->dmevh;
+
+	log_debug_activation("Monitoring %u devices with dmeventd.", count);
+
+	r = dm_event_register_handlers(dmevhs, count, results);
+
+	i = 0;
+	dm_list_iterate_items(item, &_monitor_batch)
+		if (results[i++])
+			log_verbose("Monitored %s for events",
+				    dm_event_handler_get_uuid(item->dmevh));
+out:
+	dm_list_iterate_items_safe(item, tmp, &_monitor_batch) {
+		dm_list_del(&item->list);
+		dm_event_handler_destroy(item->dmevh);
+		free(item);
+	}
+
+	free(dmevhs);
+	free(results);
+
+	return r;
+}
+
 static struct dm_event_handler *_create_dm_event_handler(struct cmd_context *cmd, const char *dmuuid, const char *dso,
 							 const int timeout, enum dm_event_mask mask)
 {
@@ -1687,6 +1752,7 @@ int target_register_events(struct cmd_context *cmd, const char *dso, const struc
 {
 	char *uuid;
 	struct dm_event_handler *dmevh;
+	struct monitor_batch_item *item;
 	int r;
 
 	if (!dso)
@@ -1700,6 +1766,22 @@ int target_register_events(struct cmd_context *cmd, const char *dso, const struc
 					       DM_EVENT_ALL_ERRORS | (timeout ? DM_EVENT_TIMEOUT : 0))))
 		return_0;
 
+	if (_monitor_batch_depth) {
+		if (set) {
+			if (!(item = zalloc(sizeof(*item)))) {
+				log_error("Failed to allocate monitoring batch item.");
+				dm_event_handler_destroy(dmevh);
+				return 0;
+			}
+			item->dmevh = dmevh;
+			dm_list_add(&_monitor_batch, &item->list);
+			return 1;
+		}
+
+		if (!_monitor_batch_flush())
+			stack;
+	}
+
 	r = set ? dm_event_register_handler(dmevh) : dm_event_unregister_handler(dmevh);
 
 	dm_event_handler_destroy(dmevh);
@@ -1931,6 +2013,18 @@ int monitor_dev_for_events(struct cmd_context *cmd, const struct logical_volume
 					 display_lvname(lv), lvseg_name(seg));
 				return 0;
 			}
+
+			if (_monitor_batch_depth) {
+				/* Registration is checked in monitor_batch_end() */
+				if (!lv_is_mirror(lv))
+					continue;
+
+				/* Mirror table is refreshed with registration done */
+				if (!_monitor_batch_flush()) {
+					stack;
+					r = 0;
+				}
+			}
 		} else
 			continue;
 
@@ -1976,6 +2070,35 @@ int monitor_dev_for_events(struct cmd_context *cmd, const struct logical_volume
 #endif
 }
 
+/*
+ * Collect dmeventd registrations done by monitor_dev_for_events() and
+ * send them with one request when the outermost batch ends.
+ * Returns 0 if any of the collected registrations failed.
+ */
+void monitor_batch_begin(struct cmd_context *cmd)
+{
+#ifdef DMEVENTD
+	_monitor_batch_depth++;
+#endif
+}
+
+int monitor_batch_end(struct cmd_context *cmd)
+{
+#ifdef DMEVENTD
+	if (!_monitor_batch_depth) {
+		log_error(INTERNAL_ERROR "Monitoring batch was not started.");
+		return 0;
+	}
+
+	if (--_monitor_batch_depth)
+		return 1;
+
+	if (!_monitor_batch_flush())
+		return_0;
+#endif
+	return 1;
+}
+
 struct detached_lv_data {
 	const struct logical_volume *lv_pre;
 	struct lv_activate_opts *laopts;
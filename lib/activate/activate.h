@@ -225,6 +225,8 @@ int lv_has_target_type(struct dm_pool *mem, const struct logical_volume *lv,
 
 int monitor_dev_for_events(struct cmd_context *cmd, const struct logical_volume *lv,
 			   const struct lv_activate_opts *laopts, int monitor);
+void monitor_batch_begin(struct cmd_context *cmd);
+int monitor_batch_end(struct cmd_context *cmd);
 
 #ifdef DMEVENTD
 #  include "daemons/dmeventd/libdevmapper-event.h"
@@ -1716,13 +1716,46 @@ out:
 	return r;
 }
 
+/*
+ * Thin pool status last published by dmeventd when it is
+ * not older than dmeventd/status_max_age seconds.
+ */
+static char *_published_thin_pool_params(struct dev_manager *dm,
+					 const struct logical_volume *lv,
+					 const char *dlid)
+{
+#ifdef DMEVENTD
+	char type[32];
+	char params[1024];
+	time_t updated, now;
+	int max_age = find_config_tree_int(dm->cmd, dmeventd_status_max_age_CFG, NULL);
+
+	if ((max_age <= 0) ||
+	    !dm_event_get_published_status(dlid, type, sizeof(type),
+					   params, sizeof(params), &updated) ||
+	    strcmp(type, TARGET_NAME_THIN_POOL))
+		return NULL;
+
+	now = time(NULL);
+	if ((updated > now) || (now - updated > max_age))
+		return NULL;
+
+	log_debug_activation("Using thin pool status for LV %s published by dmeventd %ld second(s) ago.",
+			     display_lvname(lv), (long) (now - updated));
+
+	return dm_pool_strdup(dm->mem, params);
+#else
+	return NULL;
+#endif
+}
+
 int dev_manager_thin_pool_status(struct dev_manager *dm,
 				 const struct logical_volume *lv, int flush,
 				 struct lv_status_thin_pool **status, int *exists)
 {
 	struct dm_status_thin_pool *dm_status;
 	const char *dlid;
-	struct dm_task *dmt;
+	struct dm_task *dmt = NULL;
 	struct dm_info info;
 	uint64_t start, length;
 	char *type = NULL;
@@ -1737,21 +1770,25 @@ int dev_manager_thin_pool_status(struct dev_manager *dm,
 	if (!(dlid = build_dm_uuid(dm->mem, lv, lv_layer(lv))))
 		return_0;
 
-	if (!(dmt = _setup_task_run(DM_DEVICE_STATUS, &info, NULL, dlid, 0, 0, 0, 0, flush, 0)))
-		return_0;
+	if (!flush && (params = _published_thin_pool_params(dm, lv, dlid)))
+		*exists = 1;
+	else {
+		if (!(dmt = _setup_task_run(DM_DEVICE_STATUS, &info, NULL, dlid, 0, 0, 0, 0, flush, 0)))
+			return_0;
 
-	if (!(*exists = info.exists))
-		goto out;
+		if (!(*exists = info.exists))
+			goto out;
 
-	log_debug_activation("Checking thin pool status for LV %s.",
-			     display_lvname(lv));
+		log_debug_activation("Checking thin pool status for LV %s.",
+				     display_lvname(lv));
 
-	dm_get_next_target(dmt, NULL, &start, &length, &type, &params);
+		dm_get_next_target(dmt, NULL, &start, &length, &type, &params);
 
-	if (!type || strcmp(type, TARGET_NAME_THIN_POOL)) {
-		log_error("Expected %s segment type but got %s instead.",
-			  TARGET_NAME_THIN_POOL, type ? type : "NULL");
-		goto out;
+		if (!type || strcmp(type, TARGET_NAME_THIN_POOL)) {
+			log_error("Expected %s segment type but got %s instead.",
+				  TARGET_NAME_THIN_POOL, type ? type : "NULL");
+			goto out;
+		}
 	}
 
 	if (!dm_get_status_thin_pool(dm->mem, params, &dm_status))
@@ -1772,7 +1809,8 @@ int dev_manager_thin_pool_status(struct dev_manager *dm,
 
 	r = 1;
 out:
-	dm_task_destroy(dmt);
+	if (dmt)
+		dm_task_destroy(dmt);
 
 	return r;
 }
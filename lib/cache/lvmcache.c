@@ -3101,6 +3101,24 @@ int lvmcache_vginfo_has_pvid(struct lvmcache_vginfo *vginfo, const char *pvid_ar
 	return 0;
 }
 
+/*
+ * Check if a device was scanned for each PV listed in the
+ * metadata summary of the VG.
+ */
+int lvmcache_vginfo_has_all_pvs(struct lvmcache_vginfo *vginfo)
+{
+	struct pv_list *pvl;
+
+	if (dm_list_empty(&vginfo->pvsummaries))
+		return 0;
+
+	dm_list_iterate_items(pvl, &vginfo->pvsummaries) {
+		if (!lvmcache_vginfo_has_pvid(vginfo, (const char *)&pvl->pv->id.uuid))
+			return 0;
+	}
+	return 1;
+}
+
 /*
  * This is used by the metadata repair command to check if
  * the metadata on a dev needs repair because it's old.
@@ -906,9 +906,11 @@ static int _load_config_file(struct cmd_context *cmd, const char *tag, int local
 	if (*tag) {
 		if (!_init_tags(cmd, cfl->cft))
 			return_0;
-	} else
+	} else {
 		/* Use temporary copy of lvm.conf while loading other files */
 		cmd->cft = cfl->cft;
+		config_tree_changed(cmd);
+	}
 
 	return 1;
 }
@@ -924,12 +926,16 @@ static int _init_lvm_conf(struct cmd_context *cmd)
 			log_error("Failed to create config tree");
 			return 0;
 		}
+		config_tree_changed(cmd);
 		return 1;
 	}
 
 	if (!_load_config_file(cmd, "", 0))
 		return_0;
 
+	/* Applies to lvmlocal.conf, tag config files and profiles read next. */
+	config_snapshots_enable(find_config_tree_bool(cmd, config_snapshots_CFG, NULL));
+
 	return 1;
 }
 
@@ -1068,6 +1074,32 @@ static void _destroy_config(struct cmd_context *cmd)
 			  "cmd config tree not destroyed fully");
 }
 
+/*
+ * Regex filters are matched against every name of a device, including
+ * symlinks such as /dev/disk/by-id/..., which are not collected when
+ * the device list is obtained from sysfs.  Any pattern other than
+ * accepting everything could refer to such a name.
+ */
+static int _regex_filter_set(struct cmd_context *cmd, int filter_cfg)
+{
+	const struct dm_config_node *cn;
+	const struct dm_config_value *cv;
+	const char *str;
+
+	if (!(cn = find_config_tree_node(cmd, filter_cfg, NULL)))
+		return 0;
+
+	for (cv = cn->v; cv; cv = cv->next) {
+		if (cv->type != DM_CFG_STRING || !(str = cv->v.str))
+			return 1;
+		if ((strlen(str) != 5) || (str[0] != 'a') ||
+		    strncmp(str + 2, ".*", 2) || (str[1] != str[4]))
+			return 1;
+	}
+
+	return 0;
+}
+
 static int _init_dev_cache(struct cmd_context *cmd)
 {
 	const struct dm_config_node *cn;
@@ -1075,6 +1107,7 @@ static int _init_dev_cache(struct cmd_context *cmd)
 	size_t len, udev_dir_len = strlen(DM_UDEV_DEV_DIR);
 	int len_diff;
 	int device_list_from_udev;
+	int device_list_from_sysfs;
 
 	if (!dev_cache_init(cmd))
 		return_0;
@@ -1086,6 +1119,15 @@ static int _init_dev_cache(struct cmd_context *cmd)
 
 	init_obtain_device_list_from_udev(device_list_from_udev);
 
+	if ((device_list_from_sysfs = find_config_tree_bool(cmd, devices_obtain_device_list_from_sysfs_CFG, NULL)) &&
+	    (_regex_filter_set(cmd, devices_global_filter_CFG) ||
+	     _regex_filter_set(cmd, devices_filter_CFG))) {
+		log_debug_devs("Not obtaining device list from sysfs with filter patterns set.");
+		device_list_from_sysfs = 0;
+	}
+
+	init_obtain_device_list_from_sysfs(device_list_from_sysfs);
+
 	if (!(cn = find_config_tree_array(cmd, devices_scan_CFG, NULL))) {
 		log_error(INTERNAL_ERROR "Unable to find configuration for devices/scan.");
 		return 0;
@@ -1616,6 +1658,7 @@ struct cmd_context *create_config_context(void)
 
 	if (!(cmd->cft = _merge_config_files(cmd, cmd->cft)))
 		goto_out;
+	config_tree_changed(cmd);
 
 	return cmd;
 out:
@@ -1763,6 +1806,7 @@ struct cmd_context *create_toolcontext(unsigned is_clvmd,
 
 	if (!(cmd->cft = _merge_config_files(cmd, cmd->cft)))
 		goto_out;
+	config_tree_changed(cmd);
 
 	if (!_process_config(cmd))
 		goto_out;
@@ -1933,8 +1977,10 @@ int refresh_toolcontext(struct cmd_context *cmd)
 
 	/* Temporary duplicate cft pointer holding lvm.conf - replaced later */
 	cft_tmp = cmd->cft;
-	if (cft_cmdline)
+	if (cft_cmdline) {
 		cmd->cft = dm_config_insert_cascaded_tree(cft_cmdline, cft_tmp);
+		config_tree_changed(cmd);
+	}
 
 	/* Reload the global profile. */
 	if (profile_command_name) {
@@ -1971,6 +2017,7 @@ int refresh_toolcontext(struct cmd_context *cmd)
 	/* Finally we can make the proper, fully-merged, cmd->cft */
 	if (cft_cmdline)
 		cmd->cft = dm_config_insert_cascaded_tree(cft_cmdline, cmd->cft);
+	config_tree_changed(cmd);
 
 	if (!_process_config(cmd))
 		return_0;
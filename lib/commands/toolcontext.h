@@ -185,6 +185,7 @@ struct cmd_context {
 	unsigned is_activating:1;
 	unsigned enable_hints:1;		/* hints are enabled for cmds in general */
 	unsigned use_hints:1;			/* if hints are enabled this cmd can use them */
+	unsigned use_devicesfile_vgs:1;		/* this cmd can scan only devices file entries for its VG */
 	unsigned pvscan_recreate_hints:1;	/* enable special case hint handling for pvscan --cache */
 	unsigned scan_lvs:1;
 	unsigned wipe_outdated_pvs:1;
@@ -227,6 +228,9 @@ struct cmd_context {
 	struct dm_list config_files; 		/* master lvm config + any existing tag configs */
 	struct profile_params *profile_params;	/* profile handling params including loaded profile configs */
 	struct dm_config_tree *cft;		/* the whole cascade: CONFIG_STRING -> CONFIG_PROFILE -> CONFIG_FILE/CONFIG_MERGED_FILES */
+	struct config_value *config_values;	/* resolved values of find_config_tree_* indexed by config id */
+	unsigned config_gen;			/* generation of cft cascade, config_values with other gen are stale */
+	unsigned config_gen_last;		/* last generation number used */
 	struct dm_hash_table *cft_def_hash;	/* config definition hash used for validity check (item type + item recognized) */
 	struct config_info default_settings;	/* selected settings with original default/configured value which can be changed during cmd processing */
 	struct config_info current_settings; 	/* may contain changed values compared to default_settings */
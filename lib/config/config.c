@@ -308,6 +308,16 @@ struct dm_config_tree *get_config_tree_by_source(struct cmd_context *cmd,
 	return NULL;
 }
 
+/*
+ * Config cascade in cmd->cft was modified so all resolved
+ * values in cmd->config_values are stale now.
+ * Generation numbers are never reused.
+ */
+void config_tree_changed(struct cmd_context *cmd)
+{
+	cmd->config_gen = ++cmd->config_gen_last;
+}
+
 /*
  * Returns config tree if it was removed.
  */
@@ -327,6 +337,7 @@ struct dm_config_tree *remove_config_tree_by_source(struct cmd_context *cmd,
 			} else
 				cmd->cft = cft->cascade;
 			cft->cascade = NULL;
+			config_tree_changed(cmd);
 			break;
 		}
 		previous_cft = cft;
@@ -404,6 +415,7 @@ int override_config_tree_from_string(struct cmd_context *cmd,
 	dm_config_set_custom(cft_new, cs);
 
 	cmd->cft = dm_config_insert_cascaded_tree(cft_new, cmd->cft);
+	config_tree_changed(cmd);
 
 	return 1;
 }
@@ -432,6 +444,7 @@ static int _override_config_tree_from_command_profile(struct cmd_context *cmd,
 		cmd->cft = profile->cft;
 
 	dm_config_insert_cascaded_tree(profile->cft, cft);
+	config_tree_changed(cmd);
 
 	return 1;
 }
@@ -466,6 +479,7 @@ static int _override_config_tree_from_metadata_profile(struct cmd_context *cmd,
 		cmd->cft = profile->cft;
 
 	dm_config_insert_cascaded_tree(profile->cft, cft);
+	config_tree_changed(cmd);
 
 	return 1;
 }
@@ -611,6 +625,7 @@ int config_file_read(struct dm_config_tree *cft)
 	struct config_source *cs = dm_config_get_custom(cft);
 	struct config_file *cf;
 	struct stat info;
+	int use_snapshot;
 	int r;
 
 	if (!config_file_check(cft, &filename, &info))
@@ -622,6 +637,13 @@ int config_file_read(struct dm_config_tree *cft)
 
 	cf = cs->source.file;
 
+	/* lvm.conf, tag configs and profiles, not metadata backups */
+	use_snapshot = ((cs->type == CONFIG_FILE) || _is_profile_based_config_source(cs->type)) &&
+		       !cf->keep_open && !cft->root && config_snapshots_enabled();
+
+	if (use_snapshot && config_snapshot_load(cft, filename, &info))
+		return 1;
+
 	if (!cf->dev) {
 		if (!(cf->dev = dev_create_file(filename, NULL, NULL, 1)))
 			return_0;
@@ -642,6 +664,11 @@ int config_file_read(struct dm_config_tree *cft)
 		cf->dev = NULL;
 	}
 
+	/* The file being read may itself disable snapshots. */
+	if (r && use_snapshot &&
+	    dm_config_find_bool(cft->root, "config/snapshots", DEFAULT_CONFIG_SNAPSHOTS))
+		config_snapshot_save(cft, filename, &info);
+
 	return r;
 }
 
@@ -1246,6 +1273,40 @@ static int _apply_local_profile(struct cmd_context *cmd, struct profile *profile
 	return override_config_tree_from_profile(cmd, profile);
 }
 
+/*
+ * Removing the local profile restores the previous cascade,
+ * so values resolved before it was applied are valid again.
+ */
+static void _remove_local_profile(struct cmd_context *cmd, struct profile *profile, unsigned gen)
+{
+	remove_config_tree_by_source(cmd, profile->source);
+	cmd->config_gen = gen;
+}
+
+/*
+ * Returns the slot for the resolved value of the config item or NULL
+ * if the value must not be cached.  Only values resolved from cmd->cft
+ * without any local profile applied and without run-time computed
+ * default are cached.
+ */
+static struct config_value *_config_value(struct cmd_context *cmd, cfg_def_item_t *item,
+					  struct profile *profile)
+{
+	if (!cmd->config_gen || (item->flags & CFG_DEFAULT_RUN_TIME))
+		return NULL;
+
+	/* Same condition as in _apply_local_profile. */
+	if (profile && !((profile->source == CONFIG_PROFILE_METADATA) &&
+			 cmd->profile_params->global_metadata_profile))
+		return NULL;
+
+	if (!cmd->config_values &&
+	    !(cmd->config_values = dm_pool_zalloc(cmd->libmem, CFG_COUNT * sizeof(*cmd->config_values))))
+		return NULL;
+
+	return &cmd->config_values[item->id];
+}
+
 static int _config_disabled(struct cmd_context *cmd, cfg_def_item_t *item, const char *path)
 {
 	if ((item->flags & CFG_DISABLED) && dm_config_tree_find_node(cmd->cft, path)) {
@@ -1273,6 +1334,7 @@ const struct dm_config_node *find_config_tree_node(struct cmd_context *cmd, int
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	const struct dm_config_node *cn;
 
@@ -1282,7 +1344,7 @@ const struct dm_config_node *find_config_tree_node(struct cmd_context *cmd, int
 	cn = dm_config_tree_find_node(cmd->cft, path);
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
 
 	return cn;
 }
@@ -1291,9 +1353,14 @@ const char *find_config_tree_str(struct cmd_context *cmd, int id, struct profile
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	struct config_value *cv;
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	const char *str;
 
+	if ((cv = _config_value(cmd, item, profile)) && (cv->gen == gen))
+		return cv->v.str;
+
 	profile_applied = _apply_local_profile(cmd, profile);
 	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
@@ -1304,7 +1371,11 @@ const char *find_config_tree_str(struct cmd_context *cmd, int id, struct profile
 						: dm_config_tree_find_str(cmd->cft, path, cfg_def_get_default_value(cmd, item, CFG_TYPE_STRING, profile));
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
+	else if (cv) {
+		cv->v.str = str;
+		cv->gen = gen;
+	}
 
 	return str;
 }
@@ -1313,6 +1384,7 @@ const char *find_config_tree_str_allow_empty(struct cmd_context *cmd, int id, st
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	const char *str;
 
@@ -1328,7 +1400,7 @@ const char *find_config_tree_str_allow_empty(struct cmd_context *cmd, int id, st
 						: dm_config_tree_find_str_allow_empty(cmd->cft, path, cfg_def_get_default_value(cmd, item, CFG_TYPE_STRING, profile));
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
 
 	return str;
 }
@@ -1337,9 +1409,14 @@ int find_config_tree_int(struct cmd_context *cmd, int id, struct profile *profil
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	struct config_value *cv;
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	int i;
 
+	if ((cv = _config_value(cmd, item, profile)) && (cv->gen == gen))
+		return (int) cv->v.i;
+
 	profile_applied = _apply_local_profile(cmd, profile);
 	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
@@ -1350,7 +1427,11 @@ int find_config_tree_int(struct cmd_context *cmd, int id, struct profile *profil
 					      : dm_config_tree_find_int(cmd->cft, path, cfg_def_get_default_value(cmd, item, CFG_TYPE_INT, profile));
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
+	else if (cv) {
+		cv->v.i = i;
+		cv->gen = gen;
+	}
 
 	return i;
 }
@@ -1359,9 +1440,14 @@ int64_t find_config_tree_int64(struct cmd_context *cmd, int id, struct profile *
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	struct config_value *cv;
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	int i64;
 
+	if ((cv = _config_value(cmd, item, profile)) && (cv->gen == gen))
+		return cv->v.i;
+
 	profile_applied = _apply_local_profile(cmd, profile);
 	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
@@ -1372,7 +1458,11 @@ int64_t find_config_tree_int64(struct cmd_context *cmd, int id, struct profile *
 						: dm_config_tree_find_int64(cmd->cft, path, cfg_def_get_default_value(cmd, item, CFG_TYPE_INT, profile));
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
+	else if (cv) {
+		cv->v.i = i64;
+		cv->gen = gen;
+	}
 
 	return i64;
 }
@@ -1381,9 +1471,14 @@ float find_config_tree_float(struct cmd_context *cmd, int id, struct profile *pr
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	struct config_value *cv;
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	float f;
 
+	if ((cv = _config_value(cmd, item, profile)) && (cv->gen == gen))
+		return cv->v.f;
+
 	profile_applied = _apply_local_profile(cmd, profile);
 	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
@@ -1394,7 +1489,11 @@ float find_config_tree_float(struct cmd_context *cmd, int id, struct profile *pr
 					      : dm_config_tree_find_float(cmd->cft, path, cfg_def_get_default_value(cmd, item, CFG_TYPE_FLOAT, profile));
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
+	else if (cv) {
+		cv->v.f = f;
+		cv->gen = gen;
+	}
 
 	return f;
 }
@@ -1420,9 +1519,14 @@ int find_config_tree_bool(struct cmd_context *cmd, int id, struct profile *profi
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	struct config_value *cv;
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	int b;
 
+	if ((cv = _config_value(cmd, item, profile)) && (cv->gen == gen))
+		return (int) cv->v.i;
+
 	profile_applied = _apply_local_profile(cmd, profile);
 	_cfg_def_make_path(path, sizeof(path), item->id, item, 0);
 
@@ -1433,7 +1537,11 @@ int find_config_tree_bool(struct cmd_context *cmd, int id, struct profile *profi
 					      : dm_config_tree_find_bool(cmd->cft, path, cfg_def_get_default_value(cmd, item, CFG_TYPE_BOOL, profile));
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
+	else if (cv) {
+		cv->v.i = b;
+		cv->gen = gen;
+	}
 
 	return b;
 }
@@ -1513,6 +1621,7 @@ const struct dm_config_node *find_config_tree_array(struct cmd_context *cmd, int
 {
 	cfg_def_item_t *item = cfg_def_get_item_p(id);
 	char path[CFG_PATH_MAX_LEN];
+	unsigned gen = cmd->config_gen;
 	int profile_applied;
 	const struct dm_config_node *cn = NULL, *cn_def = NULL;
 	profile_applied = _apply_local_profile(cmd, profile);
@@ -1533,7 +1642,7 @@ const struct dm_config_node *find_config_tree_array(struct cmd_context *cmd, int
 	}
 
 	if (profile_applied && profile)
-		remove_config_tree_by_source(cmd, profile->source);
+		_remove_local_profile(cmd, profile, gen);
 
 	return cn;
 }
@@ -230,6 +230,23 @@ int config_def_check(struct cft_check_handle *handle);
 /* Forces config check and automatically creates a new handle inside with defaults and discards the handle after the check. */
 int config_force_check(struct cmd_context *cmd, config_source_t source, struct dm_config_tree *cft);
 
+/*
+ * Resolved value of a configuration setting as returned by find_config_tree_*.
+ * Values are kept in cmd->config_values indexed by config id and are valid
+ * while cmd->config_gen equals gen.  config_tree_changed() must be called
+ * whenever the config cascade in cmd->cft is modified.
+ */
+struct config_value {
+	unsigned gen;
+	union {
+		const char *str;
+		int64_t i;
+		float f;
+	} v;
+};
+
+void config_tree_changed(struct cmd_context *cmd);
+
 int override_config_tree_from_string(struct cmd_context *cmd, const char *config_settings);
 int override_config_tree_from_profile(struct cmd_context *cmd, struct profile *profile);
 struct dm_config_tree *get_config_tree_by_source(struct cmd_context *, config_source_t source);
@@ -245,6 +262,10 @@ int config_file_read_fd(struct dm_config_tree *cft, struct device *dev, dev_io_r
 			checksum_fn_t checksum_fn, uint32_t checksum,
 			int skip_parse, int no_dup_node_check);
 int config_file_read(struct dm_config_tree *cft);
+int config_snapshot_load(struct dm_config_tree *cft, const char *filename, const struct stat *info);
+void config_snapshot_save(const struct dm_config_tree *cft, const char *filename, const struct stat *info);
+void config_snapshots_enable(int enable);
+int config_snapshots_enabled(void);
 struct dm_config_tree *config_file_open_and_read(const char *config_file, config_source_t source,
 						 struct cmd_context *cmd);
 int config_write(struct dm_config_tree *cft, struct config_def_tree_spec *tree_spec,
@@ -217,6 +217,14 @@ cfg(config_checks_CFG, "checks", config_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_
 cfg(config_abort_on_errors_CFG, "abort_on_errors", config_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, 0, vsn(2,2,99), NULL, 0, NULL,
 	"Abort the LVM process if a configuration mismatch is found.\n")
 
+cfg(config_snapshots_CFG, "snapshots", config_CFG_SECTION, CFG_DEFAULT_COMMENTED | CFG_ADVANCED, CFG_TYPE_BOOL, DEFAULT_CONFIG_SNAPSHOTS, vsn(2, 3, 19), NULL, 0, NULL,
+	"Use binary snapshots of parsed configuration files.\n"
+	"After a configuration file or profile is parsed, the parsed form is\n"
+	"saved in the run directory and is used by later commands instead of\n"
+	"parsing the file again, as long as the file is not changed. Setting\n"
+	"the environment variable LVM_SUPPRESS_CONFIG_SNAPSHOTS has the same\n"
+	"effect as disabling this setting.\n")
+
 cfg_runtime(config_profile_dir_CFG, "profile_dir", config_CFG_SECTION, CFG_DEFAULT_COMMENTED | CFG_DISALLOW_INTERACTIVE, CFG_TYPE_STRING, vsn(2, 2, 99), 0, NULL,
 	"Directory where LVM looks for configuration profiles.\n")
 
@@ -241,6 +249,19 @@ cfg(devices_obtain_device_list_from_udev_CFG, "obtain_device_list_from_udev", de
 	"directories will be scanned fully. LVM needs to be compiled with\n"
 	"udev support for this setting to apply.\n")
 
+cfg(devices_obtain_device_list_from_sysfs_CFG, "obtain_device_list_from_sysfs", devices_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_OBTAIN_DEVICE_LIST_FROM_SYSFS, vsn(2, 3, 19), NULL, 0, NULL,
+	"Obtain the list of available devices from /sys/dev/block.\n"
+	"Instead of reading every entry in the device directory, only the\n"
+	"kernel name of each block device (and the device-mapper name for\n"
+	"dm devices) is added. Symlinks such as /dev/disk/by-id are not\n"
+	"collected. They can still be used on the command line, and names\n"
+	"from the devices file or --devices are looked up and added as\n"
+	"aliases. Regex filters match all the names of a device, so this\n"
+	"setting is ignored when devices/filter or devices/global_filter\n"
+	"contain any pattern other than \"a|.*|\". This setting applies only\n"
+	"to the device directory itself and is not used when\n"
+	"obtain_device_list_from_udev is in effect.\n")
+
 cfg(devices_external_device_info_source_CFG, "external_device_info_source", devices_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_STRING, DEFAULT_EXTERNAL_DEVICE_INFO_SOURCE, vsn(2, 2, 116), NULL, 0, NULL,
 	"Enable device information from udev.\n"
 	"If set to \"udev\", lvm will supplement its own native device information\n"
@@ -306,6 +327,15 @@ cfg(devices_search_for_devnames_CFG, "search_for_devnames", devices_CFG_SECTION,
 	"at other devices, but only those that are likely to have the PV.\n"
 	"If \"all\", lvm will look at all devices on the system.\n")
 
+cfg(devices_devicesfile_vg_scan_CFG, "devicesfile_vg_scan", devices_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_DEVICESFILE_VG_SCAN, vsn(2, 3, 19), NULL, 0, NULL,
+	"Record the VG of each PV in the devices file and use it to limit scanning.\n"
+	"Each devices file entry is updated with the name and uuid of the\n"
+	"VG found on the device. Commands that use a single VG, e.g.\n"
+	"lvchange -ay vg/lv, then only scan the devices recorded for that VG,\n"
+	"and devices with no VG recorded. If the scan finds a different PV or\n"
+	"VG on those devices, or does not find all PVs of the VG, the other\n"
+	"devices in the devices file are scanned as usual.\n")
+
 cfg_array(devices_filter_CFG, "filter", devices_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_STRING, "#Sa|.*|", vsn(1, 0, 0), NULL, 0, NULL,
 	"Limit the block devices that are used by LVM commands.\n"
 	"This is a list of regular expressions used to accept or reject block\n"
@@ -1138,6 +1168,18 @@ cfg(global_event_activation_CFG, "event_activation", global_CFG_SECTION, CFG_DEF
 	"services (via the lvm2-activation-generator), but the autoactivation\n"
 	"services and generator have been removed.\n")
 
+cfg(global_event_activation_batch_CFG, "event_activation_batch", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_EVENT_ACTIVATION_BATCH, vsn(2, 3, 19), NULL, 0, NULL,
+	"Batch concurrent pvscan event activation commands.\n"
+	"When many PVs appear at once, udev runs one pvscan for each of them.\n"
+	"When this is enabled, each pvscan --cache -aay, or pvscan --cache\n"
+	"--listvg --checkcomplete run by the udev rule, queues its device in\n"
+	"the run directory. The pvscan holding the batch lock processes all\n"
+	"queued devices together. pvscan --cache -aay does not wait when\n"
+	"another pvscan holds the lock. The udev rule pvscan waits for the\n"
+	"batch that includes its device and then reports the result for its\n"
+	"own device, so its udev event lasts until that batch is done, which\n"
+	"must stay within the udev event timeout.\n")
+
 cfg(global_use_lvmetad_CFG, "use_lvmetad", global_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, 0, vsn(2, 2, 93), 0, vsn(2, 3, 0), NULL,
 	NULL)
 
@@ -1670,6 +1712,19 @@ cfg(activation_use_mlockall_CFG, "use_mlockall", activation_CFG_SECTION, CFG_DEF
 	"Prior to version 2.02.62, LVM used mlockall() to pin the whole\n"
 	"process's memory while activating devices.\n")
 
+cfg(activation_mlock_maps_cache_CFG, "mlock_maps_cache", activation_CFG_SECTION, CFG_DEFAULT_COMMENTED | CFG_ADVANCED, CFG_TYPE_BOOL, DEFAULT_MLOCK_MAPS_CACHE, vsn(2, 3, 19), NULL, 0, NULL,
+	"Keep memory areas locked between critical sections.\n"
+	"When enabled, memory pinned for the first critical section stays\n"
+	"pinned until the command exits, and later critical sections do not\n"
+	"pin file mappings from /proc/self/maps again while they have the\n"
+	"same address, perms, offset, device and inode. This avoids repeating\n"
+	"the full mlock of all libraries for every LV in commands that suspend\n"
+	"and resume many LVs. /proc/self/maps is still read for every critical\n"
+	"section, and anonymous memory is always pinned again, as it may have\n"
+	"been unmapped and mapped again at the same address. Mappings not\n"
+	"pinned again are checked to be still locked in /proc/self/smaps,\n"
+	"otherwise all memory is pinned again. Not used with use_mlockall.\n")
+
 cfg(activation_monitoring_CFG, "monitoring", activation_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_DMEVENTD_MONITOR, vsn(2, 2, 63), NULL, 0, NULL,
 	"Monitor LVs that are activated.\n"
 	"The --ignoremonitoring option overrides this setting.\n"
@@ -1683,6 +1738,17 @@ cfg(activation_polling_interval_CFG, "polling_interval", activation_CFG_SECTION,
 	"is only one thing to wait for, there are no progress reports, but\n"
 	"the process is awoken immediately once the operation is complete.\n")
 
+cfg(activation_pvmove_streams_CFG, "pvmove_streams", activation_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_PVMOVE_STREAMS, vsn(2, 3, 19), NULL, 0, NULL,
+	"The number of pvmove segments copied at the same time.\n"
+	"pvmove copies the extents of each source segment with a separate\n"
+	"mirror in the kernel. By default only one segment is copied at\n"
+	"once, and the remaining segments wait until it is in sync.\n"
+	"Higher values run that many copies in parallel, which can speed\n"
+	"up evacuating a PV onto several destination PVs, at the cost of\n"
+	"more I/O load on the devices involved. Progress is reported\n"
+	"for the whole move. The minimum value is 1, lower values are\n"
+	"replaced by 1 with a warning.\n")
+
 cfg(activation_auto_set_activation_skip_CFG, "auto_set_activation_skip", activation_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_AUTO_SET_ACTIVATION_SKIP, vsn(2,2,99), NULL, 0, NULL,
 	"Set the activation skip flag on new thin snapshot LVs.\n"
 	"The --setactivationskip option overrides this setting.\n"
@@ -1740,6 +1806,23 @@ cfg(metadata_lvs_history_retention_time_CFG, "lvs_history_retention_time", metad
 	"historical logical volume is automatically destroyed.\n"
 	"A value of 0 disables this feature.\n")
 
+cfg(metadata_full_validate_interval_CFG, "full_validate_interval", metadata_CFG_SECTION, CFG_ADVANCED | CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_FULL_VALIDATE_INTERVAL, vsn(2, 3, 19), NULL, 0, NULL,
+	"How often the segments of all LVs are checked when writing a VG.\n"
+	"Before VG metadata is written, it is checked for consistency.\n"
+	"The LV and PV segments are also checked when the VG is read, so\n"
+	"checking them again only for the LVs changed since then (and the\n"
+	"LVs and PVs they are linked to) saves time in VGs with many LVs.\n"
+	"#\n"
+	"Accepted values:\n"
+	"  1\n"
+	"    Check the segments of all LVs on every write.\n"
+	"  0\n"
+	"    Check the segments of changed LVs only.\n"
+	"  N\n"
+	"    Check the segments of all LVs when the new metadata sequence\n"
+	"    number is a multiple of N, and of changed LVs otherwise.\n"
+	"#\n")
+
 cfg(metadata_pvmetadatacopies_CFG, "pvmetadatacopies", metadata_CFG_SECTION, CFG_ADVANCED | CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_PVMETADATACOPIES, vsn(1, 0, 0), NULL, 0, NULL,
 	"Number of copies of metadata to store on each PV.\n"
 	"The --pvmetadatacopies option overrides this setting.\n"
@@ -2167,6 +2250,14 @@ cfg(dmeventd_vdo_command_CFG, "vdo_command", dmeventd_CFG_SECTION, CFG_DEFAULT_C
 cfg(dmeventd_executable_CFG, "executable", dmeventd_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_STRING, DEFAULT_DMEVENTD_PATH, vsn(2, 2, 73), "@DMEVENTD_PATH@", 0, NULL,
 	"The full path to the dmeventd binary.\n")
 
+cfg(dmeventd_status_max_age_CFG, "status_max_age", dmeventd_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_INT, DEFAULT_DMEVENTD_STATUS_MAX_AGE, vsn(2, 3, 19), NULL, 0, NULL,
+	"Use thin pool status published by dmeventd when not older than this.\n"
+	"dmeventd publishes the last status of monitored devices in\n"
+	"shared memory. Commands reading thin pool usage without flushing\n"
+	"(e.g. lvs) then avoid an ioctl for each monitored pool. The value\n"
+	"is in seconds, the status is refreshed on every dmeventd check of\n"
+	"the pool (at least each 10 seconds). Set to 0 to always ask the kernel.\n")
+
 cfg(tags_hosttags_CFG, "hosttags", tags_CFG_SECTION, CFG_DEFAULT_COMMENTED, CFG_TYPE_BOOL, DEFAULT_HOSTTAGS, vsn(1, 0, 18), NULL, 0, NULL,
 	"Create a host tag using the machine name.\n"
 	"The machine name is nodename returned by uname(2).\n")
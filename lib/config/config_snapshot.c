@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU Lesser General Public License v.2.1.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Binary snapshots of parsed config files.
+ *
+ * lvm.conf, lvmlocal.conf, tag config files and profiles are parsed
+ * by every command.  After a file is parsed, its tree is written in a
+ * flat binary form to CONFIG_SNAPSHOT_DIR.  The snapshot is keyed by
+ * device, inode, size and ctime of the source file (the same values
+ * config_file_changed() uses to detect changes), so the next command
+ * maps the snapshot and builds the tree from it with a few allocations
+ * instead of running the text parser.
+ *
+ * Layout: header, nodes in pre-order (each node followed by all its
+ * descendants), values in node order, strings.
+ */
+
+#include "lib/misc/lib.h"
+#include "lib/config/config.h"
+#include "lib/config/defaults.h"
+#include "lib/misc/crc.h"
+#include "lib/misc/lvm-file.h"
+
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define CONFIG_SNAPSHOT_MAGIC "LVMCFGS1"
+#define CONFIG_SNAPSHOT_MAX_DEPTH 64
+
+struct config_snapshot_header {
+	char magic[8];
+	uint64_t st_dev;
+	uint64_t st_ino;
+	uint64_t st_size;
+	int64_t ctime_sec;
+	int64_t ctime_nsec;
+	uint32_t root_count;	/* top level nodes */
+	uint32_t node_count;
+	uint32_t value_count;
+	uint32_t strings_size;
+	uint32_t path;		/* offset of source file path in strings */
+	uint32_t checksum;	/* of everything following the header */
+};
+
+struct config_snapshot_node {
+	uint32_t key;		/* offset in strings */
+	uint32_t child_count;
+	uint32_t value_count;
+	uint32_t padding;
+};
+
+struct config_snapshot_value {
+	uint32_t type;
+	uint32_t str;		/* offset in strings */
+	int64_t i;
+	float f;
+	uint32_t padding;
+};
+
+struct snapshot_ctx {
+	const struct config_snapshot_header *hdr;
+	const struct config_snapshot_node *snodes;
+	const struct config_snapshot_value *svalues;
+	const char *sstrings;
+
+	struct dm_config_node *nodes;
+	struct dm_config_value *values;
+	char *strings;
+
+	uint32_t node_idx;
+	uint32_t value_idx;
+	uint32_t strings_size;
+};
+
+static int _snapshot_path(char *buf, size_t size, const char *filename)
+{
+	char *p;
+
+	if (dm_snprintf(buf, size, "%s/%s", CONFIG_SNAPSHOT_DIR, filename) < 0)
+		return 0;
+
+	/* /etc/lvm/lvm.conf -> CONFIG_SNAPSHOT_DIR/_etc_lvm_lvm.conf */
+	for (p = buf + strlen(CONFIG_SNAPSHOT_DIR) + 1; *p; p++)
+		if (*p == '/')
+			*p = '_';
+
+	return 1;
+}
+
+static void _set_key(struct config_snapshot_header *hdr, const struct stat *info)
+{
+	struct timespec ts;
+
+	lvm_stat_ctim(&ts, info);
+	hdr->st_dev = (uint64_t) info->st_dev;
+	hdr->st_ino = (uint64_t) info->st_ino;
+	hdr->st_size = (uint64_t) info->st_size;
+	hdr->ctime_sec = (int64_t) ts.tv_sec;
+	hdr->ctime_nsec = (int64_t) ts.tv_nsec;
+}
+
+/*
+ * Snapshots can be disabled by config/snapshots or by setting
+ * LVM_SUPPRESS_CONFIG_SNAPSHOTS in the environment.
+ */
+static int _snapshots_disabled = 0;
+
+void config_snapshots_enable(int enable)
+{
+	_snapshots_disabled = !enable;
+}
+
+int config_snapshots_enabled(void)
+{
+	return !_snapshots_disabled && !getenv("LVM_SUPPRESS_CONFIG_SNAPSHOTS");
+}
+
+/*
+ * The file may be replaced or rewritten while it is being parsed.
+ * Only save the snapshot if the file still looks like the one read.
+ */
+static int _file_unchanged(const char *filename, const struct stat *info)
+{
+	struct timespec ts_read, ts_now;
+	struct stat st;
+
+	if (stat(filename, &st)) {
+		log_sys_debug("stat", filename);
+		return 0;
+	}
+
+	lvm_stat_ctim(&ts_read, info);
+	lvm_stat_ctim(&ts_now, &st);
+
+	return (st.st_dev == info->st_dev) && (st.st_ino == info->st_ino) &&
+	       (st.st_size == info->st_size) && (st.st_mtime == info->st_mtime) &&
+	       timespeccmp(&ts_read, &ts_now, ==);
+}
+
+/*
+ * Load snapshot.
+ */
+
+static const char *_snapshot_str(struct snapshot_ctx *ctx, uint32_t offset)
+{
+	/* Strings area ends with '\0', so every valid offset is terminated. */
+	if (offset >= ctx->strings_size)
+		return NULL;
+
+	return ctx->strings + offset;
+}
+
+static struct dm_config_node *_load_nodes(struct snapshot_ctx *ctx, struct dm_config_node *parent,
+					  uint32_t count, unsigned depth)
+{
+	const struct config_snapshot_node *sn;
+	const struct config_snapshot_value *sv;
+	struct dm_config_node *cn, *first = NULL, *prev = NULL;
+	struct dm_config_value *cv, *prev_v;
+	uint32_t i, j;
+
+	if (depth > CONFIG_SNAPSHOT_MAX_DEPTH)
+		return_NULL;
+
+	for (i = 0; i < count; i++) {
+		if (ctx->node_idx >= ctx->hdr->node_count)
+			return_NULL;
+
+		sn = &ctx->snodes[ctx->node_idx];
+		cn = &ctx->nodes[ctx->node_idx++];
+
+		if (!(cn->key = _snapshot_str(ctx, sn->key)))
+			return_NULL;
+		cn->parent = parent;
+
+		prev_v = NULL;
+		for (j = 0; j < sn->value_count; j++) {
+			if (ctx->value_idx >= ctx->hdr->value_count)
+				return_NULL;
+
+			sv = &ctx->svalues[ctx->value_idx];
+			cv = &ctx->values[ctx->value_idx++];
+
+			switch ((cv->type = sv->type)) {
+			case DM_CFG_INT:
+				cv->v.i = sv->i;
+				break;
+			case DM_CFG_FLOAT:
+				cv->v.f = sv->f;
+				break;
+			case DM_CFG_STRING:
+				if (!(cv->v.str = _snapshot_str(ctx, sv->str)))
+					return_NULL;
+				break;
+			case DM_CFG_EMPTY_ARRAY:
+				break;
+			default:
+				return_NULL;
+			}
+
+			if (prev_v)
+				prev_v->next = cv;
+			else
+				cn->v = cv;
+			prev_v = cv;
+		}
+
+		if (sn->child_count &&
+		    !(cn->child = _load_nodes(ctx, cn, sn->child_count, depth + 1)))
+			return_NULL;
+
+		if (prev)
+			prev->sib = cn;
+		else
+			first = cn;
+		prev = cn;
+	}
+
+	return first;
+}
+
+/*
+ * Populate cft from the snapshot of the config file if the file
+ * did not change since the snapshot was written.
+ * Returns 0 if there is no usable snapshot.
+ */
+int config_snapshot_load(struct dm_config_tree *cft, const char *filename, const struct stat *info)
+{
+	struct config_snapshot_header key = { 0 };
+	const struct config_snapshot_header *hdr;
+	struct snapshot_ctx ctx = { 0 };
+	char path[PATH_MAX];
+	struct stat st;
+	void *map = MAP_FAILED;
+	size_t size = 0;
+	uint64_t data_size;
+	int fd, r = 0;
+
+	if (!_snapshot_path(path, sizeof(path), filename))
+		return 0;
+
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+		return 0;
+
+	/* Only trust snapshots written by ourselves. */
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || (st.st_uid != geteuid()) ||
+	    (st.st_size < (off_t) sizeof(*hdr)))
+		goto out;
+
+	size = (size_t) st.st_size;
+	if ((map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+		log_sys_debug("mmap", path);
+		goto out;
+	}
+
+	hdr = map;
+	_set_key(&key, info);
+
+	if (memcmp(hdr->magic, CONFIG_SNAPSHOT_MAGIC, sizeof(hdr->magic)) ||
+	    (hdr->st_dev != key.st_dev) || (hdr->st_ino != key.st_ino) ||
+	    (hdr->st_size != key.st_size) || (hdr->ctime_sec != key.ctime_sec) ||
+	    (hdr->ctime_nsec != key.ctime_nsec)) {
+		log_debug("Config snapshot %s is stale.", path);
+		goto out;
+	}
+
+	data_size = (uint64_t) hdr->node_count * sizeof(struct config_snapshot_node) +
+		    (uint64_t) hdr->value_count * sizeof(struct config_snapshot_value) +
+		    hdr->strings_size;
+
+	if (!hdr->strings_size || (data_size > UINT32_MAX) || (data_size != size - sizeof(*hdr)) ||
+	    (hdr->checksum != calc_crc(INITIAL_CRC, (const uint8_t *) (hdr + 1), (uint32_t) data_size))) {
+		log_debug("Config snapshot %s is invalid.", path);
+		goto out;
+	}
+
+	ctx.hdr = hdr;
+	ctx.snodes = (const struct config_snapshot_node *) (hdr + 1);
+	ctx.svalues = (const struct config_snapshot_value *) (ctx.snodes + hdr->node_count);
+	ctx.sstrings = (const char *) (ctx.svalues + hdr->value_count);
+	ctx.strings_size = hdr->strings_size;
+
+	if (ctx.sstrings[ctx.strings_size - 1] ||
+	    (hdr->path >= ctx.strings_size) || strcmp(ctx.sstrings + hdr->path, filename))
+		goto out;
+
+	if (!(ctx.nodes = dm_pool_zalloc(cft->mem, hdr->node_count * sizeof(*ctx.nodes) + 1)) ||
+	    !(ctx.values = dm_pool_zalloc(cft->mem, hdr->value_count * sizeof(*ctx.values) + 1)) ||
+	    !(ctx.strings = dm_pool_alloc(cft->mem, ctx.strings_size))) {
+		log_error("Failed to allocate config tree from snapshot.");
+		goto out;
+	}
+	memcpy(ctx.strings, ctx.sstrings, ctx.strings_size);
+
+	cft->root = hdr->root_count ? _load_nodes(&ctx, NULL, hdr->root_count, 0) : NULL;
+
+	if ((hdr->root_count && !cft->root) ||
+	    (ctx.node_idx != hdr->node_count) || (ctx.value_idx != hdr->value_count)) {
+		log_debug("Config snapshot %s is corrupted.", path);
+		cft->root = NULL;
+		goto out;
+	}
+
+	log_debug("Loaded config file %s from snapshot.", filename);
+	r = 1;
+out:
+	if ((map != MAP_FAILED) && munmap(map, size))
+		log_sys_debug("munmap", path);
+	if (close(fd))
+		log_sys_debug("close", path);
+
+	return r;
+}
+
+/*
+ * Save snapshot.
+ */
+
+static void _count_nodes(const struct dm_config_node *cn, struct config_snapshot_header *hdr)
+{
+	const struct dm_config_value *cv;
+
+	for (; cn; cn = cn->sib) {
+		hdr->node_count++;
+		hdr->strings_size += strlen(cn->key) + 1;
+
+		for (cv = cn->v; cv; cv = cv->next) {
+			hdr->value_count++;
+			if (cv->type == DM_CFG_STRING)
+				hdr->strings_size += strlen(cv->v.str) + 1;
+		}
+
+		_count_nodes(cn->child, hdr);
+	}
+}
+
+static uint32_t _save_str(struct snapshot_ctx *ctx, const char *str)
+{
+	uint32_t offset = ctx->strings_size;
+	size_t len = strlen(str) + 1;
+
+	memcpy(ctx->strings + offset, str, len);
+	ctx->strings_size += len;
+
+	return offset;
+}
+
+static uint32_t _save_nodes(struct snapshot_ctx *ctx, const struct dm_config_node *cn)
+{
+	struct config_snapshot_node *sn;
+	struct config_snapshot_value *sv;
+	const struct dm_config_value *cv;
+	uint32_t count = 0;
+
+	for (; cn; cn = cn->sib, count++) {
+		sn = (struct config_snapshot_node *) ctx->snodes + ctx->node_idx++;
+		sn->key = _save_str(ctx, cn->key);
+
+		for (cv = cn->v; cv; cv = cv->next, sn->value_count++) {
+			sv = (struct config_snapshot_value *) ctx->svalues + ctx->value_idx++;
+			sv->type = cv->type;
+			if (cv->type == DM_CFG_INT)
+				sv->i = cv->v.i;
+			else if (cv->type == DM_CFG_FLOAT)
+				sv->f = cv->v.f;
+			else if (cv->type == DM_CFG_STRING)
+				sv->str = _save_str(ctx, cv->v.str);
+		}
+
+		sn->child_count = _save_nodes(ctx, cn->child);
+	}
+
+	return count;
+}
+
+/*
+ * Write snapshot of the freshly parsed config file.
+ * Failures are not errors, the file is just parsed again next time.
+ */
+void config_snapshot_save(const struct dm_config_tree *cft, const char *filename, const struct stat *info)
+{
+	struct config_snapshot_header *hdr;
+	struct snapshot_ctx ctx = { 0 };
+	char path[PATH_MAX], tmp_path[PATH_MAX];
+	unsigned seed = 0;
+	size_t size, data_size;
+	char *buf;
+	int fd;
+
+	if (!_snapshot_path(path, sizeof(path), filename))
+		return;
+
+	if (!_file_unchanged(filename, info)) {
+		log_debug("Not saving config snapshot, %s changed while reading.", filename);
+		return;
+	}
+
+	if (!dir_exists(CONFIG_SNAPSHOT_DIR)) {
+		dm_prepare_selinux_context(CONFIG_SNAPSHOT_DIR, S_IFDIR);
+		if (mkdir(CONFIG_SNAPSHOT_DIR, 0700) && (errno != EEXIST)) {
+			log_sys_debug("mkdir", CONFIG_SNAPSHOT_DIR);
+			dm_prepare_selinux_context(NULL, 0);
+			return;
+		}
+		dm_prepare_selinux_context(NULL, 0);
+	}
+
+	if (!(hdr = zalloc(sizeof(*hdr))))
+		return;
+
+	_count_nodes(cft->root, hdr);
+	hdr->strings_size += strlen(filename) + 1;
+
+	data_size = hdr->node_count * sizeof(struct config_snapshot_node) +
+		    hdr->value_count * sizeof(struct config_snapshot_value) +
+		    hdr->strings_size;
+	size = sizeof(*hdr) + data_size;
+
+	if (size > UINT32_MAX || !(buf = zalloc(size))) {
+		free(hdr);
+		return;
+	}
+
+	memcpy(buf, hdr, sizeof(*hdr));
+	free(hdr);
+	hdr = (struct config_snapshot_header *) buf;
+
+	ctx.snodes = (struct config_snapshot_node *) (hdr + 1);
+	ctx.svalues = (struct config_snapshot_value *) (ctx.snodes + hdr->node_count);
+	ctx.strings = (char *) (ctx.svalues + hdr->value_count);
+
+	memcpy(hdr->magic, CONFIG_SNAPSHOT_MAGIC, sizeof(hdr->magic));
+	_set_key(hdr, info);
+	hdr->path = _save_str(&ctx, filename);
+	hdr->root_count = _save_nodes(&ctx, cft->root);
+	hdr->checksum = calc_crc(INITIAL_CRC, (const uint8_t *) (hdr + 1), (uint32_t) data_size);
+
+	if (!create_temp_name(CONFIG_SNAPSHOT_DIR, tmp_path, sizeof(tmp_path), &fd, &seed)) {
+		log_debug("Cannot create config snapshot for %s.", filename);
+		goto out;
+	}
+
+	if (write(fd, buf, size) != (ssize_t) size) {
+		log_sys_debug("write", tmp_path);
+		if (close(fd))
+			stack;
+		goto bad;
+	}
+
+	if (close(fd)) {
+		log_sys_debug("close", tmp_path);
+		goto bad;
+	}
+
+	if (rename(tmp_path, path)) {
+		log_sys_debug("rename", path);
+		goto bad;
+	}
+
+	log_debug("Saved config file %s to snapshot.", filename);
+	goto out;
+bad:
+	if (unlink(tmp_path))
+		log_sys_debug("unlink", tmp_path);
+out:
+	free(buf);
+}
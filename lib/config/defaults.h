@@ -43,6 +43,7 @@
 #define DEFAULT_PROC_DIR "/proc"
 #define DEFAULT_SYSTEM_ID_SOURCE "none"
 #define DEFAULT_OBTAIN_DEVICE_LIST_FROM_UDEV 0
+#define DEFAULT_OBTAIN_DEVICE_LIST_FROM_SYSFS 0
 #define DEFAULT_EXTERNAL_DEVICE_INFO_SOURCE "none"
 #define DEFAULT_SYSFS_SCAN 1
 #define DEFAULT_MD_COMPONENT_DETECTION 1
@@ -67,6 +68,7 @@
 #define DEFAULT_LVMETAD_UPDATE_WAIT_TIME 10
 #define DEFAULT_PRIORITISE_WRITE_LOCKS 1
 #define DEFAULT_USE_MLOCKALL 0
+#define DEFAULT_MLOCK_MAPS_CACHE 0
 #define DEFAULT_METADATA_READ_ONLY 0
 #define DEFAULT_LVDISPLAY_SHOWS_FULL_DEVICE_PATH 0
 #define DEFAULT_UNKNOWN_DEVICE_NAME "[unknown]"
@@ -97,6 +99,7 @@
 #define DEFAULT_DMEVENTD_VDO_LIB "libdevmapper-event-lvm2vdo.so"
 #define DEFAULT_DMEVENTD_VDO_COMMAND "lvm lvextend --use-policies"
 #define DEFAULT_DMEVENTD_MONITOR 1
+#define DEFAULT_DMEVENTD_STATUS_MAX_AGE 0
 #define DEFAULT_BACKGROUND_POLLING 1
 
 #ifndef DMEVENTD_PATH
@@ -192,6 +195,7 @@
 
 #define DEFAULT_STRIPESIZE 64	/* KB */
 #define DEFAULT_RECORD_LVS_HISTORY 0
+#define DEFAULT_FULL_VALIDATE_INTERVAL 1
 #define DEFAULT_LVS_HISTORY_RETENTION_TIME 0
 #define DEFAULT_PVMETADATAIGNORE 0
 #define DEFAULT_PVMETADATACOPIES 1
@@ -251,6 +255,7 @@
 #define DEFAULT_STRIPE_FILLER "error"
 #define DEFAULT_RAID_REGION_SIZE   2048	/* KB */
 #define DEFAULT_INTERVAL 15
+#define DEFAULT_PVMOVE_STREAMS 1
 
 #define DEFAULT_MAX_HISTORY 100
 
@@ -323,6 +328,7 @@
 #define DEFAULT_MD_COMPONENT_CHECKS "auto"
 
 #define DEFAULT_DEVICES_FILE "system.devices"
+#define DEFAULT_DEVICESFILE_VG_SCAN 0
 
 #define DEFAULT_SEARCH_FOR_DEVNAMES "auto"
 
@@ -331,6 +337,12 @@
 #define PVS_ONLINE_DIR DEFAULT_RUN_DIR "/pvs_online"
 #define VGS_ONLINE_DIR DEFAULT_RUN_DIR "/vgs_online"
 #define PVS_LOOKUP_DIR DEFAULT_RUN_DIR "/pvs_lookup"
+#define PVSCAN_QUEUE_DIR DEFAULT_RUN_DIR "/pvscan_queue"
+#define PVSCAN_BATCH_LOCK_FILE DEFAULT_RUN_DIR "/pvscan_batch"
+#define PVSCAN_LIST_BATCH_LOCK_FILE DEFAULT_RUN_DIR "/pvscan_batch_list"
+#define CONFIG_SNAPSHOT_DIR DEFAULT_RUN_DIR "/config_snapshots"
+#define DEFAULT_CONFIG_SNAPSHOTS 1
+#define DEFAULT_EVENT_ACTIVATION_BATCH 0
 
 #define DEFAULT_DEVICE_ID_SYSFS_DIR "/sys/"  /* trailing / to match dm_sysfs_dir() */
 
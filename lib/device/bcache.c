@@ -153,9 +153,28 @@ static void _async_destroy(struct io_engine *ioe)
 	free(e);
 }
 
-static int _last_byte_di;
-static uint64_t _last_byte_offset;
-static int _last_byte_sector_size;
+/*
+ * The write limit set by lvm is kept per di (indexed like _fd_table)
+ * so that writes to several devices can be queued and issued together
+ * with a single flush, each one clamped to its own last byte.
+ */
+struct last_byte {
+	uint64_t offset;
+	int sector_size;
+};
+
+static struct last_byte *_last_byte_table;
+
+static struct last_byte *_get_last_byte(enum dir d, int di)
+{
+	if ((d != DIR_WRITE) || (di < 0) || (di >= _fd_table_size) || !_last_byte_table)
+		return NULL;
+
+	if (!_last_byte_table[di].offset)
+		return NULL;
+
+	return &_last_byte_table[di];
+}
 
 static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 			 sector_t sb, sector_t se, void *data, void *context)
@@ -169,6 +188,7 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 	sector_t limit_nbytes;
 	sector_t orig_nbytes;
 	sector_t extra_nbytes = 0;
+	struct last_byte *lb;
 
 	if (((uintptr_t) data) & e->page_mask) {
 		log_warn("misaligned data buffer");
@@ -181,12 +201,12 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 	/*
 	 * If bcache block goes past where lvm wants to write, then clamp it.
 	 */
-	if ((d == DIR_WRITE) && _last_byte_offset && (di == _last_byte_di)) {
-		if (offset > _last_byte_offset) {
+	if ((lb = _get_last_byte(d, di))) {
+		if (offset > lb->offset) {
 			log_error("Limit write at %llu len %llu beyond last byte %llu",
 				  (unsigned long long)offset,
 				  (unsigned long long)nbytes,
-				  (unsigned long long)_last_byte_offset);
+				  (unsigned long long)lb->offset);
 			return false;
 		}
 
@@ -199,11 +219,11 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 		 * or 4096) then extend the reduced size to be a multiple of
 		 * the sector size (we don't want to write partial sectors.)
 		 */
-		if (offset + nbytes > _last_byte_offset) {
-			limit_nbytes = _last_byte_offset - offset;
+		if (offset + nbytes > lb->offset) {
+			limit_nbytes = lb->offset - offset;
 
-			if (limit_nbytes % _last_byte_sector_size) {
-				extra_nbytes = _last_byte_sector_size - (limit_nbytes % _last_byte_sector_size);
+			if (limit_nbytes % lb->sector_size) {
+				extra_nbytes = lb->sector_size - (limit_nbytes % lb->sector_size);
 
 				/*
 				 * adding extra_nbytes to the reduced nbytes (limit_nbytes)
@@ -218,7 +238,7 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 						 (unsigned long long)nbytes,
 						 (unsigned long long)limit_nbytes,
 						 (unsigned long long)extra_nbytes,
-						 (unsigned long long)_last_byte_sector_size);
+						 (unsigned long long)lb->sector_size);
 					extra_nbytes = 0;
 				}
 			}
@@ -252,7 +272,7 @@ static bool _async_issue(struct io_engine *ioe, enum dir d, int di,
 					  (unsigned long long)nbytes,
 					  (unsigned long long)limit_nbytes,
 					  (unsigned long long)extra_nbytes,
-					  (unsigned long long)_last_byte_sector_size);
+					  (unsigned long long)lb->sector_size);
 				return false;
 			}
 		}
@@ -428,6 +448,7 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 	uint64_t pos = 0;
 	uint64_t len = (se - sb) * 512;
 	struct sync_engine *e = _to_sync(ioe);
+	struct last_byte *lb;
 	struct sync_io *io = malloc(sizeof(*io));
 	if (!io) {
 		log_warn("unable to allocate sync_io");
@@ -450,27 +471,27 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 	/*
 	 * If bcache block goes past where lvm wants to write, then clamp it.
 	 */
-	if ((d == DIR_WRITE) && _last_byte_offset && (di == _last_byte_di)) {
+	if ((lb = _get_last_byte(d, di))) {
 		uint64_t offset = where;
 		uint64_t nbytes = len;
 		sector_t limit_nbytes = 0;
 		sector_t extra_nbytes = 0;
 		sector_t orig_nbytes = 0;
 
-		if (offset > _last_byte_offset) {
+		if (offset > lb->offset) {
 			log_error("Limit write at %llu len %llu beyond last byte %llu",
 				  (unsigned long long)offset,
 				  (unsigned long long)nbytes,
-				  (unsigned long long)_last_byte_offset);
+				  (unsigned long long)lb->offset);
 			free(io);
 			return false;
 		}
 
-		if (offset + nbytes > _last_byte_offset) {
-			limit_nbytes = _last_byte_offset - offset;
+		if (offset + nbytes > lb->offset) {
+			limit_nbytes = lb->offset - offset;
 
-			if (limit_nbytes % _last_byte_sector_size) {
-				extra_nbytes = _last_byte_sector_size - (limit_nbytes % _last_byte_sector_size);
+			if (limit_nbytes % lb->sector_size) {
+				extra_nbytes = lb->sector_size - (limit_nbytes % lb->sector_size);
 
 				/*
 				 * adding extra_nbytes to the reduced nbytes (limit_nbytes)
@@ -485,7 +506,7 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 						 (unsigned long long)nbytes,
 						 (unsigned long long)limit_nbytes,
 						 (unsigned long long)extra_nbytes,
-						 (unsigned long long)_last_byte_sector_size);
+						 (unsigned long long)lb->sector_size);
 					extra_nbytes = 0;
 				}
 			}
@@ -519,7 +540,7 @@ static bool _sync_issue(struct io_engine *ioe, enum dir d, int di,
 					  (unsigned long long)nbytes,
 					  (unsigned long long)limit_nbytes,
 					  (unsigned long long)extra_nbytes,
-					  (unsigned long long)_last_byte_sector_size);
+					  (unsigned long long)lb->sector_size);
 				free(io);
 				return false;
 			}
@@ -1168,6 +1189,15 @@ struct bcache *bcache_create(sector_t block_sectors, unsigned nr_cache_blocks,
 		return NULL;
 	}
 
+	if (!(_last_byte_table = calloc(_fd_table_size, sizeof(*_last_byte_table)))) {
+		free(_fd_table);
+		_fd_table = NULL;
+		cache->engine->destroy(cache->engine);
+		radix_tree_destroy(cache->rtree);
+		free(cache);
+		return NULL;
+	}
+
 	for (i = 0; i < _fd_table_size; i++)
 		_fd_table[i] = -1;
 
@@ -1188,6 +1218,8 @@ void bcache_destroy(struct bcache *cache)
 	free(cache);
 	free(_fd_table);
 	_fd_table = NULL;
+	free(_last_byte_table);
+	_last_byte_table = NULL;
 	_fd_table_size = 0;
 }
 
@@ -1451,25 +1483,45 @@ void bcache_abort_di(struct bcache *cache, int di)
 
 void bcache_set_last_byte(struct bcache *cache, int di, uint64_t offset, int sector_size)
 {
-	_last_byte_di = di;
-	_last_byte_offset = offset;
-	_last_byte_sector_size = sector_size;
-	if (!sector_size)
-		_last_byte_sector_size = 512;
+	if ((di < 0) || (di >= _fd_table_size))
+		return;
+
+	_last_byte_table[di].offset = offset;
+	_last_byte_table[di].sector_size = sector_size ? : 512;
 }
 
 void bcache_unset_last_byte(struct bcache *cache, int di)
 {
-	if (_last_byte_di == di) {
-		_last_byte_di = 0;
-		_last_byte_offset = 0;
-		_last_byte_sector_size = 0;
-	}
+	if ((di < 0) || (di >= _fd_table_size))
+		return;
+
+	_last_byte_table[di].offset = 0;
+	_last_byte_table[di].sector_size = 0;
+}
+
+uint64_t bcache_get_last_byte(struct bcache *cache, int di)
+{
+	if ((di < 0) || (di >= _fd_table_size))
+		return 0;
+
+	return _last_byte_table[di].offset;
+}
+
+bool bcache_has_errors(struct bcache *cache, int di)
+{
+	struct block *b;
+
+	dm_list_iterate_items_gen(b, &cache->errored, list)
+		if (b->di == di)
+			return true;
+
+	return false;
 }
 
 int bcache_set_fd(int fd)
 {
 	int *new_table = NULL;
+	struct last_byte *new_last_byte = NULL;
 	int new_size = 0;
 	int i;
 
@@ -1497,6 +1549,17 @@ int bcache_set_fd(int fd)
 		new_table[i] = -1;
 
 	_fd_table = new_table;
+
+	new_last_byte = realloc(_last_byte_table, sizeof(*new_last_byte) * new_size);
+	if (!new_last_byte) {
+		log_error("Cannot extend bcache last byte table");
+		return -1;
+	}
+
+	memset(new_last_byte + _fd_table_size, 0,
+	       sizeof(*new_last_byte) * (new_size - _fd_table_size));
+
+	_last_byte_table = new_last_byte;
 	_fd_table_size = new_size;
 
 	goto retry;
@@ -1513,6 +1576,8 @@ void bcache_clear_fd(int di)
 	if (di >= _fd_table_size)
 		return;
 	_fd_table[di] = -1;
+	_last_byte_table[di].offset = 0;
+	_last_byte_table[di].sector_size = 0;
 }
 
 int bcache_change_fd(int di, int fd)
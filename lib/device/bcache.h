@@ -160,6 +160,13 @@ bool bcache_invalidate_bytes(struct bcache *cache, int di, uint64_t start, size_
 
 void bcache_set_last_byte(struct bcache *cache, int di, uint64_t offset, int sector_size);
 void bcache_unset_last_byte(struct bcache *cache, int di);
+uint64_t bcache_get_last_byte(struct bcache *cache, int di);
+
+/*
+ * Returns true if a write to this di failed in the last flush and
+ * the dirty data is still held on the errored list.
+ */
+bool bcache_has_errors(struct bcache *cache, int di);
 
 //----------------------------------------------------------------
 
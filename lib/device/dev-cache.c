@@ -53,6 +53,7 @@ static struct {
 	const char *dev_dir;
 
 	int has_scanned;
+	int sysfs_block_scanned; /* dev_dir populated from /sys/dev/block */
 	long st_dev;
 	struct dm_list dirs;
 	struct dm_list files;
@@ -81,6 +82,7 @@ static void _dev_init(struct device *dev)
 	dm_list_init(&dev->aliases);
 	dm_list_init(&dev->ids);
 	dm_list_init(&dev->wwids);
+	dm_list_init(&dev->sysfs_attrs);
 }
 
 void dev_destroy_file(struct device *dev)
@@ -88,6 +90,7 @@ void dev_destroy_file(struct device *dev)
 	if (!(dev->flags & DEV_ALLOCED))
 		return;
 
+	dev_sysfs_invalidate(dev);
 	free((void *) dm_list_item(dev->aliases.n, struct dm_str_list)->str);
 	free(dev->aliases.n);
 	free(dev);
@@ -444,6 +447,231 @@ int get_dm_uuid_from_sysfs(char *buf, size_t buf_size, int major, int minor)
 	return get_sysfs_value(path, buf, buf_size, 0);
 }
 
+/*
+ * Per-device cache of sysfs attributes under /sys/dev/block/<major>:<minor>/.
+ *
+ * The filters, dev-type and device_id code each read the same few sysfs
+ * files (partition, dm/uuid, device/wwid, queue limits, ...) for every
+ * device, and each read used to be a separate open/read/close of a full
+ * path.  The first read of an attribute now saves its content (or the fact
+ * that it does not exist) on dev->sysfs_attrs, and later readers in the
+ * same command use the saved copy.  dev_sysfs_prefetch() reads a set of
+ * attributes in one pass with openat() relative to the device's sysfs dir.
+ *
+ * Entries are keyed by devt as well as name, so that attributes of a
+ * partition's primary dev can be cached on the partition.
+ * The saved values are dropped by dev_sysfs_invalidate(), and for all
+ * devices when the dev cache is rescanned.
+ */
+
+#define SYSFS_ATTR_MAX_SIZE 4096	/* sysfs attributes are at most one page */
+
+struct dev_sysfs_attr {
+	struct dm_list list;	/* dev->sysfs_attrs */
+	dev_t devt;
+	int exists;
+	int len;
+	char *name;
+	char value[0];
+};
+
+static struct dev_sysfs_attr *_sysfs_attr_find(struct device *dev, dev_t devt, const char *name)
+{
+	struct dev_sysfs_attr *sa;
+
+	dm_list_iterate_items(sa, &dev->sysfs_attrs)
+		if ((sa->devt == devt) && !strcmp(sa->name, name))
+			return sa;
+
+	return NULL;
+}
+
+/*
+ * Read attribute name of devt, relative to dir_fd when it's open,
+ * and save the result on dev.  Unexpected errors are not cached.
+ */
+static struct dev_sysfs_attr *_sysfs_attr_load(struct device *dev, int dir_fd,
+					       dev_t devt, const char *name)
+{
+	char path[PATH_MAX];
+	char buf[SYSFS_ATTR_MAX_SIZE];
+	struct dev_sysfs_attr *sa;
+	size_t name_size = strlen(name) + 1;
+	ssize_t len = 0;
+	int exists = 1;
+	int fd;
+
+	if (dir_fd >= 0)
+		fd = openat(dir_fd, name, O_RDONLY);
+	else {
+		if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/%s", dm_sysfs_dir(),
+				(int)MAJOR(devt), (int)MINOR(devt), name) < 0) {
+			log_warn("WARNING: sysfs path for %s attribute is too long.", name);
+			return NULL;
+		}
+		fd = open(path, O_RDONLY);
+	}
+
+	if (fd < 0) {
+		if ((errno != ENOENT) && (errno != ENOTDIR)) {
+			log_sys_debug("open", name);
+			return NULL;
+		}
+		exists = 0;
+	} else {
+		if ((len = read(fd, buf, sizeof(buf))) < 0) {
+			log_sys_debug("read", name);
+			len = 0;
+		}
+		if (close(fd))
+			log_sys_debug("close", name);
+	}
+
+	if (!(sa = malloc(sizeof(*sa) + len + name_size))) {
+		log_error("Failed to allocate sysfs attribute %s.", name);
+		return NULL;
+	}
+
+	sa->devt = devt;
+	sa->exists = exists;
+	sa->len = (int) len;
+	memcpy(sa->value, buf, len);
+	sa->name = sa->value + len;
+	memcpy(sa->name, name, name_size);
+	dm_list_add(&dev->sysfs_attrs, &sa->list);
+
+	return sa;
+}
+
+static struct dev_sysfs_attr *_sysfs_attr_get(struct device *dev, dev_t devt, const char *name)
+{
+	struct dev_sysfs_attr *sa;
+	const char *sysfs_dir = dm_sysfs_dir();
+
+	if (!sysfs_dir || !*sysfs_dir)
+		return NULL;
+
+	if ((sa = _sysfs_attr_find(dev, devt, name)))
+		return sa;
+
+	return _sysfs_attr_load(dev, -1, devt, name);
+}
+
+int dev_sysfs_attr_exists(struct device *dev, dev_t devt, const char *name)
+{
+	struct dev_sysfs_attr *sa;
+
+	if (!(sa = _sysfs_attr_get(dev, devt, name)))
+		return 0;
+
+	return sa->exists;
+}
+
+/*
+ * Same result as get_sysfs_value(): the first line of the
+ * attribute without the trailing newline.
+ */
+int dev_sysfs_get_value(struct device *dev, dev_t devt, const char *name,
+			char *buf, size_t buf_size)
+{
+	struct dev_sysfs_attr *sa;
+	const char *nl;
+	size_t len;
+
+	if (!buf_size || !(sa = _sysfs_attr_get(dev, devt, name)) || !sa->len)
+		return 0;
+
+	len = sa->len;
+	if ((nl = memchr(sa->value, '\n', len)))
+		len = nl - sa->value;
+	if (len > buf_size - 1)
+		len = buf_size - 1;
+
+	memcpy(buf, sa->value, len);
+	buf[len] = '\0';
+
+	return 1;
+}
+
+int dev_sysfs_get_binary(struct device *dev, dev_t devt, const char *name,
+			 char *buf, size_t buf_size, int *retlen)
+{
+	struct dev_sysfs_attr *sa;
+	size_t len;
+
+	if (!(sa = _sysfs_attr_get(dev, devt, name)) || !sa->len)
+		return 0;
+
+	len = ((size_t) sa->len < buf_size) ? (size_t) sa->len : buf_size;
+	memcpy(buf, sa->value, len);
+	*retlen = (int) len;
+
+	return 1;
+}
+
+/*
+ * Read the listed attributes of dev that are not yet cached,
+ * using a single open of the device's sysfs directory.
+ */
+void dev_sysfs_prefetch(struct device *dev, const char * const *names)
+{
+	char path[PATH_MAX];
+	const char *sysfs_dir = dm_sysfs_dir();
+	int dir_fd = -1;
+
+	if (!sysfs_dir || !*sysfs_dir)
+		return;
+
+	for (; *names; names++) {
+		if (_sysfs_attr_find(dev, dev->dev, *names))
+			continue;
+
+		if (dir_fd < 0) {
+			if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d", sysfs_dir,
+					(int)MAJOR(dev->dev), (int)MINOR(dev->dev)) < 0) {
+				log_warn("WARNING: sysfs path for %s is too long.", dev_name(dev));
+				return;
+			}
+			if ((dir_fd = open(path, O_RDONLY | O_DIRECTORY)) < 0) {
+				log_sys_debug("open", path);
+				return;
+			}
+		}
+
+		(void) _sysfs_attr_load(dev, dir_fd, dev->dev, *names);
+	}
+
+	if ((dir_fd >= 0) && close(dir_fd))
+		log_sys_debug("close", path);
+}
+
+void dev_sysfs_invalidate(struct device *dev)
+{
+	struct dev_sysfs_attr *sa, *safe;
+
+	dm_list_iterate_items_safe(sa, safe, &dev->sysfs_attrs) {
+		dm_list_del(&sa->list);
+		free(sa);
+	}
+}
+
+static void _sysfs_invalidate_btree(struct btree *t)
+{
+	struct btree_iter *iter;
+
+	if (!t)
+		return;
+
+	for (iter = btree_first(t); iter; iter = btree_next(iter))
+		dev_sysfs_invalidate((struct device *) btree_get_data(iter));
+}
+
+void dev_cache_sysfs_invalidate(void)
+{
+	_sysfs_invalidate_btree(_cache.devices);
+	_sysfs_invalidate_btree(_cache.sysfs_only_devices);
+}
+
 static struct dm_list *_get_or_add_list_by_index_key(struct dm_hash_table *idx, const char *key)
 {
 	struct dm_list *list;
@@ -893,6 +1121,118 @@ static int _insert_dir(const char *dir)
 	return r;
 }
 
+/*
+ * Populate the dev dir entries from /sys/dev/block instead of walking
+ * the directory.  Each devno gets only its kernel name (and the dm name
+ * for device-mapper devices), so no stat() is done for the many
+ * /dev/disk/by-* and other symlinks.  Further names given by the user
+ * are added as aliases when they are looked up with dev_cache_get().
+ */
+static int _insert_sysfs_block_devs(void)
+{
+	char sysfs_path[PATH_MAX];
+	char link[PATH_MAX];
+	char path[PATH_MAX];
+	char dm_name[NAME_LEN];
+	DIR *d;
+	struct dirent *dirent;
+	struct stat info;
+	const char *kname;
+	char *p;
+	ssize_t len;
+	int major, minor;
+	dev_t devno;
+	int r = 1;
+
+	if (dm_snprintf(sysfs_path, sizeof(sysfs_path), "%sdev/block", dm_sysfs_dir()) < 0)
+		return_0;
+
+	if (!(d = opendir(sysfs_path))) {
+		log_sys_debug("opendir", sysfs_path);
+		return 0;
+	}
+
+	while ((dirent = readdir(d))) {
+		if (dirent->d_name[0] == '.')
+			continue;
+
+		if (sscanf(dirent->d_name, "%d:%d", &major, &minor) != 2)
+			continue;
+
+		devno = MKDEV(major, minor);
+
+		/* 8:0 -> ../../devices/.../block/sda */
+		if ((len = readlinkat(dirfd(d), dirent->d_name, link, sizeof(link) - 1)) < 0) {
+			log_sys_very_verbose("readlink", dirent->d_name);
+			r = 0;
+			continue;
+		}
+		link[len] = '\0';
+		kname = (p = strrchr(link, '/')) ? p + 1 : link;
+
+		if (dm_snprintf(path, sizeof(path), "%s%s", _cache.dev_dir, kname) < 0) {
+			log_debug_devs("Path %s%s is too long.", _cache.dev_dir, kname);
+			r = 0;
+			continue;
+		}
+
+		/* Kernel names like cciss!c0d0 have nodes in a subdirectory. */
+		for (p = path + strlen(_cache.dev_dir); *p; p++)
+			if (*p == '!')
+				*p = '/';
+
+		if (stat(path, &info) < 0) {
+			log_sys_very_verbose("stat", path);
+			continue;
+		}
+
+		if (!S_ISBLK(info.st_mode) || (info.st_rdev != devno)) {
+			log_debug_devs("%s: Not the block device %d:%d.", path, major, minor);
+			continue;
+		}
+
+		if (!_insert_dev(path, devno)) {
+			r = 0;
+			continue;
+		}
+
+		if (!dm_is_dm_major(major) ||
+		    !dm_device_get_name(major, minor, 0, dm_name, sizeof(dm_name)) ||
+		    (dm_snprintf(path, sizeof(path), "%s/%s", dm_dir(), dm_name) < 0))
+			continue;
+
+		if (!stat(path, &info) && (info.st_rdev == devno))
+			r &= _insert_dev(path, devno);
+	}
+
+	if (closedir(d))
+		log_sys_debug("closedir", sysfs_path);
+
+	_cache.sysfs_block_scanned = 1;
+
+	return r;
+}
+
+/*
+ * Only the dev dir itself can be populated from sysfs,
+ * other scan directories are walked.
+ */
+static int _insert_dir_or_sysfs(const char *dir)
+{
+	size_t len = strlen(dir);
+
+	while (len > 1 && dir[len - 1] == '/')
+		len--;
+
+	if (obtain_device_list_from_sysfs() &&
+	    !strncmp(dir, _cache.dev_dir, len) &&
+	    (!_cache.dev_dir[len] || !strcmp(_cache.dev_dir + len, "/")) &&
+	    _insert_sysfs_block_devs())
+		return 1;
+
+	return _insert_dir(dir);
+}
+
 static int _dev_cache_iterate_devs_for_index(void)
 {
 	struct btree_iter *iter = btree_first(_cache.devices);
@@ -1100,7 +1440,7 @@ static void _insert_dirs(struct dm_list *dirs)
 					       "udev-managed directory to device "
 					       "cache fully", dl->dir);
 		}
-		else if (!_insert_dir(dl->dir))
+		else if (!_insert_dir_or_sysfs(dl->dir))
 			log_debug_devs("%s: Failed to insert devices to "
 				       "device cache fully", dl->dir);
 	}
@@ -1125,7 +1465,7 @@ static void _insert_dirs(struct dm_list *dirs)
 			continue;
 		}
 		_cache.st_dev = tinfo.st_dev;
-		_insert_dir(dl->dir);
+		_insert_dir_or_sysfs(dl->dir);
 	}
 }
 
@@ -1196,6 +1536,8 @@ void dev_cache_scan(struct cmd_context *cmd)
 
 	_cache.has_scanned = 1;
 
+	dev_cache_sysfs_invalidate();
+
 	_insert_dirs(&_cache.dirs);
 
 	if (cmd->check_devs_used)
@@ -1357,6 +1699,8 @@ int dev_cache_exit(void)
 		}
 	}
 
+	dev_cache_sysfs_invalidate();
+
 	if (_cache.mem)
 		dm_pool_destroy(_cache.mem);
 
@@ -1553,7 +1897,12 @@ static struct device *_dev_cache_get(struct cmd_context *cmd, const char *name,
 		return NULL;
 	}
 
-	if (!dev && existing)
+	/*
+	 * Symlinks were not collected when dev-cache was populated from
+	 * sysfs, so an existing device may be named by a new path.
+	 */
+	if (!dev && existing &&
+	    !(_cache.sysfs_block_scanned && btree_lookup(_cache.devices, (uint32_t) st.st_rdev)))
 		return_NULL;
 
 	/*
@@ -1585,7 +1934,17 @@ static struct device *_dev_cache_get(struct cmd_context *cmd, const char *name,
 		 * could end up using the wrong dm device.
 		 */
 		struct device *dev_by_devt = (struct device *) btree_lookup(_cache.devices, (uint32_t) st.st_rdev);
-		if (dev_by_devt) {
+
+		/*
+		 * When dev-cache was populated from sysfs, symlinks were not
+		 * collected, so this is usually just another name for a known
+		 * device.  Keep the aliases that are still valid.
+		 */
+		if (dev_by_devt && _cache.sysfs_block_scanned) {
+			log_debug("Adding path %s for %d:%d.",
+				  name, (int)MAJOR(st.st_rdev), (int)(MINOR(st.st_rdev)));
+			dev_cache_verify_aliases(dev_by_devt);
+		} else if (dev_by_devt) {
 			log_debug("Dropping aliases for %d:%d before adding new path %s.",
 				  (int)MAJOR(st.st_rdev), (int)(MINOR(st.st_rdev)), name);
 			_drop_all_aliases(dev_by_devt);
@@ -1858,6 +2217,28 @@ int setup_devices_file(struct cmd_context *cmd)
 	return 1;
 }
 
+/*
+ * When dev-cache is populated from sysfs, symlinks are not collected,
+ * so names from the devices file or --devices that are symlinks (e.g.
+ * /dev/disk/by-id/...) would not match.  Look them up so that each is
+ * added as an alias of the device it refers to, as a full scan would.
+ */
+static void _add_use_devices_aliases(struct cmd_context *cmd)
+{
+	struct dev_use *du;
+
+	if (!_cache.sysfs_block_scanned)
+		return;
+
+	dm_list_iterate_items(du, &cmd->use_devices) {
+		if (du->devname)
+			(void) dev_cache_get_existing(cmd, du->devname, NULL);
+		if ((du->idtype == DEV_ID_TYPE_DEVNAME) && du->idname &&
+		    (!du->devname || strcmp(du->idname, du->devname)))
+			(void) dev_cache_get_existing(cmd, du->idname, NULL);
+	}
+}
+
 /*
  * Add all system devices to dev-cache, and attempt to
  * match all devices_file entries to dev-cache entries.
@@ -1997,6 +2378,8 @@ int setup_devices(struct cmd_context *cmd)
 	 */
 	dev_cache_scan(cmd);
 
+	_add_use_devices_aliases(cmd);
+
 	/*
 	 * Match entries from cmd->use_devices with device structs in dev-cache.
 	 */
@@ -77,6 +77,19 @@ int get_sysfs_value(const char *path, char *buf, size_t buf_size, int error_if_n
 int get_sysfs_binary(const char *path, char *buf, size_t buf_size, int *retlen);
 int get_dm_uuid_from_sysfs(char *buf, size_t buf_size, int major, int minor);
 
+/*
+ * Cached reads of /sys/dev/block/<major>:<minor>/<name> for devt,
+ * saved on dev until dev_sysfs_invalidate().
+ */
+int dev_sysfs_attr_exists(struct device *dev, dev_t devt, const char *name);
+int dev_sysfs_get_value(struct device *dev, dev_t devt, const char *name,
+			char *buf, size_t buf_size);
+int dev_sysfs_get_binary(struct device *dev, dev_t devt, const char *name,
+			 char *buf, size_t buf_size, int *retlen);
+void dev_sysfs_prefetch(struct device *dev, const char * const *names);
+void dev_sysfs_invalidate(struct device *dev);
+void dev_cache_sysfs_invalidate(void);
+
 int setup_devices_file(struct cmd_context *cmd);
 int setup_devices(struct cmd_context *cmd);
 int setup_device(struct cmd_context *cmd, const char *devname);
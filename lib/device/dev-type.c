@@ -52,31 +52,12 @@ int dev_is_nvme(struct dev_types *dt, struct device *dev)
 
 int dev_is_lv(struct device *dev)
 {
-	FILE *fp;
-	char path[PATH_MAX];
 	char buffer[64];
-	int ret = 0;
-
-	if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/dm/uuid",
-			dm_sysfs_dir(),
-			(int) MAJOR(dev->dev),
-			(int) MINOR(dev->dev)) < 0) {
-		log_warn("Sysfs dm uuid path for %s is too long.", dev_name(dev));
-		return 0;
-	}
 
-	if (!(fp = fopen(path, "r")))
+	if (!dev_sysfs_get_value(dev, dev->dev, "dm/uuid", buffer, sizeof(buffer)))
 		return 0;
 
-	if (!fgets(buffer, sizeof(buffer), fp))
-		log_debug("Failed to read %s.", path);
-	else if (!strncmp(buffer, "LVM-", 4))
-		ret = 1;
-
-	if (fclose(fp))
-		log_sys_debug("fclose", path);
-
-	return ret;
+	return !strncmp(buffer, "LVM-", 4) ? 1 : 0;
 }
 
 int dev_is_used_by_active_lv(struct cmd_context *cmd, struct device *dev, int *used_by_lv_count,
@@ -454,60 +435,36 @@ int major_is_scsi_device(struct dev_types *dt, int major)
 
 static int _loop_is_with_partscan(struct device *dev)
 {
-	FILE *fp;
 	int partscan = 0;
-	char path[PATH_MAX];
 	char buffer[64];
 
-	if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/loop/partscan",
-			dm_sysfs_dir(),
-			(int) MAJOR(dev->dev),
-			(int) MINOR(dev->dev)) < 0) {
-		log_warn("Sysfs path for partscan is too long.");
-		return 0;
-	}
-
-	if (!(fp = fopen(path, "r")))
+	if (!dev_sysfs_get_value(dev, dev->dev, "loop/partscan", buffer, sizeof(buffer)))
 		return 0; /* not there -> no partscan */
 
-	if (!fgets(buffer, sizeof(buffer), fp)) {
-		log_warn("Failed to read %s.", path);
-	} else if (sscanf(buffer, "%d", &partscan) != 1) {
-		log_warn("Failed to parse %s '%s'.", path, buffer);
+	if (sscanf(buffer, "%d", &partscan) != 1) {
+		log_warn("Failed to parse %s loop/partscan '%s'.", dev_name(dev), buffer);
 		partscan = 0;
 	}
 
-	if (fclose(fp))
-		log_sys_debug("fclose", path);
-
 	return partscan;
 }
 
 int dev_get_partition_number(struct device *dev, int *num)
 {
-	char path[PATH_MAX];
 	char buf[8] = { 0 };
-	dev_t devt = dev->dev;
-	struct stat sb;
 
 	if (dev->part != -1) {
 		*num = dev->part;
 		return 1;
 	}
 
-	if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/partition",
-			dm_sysfs_dir(), (int)MAJOR(devt), (int)MINOR(devt)) < 0) {
-		log_error("Failed to create sysfs path for %s", dev_name(dev));
-		return 0;
-	}
-
-	if (stat(path, &sb)) {
+	if (!dev_sysfs_attr_exists(dev, dev->dev, "partition")) {
 		dev->part = 0;
 		*num = 0;
 		return 1;
 	}
 
-	if (!get_sysfs_value(path, buf, sizeof(buf), 0)) {
+	if (!dev_sysfs_get_value(dev, dev->dev, "partition", buf, sizeof(buf))) {
 		log_error("Failed to read sysfs path for %s", dev_name(dev));
 		return 0;
 	}
@@ -542,24 +499,8 @@ struct partition {
 
 static int _has_sys_partition(struct device *dev)
 {
-	char path[PATH_MAX];
-	struct stat info;
-	int major = (int) MAJOR(dev->dev);
-	int minor = (int) MINOR(dev->dev);
-
 	/* check if dev is a partition */
-	if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/partition",
-			dm_sysfs_dir(), major, minor) < 0) {
-		log_warn("WARNING: %s: partition path is too long.", dev_name(dev));
-		return 0;
-	}
-
-	if (stat(path, &info) == -1) {
-		if (errno != ENOENT)
-			log_sys_debug("stat", path);
-		return 0;
-	}
-	return 1;
+	return dev_sysfs_attr_exists(dev, dev->dev, "partition");
 }
 
 static int _is_partitionable(struct dev_types *dt, struct device *dev)
@@ -1209,81 +1150,44 @@ int wipe_known_signatures(struct cmd_context *cmd, struct device *dev,
 
 #ifdef __linux__
 
-static int _snprintf_attr(char *buf, size_t buf_size, const char *sysfs_dir,
-			 const char *attribute, dev_t dev)
-{
-	if (dm_snprintf(buf, buf_size, "%sdev/block/%d:%d/%s", sysfs_dir,
-			(int)MAJOR(dev), (int)MINOR(dev),
-			attribute) < 0) {
-		log_warn("WARNING: sysfs path for %s attribute is too long.", attribute);
-		return 0;
-	}
-
-	return 1;
-}
-
 static int _dev_sysfs_block_attribute(struct dev_types *dt,
 				      const char *attribute,
 				      struct device *dev,
 				      unsigned long *value)
 {
-	const char *sysfs_dir = dm_sysfs_dir();
-	char path[PATH_MAX], buffer[64];
-	FILE *fp;
+	char buffer[64];
 	dev_t primary = 0;
-	int ret = 0;
 
 	if (!attribute || !*attribute)
-		goto_out;
-
-	if (!sysfs_dir || !*sysfs_dir)
-		goto_out;
-
-	if (!_snprintf_attr(path, sizeof(path), sysfs_dir, attribute, dev->dev))
-		goto_out;
+		return_0;
 
 	/*
 	 * check if the desired sysfs attribute exists
 	 * - if not: either the kernel doesn't have topology support
 	 *   or the device could be a partition
 	 */
-	if (!(fp = fopen(path, "r"))) {
-		if (errno != ENOENT) {
-			log_sys_debug("fopen", path);
-			goto out;
-		}
+	if (!dev_sysfs_attr_exists(dev, dev->dev, attribute)) {
 		if (!dev_get_primary_dev(dt, dev, &primary))
-			goto out;
+			return 0;
 
 		/* get attribute from partition's primary device */
-		if (!_snprintf_attr(path, sizeof(path), sysfs_dir, attribute, primary))
-			goto_out;
-
-		if (!(fp = fopen(path, "r"))) {
-			if (errno != ENOENT)
-				log_sys_debug("fopen", path);
-			goto out;
-		}
-	}
+		if (!dev_sysfs_attr_exists(dev, primary, attribute))
+			return 0;
+	} else
+		primary = dev->dev;
 
-	if (!fgets(buffer, sizeof(buffer), fp)) {
-		log_sys_debug("fgets", path);
-		goto out_close;
+	if (!dev_sysfs_get_value(dev, primary, attribute, buffer, sizeof(buffer))) {
+		log_debug("Failed to read sysfs attribute %s for %s.", attribute, dev_name(dev));
+		return 0;
 	}
 
 	if (sscanf(buffer, "%lu", value) != 1) {
-		log_warn("WARNING: sysfs file %s not in expected format: %s", path, buffer);
-		goto out_close;
+		log_warn("WARNING: sysfs attribute %s for %s not in expected format: %s",
+			 attribute, dev_name(dev), buffer);
+		return 0;
 	}
 
-	ret = 1;
-
-out_close:
-	if (fclose(fp))
-		log_sys_debug("fclose", path);
-
-out:
-	return ret;
+	return 1;
 }
 
 static unsigned long _dev_topology_attribute(struct dev_types *dt,
@@ -116,6 +116,8 @@ struct dev_use {
 	char *idname;
 	char *devname;
 	char *pvid;
+	char *vgname;
+	char *vgid;
 };
 
 struct dev_use_list {
@@ -131,6 +133,7 @@ struct device {
 	struct dm_list aliases;	/* struct dm_str_list */
 	struct dm_list wwids; /* struct dev_wwid, used for multipath component detection */
 	struct dm_list ids; /* struct dev_id, different entries for different idtypes */
+	struct dm_list sysfs_attrs; /* struct dev_sysfs_attr, cached sysfs attribute values */
 	struct dev_id *id; /* points to the the ids entry being used for this dev */
 	dev_t dev;
 
@@ -19,6 +19,7 @@
 #include "lib/device/device_id.h"
 #include "lib/device/dev-type.h"
 #include "lib/label/label.h"
+#include "lib/label/hints.h"
 #include "lib/metadata/metadata.h"
 #include "lib/format_text/layout.h"
 #include "lib/cache/lvmcache.h"
@@ -34,7 +35,7 @@
 #include <sys/sysmacros.h>
 
 #define DEVICES_FILE_MAJOR 1
-#define DEVICES_FILE_MINOR 1
+#define DEVICES_FILE_MINOR 2
 #define VERSION_LINE_MAX 256
 
 static int _devices_fd = -1;
@@ -155,6 +156,8 @@ void free_du(struct dev_use *du)
 	free(du->idname);
 	free(du->devname);
 	free(du->pvid);
+	free(du->vgname);
+	free(du->vgid);
 	free(du);
 }
 
@@ -197,21 +200,26 @@ static int _read_sys_block(struct cmd_context *cmd, struct device *dev,
 
 	sysfs_dir = cmd->device_id_sysfs_dir ?: dm_sysfs_dir();
  retry:
-	if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/%s",
-			sysfs_dir, (int)MAJOR(devt), (int)MINOR(devt), suffix) < 0) {
+	if (!cmd->device_id_sysfs_dir) {
+		/* Use the values cached on dev by other readers. */
+		if (binary)
+			ret = dev_sysfs_get_binary(dev, devt, suffix, sysbuf, sysbufsize, retlen);
+		else
+			ret = dev_sysfs_get_value(dev, devt, suffix, sysbuf, sysbufsize);
+	} else if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d/%s",
+			       sysfs_dir, (int)MAJOR(devt), (int)MINOR(devt), suffix) < 0) {
 		log_error("Failed to create sysfs path for %s", dev_name(dev));
 		return 0;
-	}
+	} else if (binary)
+		ret = get_sysfs_binary(path, sysbuf, sysbufsize, retlen);
+	else
+		ret = get_sysfs_value(path, sysbuf, sysbufsize, 0);
 
 	if (binary) {
-		ret = get_sysfs_binary(path, sysbuf, sysbufsize, retlen);
 		if (ret && !*retlen)
 			ret = 0;
-	} else {
-		ret = get_sysfs_value(path, sysbuf, sysbufsize, 0);
-		if (ret && !sysbuf[0])
-			ret = 0;
-	}
+	} else if (ret && !sysbuf[0])
+		ret = 0;
 
 	if (ret) {
 		sysbuf[sysbufsize - 1] = '\0';
@@ -807,7 +815,7 @@ int device_ids_read(struct cmd_context *cmd)
 {
 	char line[PATH_MAX];
 	char buf[PATH_MAX];
-	char *idtype, *idname, *devname, *pvid, *part;
+	char *idtype, *idname, *devname, *pvid, *part, *vgname, *vgid;
 	struct dev_use *du;
 	FILE *fp;
 	int line_error;
@@ -860,6 +868,8 @@ int device_ids_read(struct cmd_context *cmd)
 		devname = strstr(line, "DEVNAME");
 		pvid = strstr(line, "PVID");
 		part = strstr(line, "PART");
+		vgname = strstr(line, "VGNAME");
+		vgid = strstr(line, "VGID");
 		line_error = 0;
 
 		/* These two are the minimum required. */
@@ -903,6 +913,19 @@ int device_ids_read(struct cmd_context *cmd)
 				du->part = atoi(buf);
 		}
 
+		if (vgname && vgid) {
+			_copy_idline_str(vgname, buf, PATH_MAX);
+			if (buf[0] && (buf[0] != '.')) {
+				if (!(du->vgname = strdup(buf)))
+					line_error = 1;
+			}
+			_copy_idline_str(vgid, buf, PATH_MAX);
+			if (buf[0] && (buf[0] != '.')) {
+				if (!(du->vgid = strdup(buf)))
+					line_error = 1;
+			}
+		}
+
 		if (line_error) {
 			log_warn("WARNING: failed to process devices file entry.");
 			free_du(du);
@@ -928,6 +951,7 @@ int device_ids_write(struct cmd_context *cmd)
 	struct dev_use *du;
 	const char *devname;
 	const char *pvid;
+	char vgbuf[NAME_LEN + ID_LEN + 16];
 	uint32_t df_major = 0, df_minor = 0, df_counter = 0;
 	int file_exists;
 	int ret = 1;
@@ -1047,14 +1071,19 @@ int device_ids_write(struct cmd_context *cmd)
 		else
 			pvid = du->pvid;
 
+		vgbuf[0] = '\0';
+		if (du->vgname && du->vgid &&
+		    dm_snprintf(vgbuf, sizeof(vgbuf), " VGNAME=%s VGID=%s", du->vgname, du->vgid) < 0)
+			vgbuf[0] = '\0';
+
 		if (du->part) {
-			fprintf(fp, "IDTYPE=%s IDNAME=%s DEVNAME=%s PVID=%s PART=%d\n",
+			fprintf(fp, "IDTYPE=%s IDNAME=%s DEVNAME=%s PVID=%s PART=%d%s\n",
 				idtype_to_str(du->idtype) ?: ".",
-				du->idname ?: ".", devname, pvid, du->part);
+				du->idname ?: ".", devname, pvid, du->part, vgbuf);
 		} else {
-			fprintf(fp, "IDTYPE=%s IDNAME=%s DEVNAME=%s PVID=%s\n",
+			fprintf(fp, "IDTYPE=%s IDNAME=%s DEVNAME=%s PVID=%s%s\n",
 				idtype_to_str(du->idtype) ?: ".",
-				du->idname ?: ".", devname, pvid);
+				du->idname ?: ".", devname, pvid, vgbuf);
 		}
 	}
 
@@ -2174,6 +2203,52 @@ static void _get_devs_with_serial_numbers(struct cmd_context *cmd, struct dm_lis
  * use_devices entries from the devices file.
  */
 
+/*
+ * Set the VG of the PV on dev in the devices file entry, as found by the
+ * scan.  The VG of a PV without metadata areas is not known until the VG
+ * is read, so the entry is left unchanged for it.
+ */
+static int _update_du_vg(struct cmd_context *cmd, struct dev_use *du, struct device *dev)
+{
+	struct lvmcache_info *info;
+	const char *vgname = NULL;
+	const char *vgid = NULL;
+	char *vgname_dup = NULL;
+	char *vgid_dup = NULL;
+
+	if (dev->pvid[0] && (info = lvmcache_info_from_pvid(dev->pvid, dev, 0))) {
+		if (!lvmcache_mda_count(info))
+			return 0;
+		if ((vgname = lvmcache_vgname_from_info(info)) && !is_orphan_vg(vgname))
+			vgid = lvmcache_vgid_from_vgname(cmd, vgname);
+	}
+
+	if (!vgid)
+		vgname = NULL;
+
+	if (vgname && du->vgname && du->vgid &&
+	    !strcmp(vgname, du->vgname) && !strcmp(vgid, du->vgid))
+		return 0;
+
+	if (!vgname && !du->vgname && !du->vgid)
+		return 0;
+
+	if (vgname && (!(vgname_dup = strdup(vgname)) || !(vgid_dup = strdup(vgid)))) {
+		free(vgname_dup);
+		return 0;
+	}
+
+	log_debug("Device %s has VG %s (devices file %s)",
+		  dev_name(dev), vgname ?: "none", du->vgname ?: "none");
+
+	free(du->vgname);
+	free(du->vgid);
+	du->vgname = vgname_dup;
+	du->vgid = vgid_dup;
+
+	return 1;
+}
+
 void device_ids_validate(struct cmd_context *cmd, struct dm_list *scanned_devs,
 			 int *device_ids_invalid, int noupdate)
 {
@@ -2184,12 +2259,15 @@ void device_ids_validate(struct cmd_context *cmd, struct dm_list *scanned_devs,
 	char *tmpdup;
 	int checked = 0;
 	int update_file = 0;
+	int update_vg;
 
 	dm_list_init(&wrong_devs);
 
 	if (!cmd->enable_devices_file)
 		return;
 
+	update_vg = find_config_tree_bool(cmd, devices_devicesfile_vg_scan_CFG, NULL);
+
 	log_debug("validating devices file entries");
 
 	/*
@@ -2274,6 +2352,9 @@ void device_ids_validate(struct cmd_context *cmd, struct dm_list *scanned_devs,
 			}
 		}
 
+		if (update_vg && _update_du_vg(cmd, du, dev))
+			update_file = 1;
+
 		/*
 		 * Avoid thrashing changes to the devices file during
 		 * startup due to device names that are still being
@@ -2343,6 +2424,9 @@ void device_ids_validate(struct cmd_context *cmd, struct dm_list *scanned_devs,
 		if (dev->pvid[0] && !memcmp(dev->pvid, du->pvid, ID_LEN)) {
 			const char *devname = dev_name(dev);
 
+			if (update_vg && _update_du_vg(cmd, du, dev))
+				update_file = 1;
+
 			if (strcmp(devname, du->idname)) {
 				/* shouldn't happen since this was basis for match */
 				log_error("du for pvid %s unexpected idname %s mismatch dev %s",
@@ -2464,6 +2548,102 @@ void device_ids_validate(struct cmd_context *cmd, struct dm_list *scanned_devs,
 	}
 }
 
+/*
+ * When the command names a single VG, and the devices file records the VG
+ * of each PV (devicesfile_vg_scan), only the devices recorded for that VG,
+ * or with no VG recorded, need to be scanned.  Move those devs from devs_in
+ * to devs_out.  The result is checked after the scan by
+ * device_ids_vg_devs_valid(), and the other devs are scanned if it fails.
+ */
+int device_ids_vg_devs(struct cmd_context *cmd, struct dm_list *devs_in,
+		       struct dm_list *devs_out, char **vgname_out)
+{
+	struct device_list *devl, *devl2;
+	struct dev_use *du;
+	char *vgname = NULL;
+	int found = 0;
+
+	if (!cmd->enable_devices_file || !cmd->use_devicesfile_vgs)
+		return 0;
+
+	get_single_vgname_cmd_arg(cmd, NULL, &vgname);
+	if (!vgname)
+		return 0;
+
+	dm_list_iterate_items(du, &cmd->use_devices) {
+		if (du->dev && du->vgname && !strcmp(du->vgname, vgname))
+			found++;
+	}
+
+	if (!found) {
+		log_debug("Devices file has no entries for VG %s.", vgname);
+		free(vgname);
+		return 0;
+	}
+
+	dm_list_iterate_items_safe(devl, devl2, devs_in) {
+		if (!(du = get_du_for_dev(cmd, devl->dev)))
+			continue;
+		if (du->vgname && strcmp(du->vgname, vgname))
+			continue;
+		dm_list_del(&devl->list);
+		dm_list_add(devs_out, &devl->list);
+	}
+
+	log_debug("Devices file entries for VG %s select %d devs, skip %d.",
+		  vgname, dm_list_size(devs_out), dm_list_size(devs_in));
+
+	*vgname_out = vgname;
+	return 1;
+}
+
+/*
+ * Check that the devs selected by device_ids_vg_devs() were all
+ * read, still have the expected PVID and VG, and that every PV
+ * listed in the VG metadata has been found among them.
+ */
+int device_ids_vg_devs_valid(struct cmd_context *cmd, const char *vgname)
+{
+	struct lvmcache_vginfo *vginfo;
+	struct dev_use *du;
+	const char *vgid;
+
+	if (lvmcache_has_duplicate_devs() || lvmcache_found_duplicate_vgnames()) {
+		log_debug("Devices file VG scan not used with duplicates.");
+		return 0;
+	}
+
+	if (!(vginfo = lvmcache_vginfo_from_vgname(vgname, NULL)) ||
+	    !(vgid = lvmcache_vgid_from_vgname(cmd, vgname))) {
+		log_debug("Devices file VG scan found no VG %s.", vgname);
+		return 0;
+	}
+
+	dm_list_iterate_items(du, &cmd->use_devices) {
+		if (!du->dev || !du->vgname || strcmp(du->vgname, vgname))
+			continue;
+
+		if (du->dev->flags & DEV_SCAN_NOT_READ) {
+			log_debug("Devices file VG scan did not read %s.", dev_name(du->dev));
+			return 0;
+		}
+
+		if (!du->pvid || memcmp(du->dev->pvid, du->pvid, ID_LEN) ||
+		    !du->vgid || strcmp(du->vgid, vgid)) {
+			log_debug("Devices file VG scan found %s PVID %s VG %s changed.",
+				  dev_name(du->dev), du->pvid ?: ".", vgname);
+			return 0;
+		}
+	}
+
+	if (!lvmcache_vginfo_has_all_pvs(vginfo)) {
+		log_debug("Devices file VG scan did not find all PVs in VG %s.", vgname);
+		return 0;
+	}
+
+	return 1;
+}
+
 /*
  * Validate entries with suspect sys_serial values.  A sys_serial du (devices
  * file entry) matched a device with the same serial number, but the PVID did
@@ -494,7 +494,7 @@ do_vgs:
 
 do_lookup:
 	if (!stat(PVS_LOOKUP_DIR, &st))
-		return;
+		goto do_queue;
 
 	log_debug("Creating pvs_lookup_dir.");
 	dm_prepare_selinux_context(PVS_LOOKUP_DIR, S_IFDIR);
@@ -503,6 +503,19 @@ do_lookup:
 
 	if ((rv < 0) && stat(PVS_LOOKUP_DIR, &st))
 		log_error_pvscan(cmd, "Failed to create %s %d", PVS_LOOKUP_DIR, errno);
+
+do_queue:
+	if (!find_config_tree_bool(cmd, global_event_activation_batch_CFG, NULL) ||
+	    !stat(PVSCAN_QUEUE_DIR, &st))
+		return;
+
+	log_debug("Creating pvscan_queue_dir.");
+	dm_prepare_selinux_context(PVSCAN_QUEUE_DIR, S_IFDIR);
+	rv = mkdir(PVSCAN_QUEUE_DIR, 0755);
+	dm_prepare_selinux_context(NULL, 0);
+
+	if ((rv < 0) && stat(PVSCAN_QUEUE_DIR, &st))
+		log_error_pvscan(cmd, "Failed to create %s %d", PVSCAN_QUEUE_DIR, errno);
 }
 
 void online_lookup_file_remove(const char *vgname)
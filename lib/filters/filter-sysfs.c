@@ -14,11 +14,19 @@
 
 #include "lib/misc/lib.h"
 #include "lib/filters/filter.h"
+#include "lib/commands/toolcontext.h"
 
 static int _sys_dev_block_found;
 
 #ifdef __linux__
 
+/*
+ * Attributes read by later filters for most devices.  They are
+ * read here in one pass and cached on the dev for those filters.
+ */
+static const char * const _prefetch_attrs[] = { "partition", NULL };
+static const char * const _prefetch_dm_attrs[] = { "partition", "dm/uuid", NULL };
+
 static int _accept_p(struct cmd_context *cmd, struct dev_filter *f, struct device *dev, const char *use_filter_name)
 {
 	char path[PATH_MAX];
@@ -30,15 +38,15 @@ static int _accept_p(struct cmd_context *cmd, struct dev_filter *f, struct devic
 
 	dev->filtered_flags &= ~DEV_FILTERED_SYSFS;
 
+	sysfs_dir = dm_sysfs_dir();
+	if (!sysfs_dir || !*sysfs_dir)
+		return 1;
+
 	/*
 	 * Any kind of device id other than devname has been set
 	 * using sysfs so we know that sysfs info exists for dev.
 	 */
-	if (dev->id && dev->id->idtype && (dev->id->idtype != DEV_ID_TYPE_DEVNAME))
-		return 1;
-
-	sysfs_dir = dm_sysfs_dir();
-	if (sysfs_dir && *sysfs_dir) {
+	if (!dev->id || !dev->id->idtype || (dev->id->idtype == DEV_ID_TYPE_DEVNAME)) {
 		if (dm_snprintf(path, sizeof(path), "%sdev/block/%d:%d",
 				sysfs_dir, (int)MAJOR(dev->dev), (int)MINOR(dev->dev)) < 0) {
 			log_debug("failed to create sysfs path");
@@ -52,6 +60,9 @@ static int _accept_p(struct cmd_context *cmd, struct dev_filter *f, struct devic
 		}
 	}
 
+	dev_sysfs_prefetch(dev, (MAJOR(dev->dev) == cmd->dev_types->device_mapper_major) ?
+			   _prefetch_dm_attrs : _prefetch_attrs);
+
 	return 1;
 }
 
@@ -154,21 +154,40 @@ static int _read_flag_config(const struct dm_config_node *n, uint64_t *status, e
 	return 1;
 }
 
-static int _read_str_list(struct dm_pool *mem, struct dm_list *list, const struct dm_config_value *cv)
+/*
+ * Tags repeat across many LVs, so the strings are interned in the VG and
+ * the list nodes are allocated as a single array.
+ */
+static int _read_str_list(struct volume_group *vg, struct dm_list *list, const struct dm_config_value *cv)
 {
+	const struct dm_config_value *v;
+	struct dm_str_list *sl;
+	unsigned count = 0;
+
 	if (cv->type == DM_CFG_EMPTY_ARRAY)
 		return 1;
 
-	while (cv) {
-		if (cv->type != DM_CFG_STRING) {
+	for (v = cv; v; v = v->next) {
+		if (v->type != DM_CFG_STRING) {
 			log_error("Found an item that is not a string");
 			return 0;
 		}
+		count++;
+	}
 
-		if (!str_list_add(mem, list, dm_pool_strdup(mem, cv->v.str)))
+	if (!(sl = dm_pool_alloc(vg->vgmem, count * sizeof(*sl))))
+		return_0;
+
+	for (v = cv; v; v = v->next) {
+		/* Already in list? */
+		if (str_list_match_item(list, v->v.str))
+			continue;
+
+		if (!(sl->str = vg_intern_str(vg, v->v.str)))
 			return_0;
 
-		cv = cv->next;
+		dm_list_add(list, &sl->list);
+		sl++;
 	}
 
 	return 1;
@@ -282,7 +301,7 @@ static int _read_pv(struct cmd_context *cmd,
 
 	/* Optional tags */
 	if (dm_config_get_list(pvn, "tags", &cv) &&
-	    !(_read_str_list(mem, &pv->tags, cv))) {
+	    !(_read_str_list(vg, &pv->tags, cv))) {
 		log_error("Couldn't read tags for physical volume %s in %s.",
 			  pv_dev_name(pv), vg->name);
 		return 0;
@@ -455,7 +474,7 @@ static int _read_segment(struct cmd_context *cmd,
 
 	/* Optional tags */
 	if (dm_config_get_list(sn_child, "tags", &cv) &&
-	    !(_read_str_list(mem, &seg->tags, cv))) {
+	    !(_read_str_list(lv->vg, &seg->tags, cv))) {
 		log_error("Couldn't read tags for a segment of %s/%s.",
 			  lv->vg->name, lv->name);
 		return 0;
@@ -685,7 +704,9 @@ static int _read_lvnames(struct cmd_context *cmd,
 	 * the lock_args before using it to access the lock manager.
 	 */
 	if (dm_config_get_str(lvn, "lock_args", &str)) {
-		if (!(lv->lock_args = dm_pool_strdup(mem, str)))
+		/* Only the dlm value repeats, sanlock offsets are unique per LV. */
+		if (!(lv->lock_args = strcmp(str, "dlm") ? dm_pool_strdup(mem, str) :
+		      vg_intern_str(vg, str)))
 			return_0;
 	}
 
@@ -727,7 +748,7 @@ static int _read_lvnames(struct cmd_context *cmd,
 
 	/* Optional tags */
 	if (dm_config_get_list(lvn, "tags", &cv) &&
-	    !(_read_str_list(mem, &lv->tags, cv))) {
+	    !(_read_str_list(vg, &lv->tags, cv))) {
 		log_error("Couldn't read tags for logical volume %s.",
 			  display_lvname(lv));
 		return 0;
@@ -1044,6 +1065,18 @@ static int _read_sections(struct cmd_context *cmd,
 	return 1;
 }
 
+static unsigned _count_lvs(const struct dm_config_node *vgn)
+{
+	const struct dm_config_node *n;
+	unsigned count = 0;
+
+	if (dm_config_get_section(vgn, "logical_volumes", &n))
+		for (n = n->child; n; n = n->sib)
+			count++;
+
+	return count;
+}
+
 static struct volume_group *_read_vg(struct cmd_context *cmd,
 				     const struct format_type *fmt,
 				     struct format_instance *fid,
@@ -1056,6 +1089,7 @@ static struct volume_group *_read_vg(struct cmd_context *cmd,
 	struct volume_group *vg;
 	struct dm_hash_table *pv_hash = NULL, *lv_hash = NULL;
 	uint64_t vgstatus;
+	unsigned nr_lvs;
 
 	/* skip any top-level values */
 	for (vgn = cft->root; (vgn && vgn->v); vgn = vgn->sib)
@@ -1066,7 +1100,9 @@ static struct volume_group *_read_vg(struct cmd_context *cmd,
 		return NULL;
 	}
 
-	if (!(vg = alloc_vg("read_vg", cmd, vgn->key)))
+	nr_lvs = _count_lvs(vgn->child);
+
+	if (!(vg = alloc_vg("read_vg", cmd, vgn->key, nr_lvs)))
 		return_NULL;
 
 	mem = vg->vgmem;
@@ -1084,7 +1120,7 @@ static struct volume_group *_read_vg(struct cmd_context *cmd,
 	 * The lv hash memorises the lv section names -> lv
 	 * structures.
 	 */
-	if (!(lv_hash = dm_hash_create(1023))) {
+	if (!(lv_hash = dm_hash_create(max(nr_lvs, 1023U)))) {
 		log_error("Couldn't create lv hash table.");
 		goto bad;
 	}
@@ -1212,7 +1248,7 @@ static struct volume_group *_read_vg(struct cmd_context *cmd,
 
 	/* Optional tags */
 	if (dm_config_get_list(vgn, "tags", &cv) &&
-	    !(_read_str_list(mem, &vg->tags, cv))) {
+	    !(_read_str_list(vg, &vg->tags, cv))) {
 		log_error("Couldn't read tags for volume group %s.", vg->name);
 		goto bad;
 	}
@@ -1242,6 +1242,7 @@ int label_scan(struct cmd_context *cmd)
 	struct device_list *devl, *devl2;
 	struct device *dev;
 	uint64_t max_metadata_size_bytes;
+	char *vg_devs_name = NULL;
 	int device_ids_invalid = 0;
 	int using_hints;
 	int create_hints = 0; /* NEWHINTS_NONE */
@@ -1363,9 +1364,16 @@ int label_scan(struct cmd_context *cmd)
 	 * apply to more cases.)
 	 */
 	if (!get_hints(cmd, &hints_list, &create_hints, &all_devs, &scan_devs)) {
-		dm_list_splice(&scan_devs, &all_devs);
 		dm_list_init(&hints_list);
 		using_hints = 0;
+
+		/*
+		 * Without hints, a command using a single VG may still limit
+		 * the scan to the devices file entries recorded for that VG.
+		 * Not when new hints are to be created from a full scan.
+		 */
+		if (create_hints || !device_ids_vg_devs(cmd, &all_devs, &scan_devs, &vg_devs_name))
+			dm_list_splice(&scan_devs, &all_devs);
 	} else
 		using_hints = 1;
 
@@ -1439,6 +1447,15 @@ int label_scan(struct cmd_context *cmd)
 
 	free_hints(&hints_list);
 
+	if (vg_devs_name) {
+		if (!device_ids_vg_devs_valid(cmd, vg_devs_name)) {
+			log_debug("Will scan %d remaining devices", dm_list_size(&all_devs));
+			_scan_list(cmd, cmd->filter, &all_devs, 0, NULL);
+			dm_list_splice(&scan_devs, &all_devs);
+		}
+		free(vg_devs_name);
+	}
+
 	/*
 	 * Check if the devices_file content is up to date and
 	 * if not update it.
@@ -1914,8 +1931,134 @@ bool dev_read_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 
 }
 
+/*
+ * Devices written while a write batch is active.  Their writes
+ * are left dirty in bcache (along with the last byte limit of
+ * each device) until the batch is ended with a single flush.
+ */
+struct batch_dev {
+	struct device *dev;
+	int di;
+	int failed;
+};
+
+static struct batch_dev *_batch_devs;
+static int _batch_devs_count;
+static int _batch_devs_alloc;
+static int _batch_active;
+
+static struct batch_dev *_batch_find(struct device *dev)
+{
+	int i;
+
+	for (i = 0; i < _batch_devs_count; i++)
+		if (_batch_devs[i].dev == dev)
+			return &_batch_devs[i];
+
+	return NULL;
+}
+
+static int _batch_add(struct device *dev)
+{
+	struct batch_dev *bd;
+
+	if ((bd = _batch_find(dev)))
+		return 1;
+
+	if (_batch_devs_count == _batch_devs_alloc) {
+		int alloc = _batch_devs_alloc ? (2 * _batch_devs_alloc) : 16;
+
+		if (!(bd = realloc(_batch_devs, alloc * sizeof(*bd)))) {
+			log_error("Failed to allocate write batch.");
+			return 0;
+		}
+		_batch_devs = bd;
+		_batch_devs_alloc = alloc;
+	}
+
+	bd = &_batch_devs[_batch_devs_count++];
+	bd->dev = dev;
+	bd->di = dev->bcache_di;
+	bd->failed = 0;
+
+	return 1;
+}
+
+/*
+ * After a failed flush, find the batched devices still holding
+ * errored blocks and drop them from bcache as dev_write_bytes()
+ * does for an unbatched write.
+ */
+static void _batch_check_errors(void)
+{
+	int i;
+
+	for (i = 0; i < _batch_devs_count; i++) {
+		if (_batch_devs[i].failed ||
+		    !bcache_has_errors(scan_bcache, _batch_devs[i].di))
+			continue;
+
+		log_error("Error writing device %s.", dev_name(_batch_devs[i].dev));
+		_batch_devs[i].failed = 1;
+		label_scan_invalidate(_batch_devs[i].dev);
+		bcache_unset_last_byte(scan_bcache, _batch_devs[i].di);
+	}
+}
+
+void dev_write_batch_begin(void)
+{
+	if (_batch_active)
+		log_error(INTERNAL_ERROR "Write batch is already active.");
+
+	_batch_active = 1;
+	_batch_devs_count = 0;
+}
+
+bool dev_write_batch_end(void)
+{
+	bool r = true;
+	int i;
+
+	if (!_batch_active) {
+		log_error(INTERNAL_ERROR "No active write batch.");
+		return false;
+	}
+
+	_batch_active = 0;
+
+	if (!_batch_devs_count)
+		return true;
+
+	log_debug_devs("Flushing write batch of %d devices.", _batch_devs_count);
+
+	if (!bcache_flush(scan_bcache))
+		_batch_check_errors();
+
+	for (i = 0; i < _batch_devs_count; i++) {
+		if (_batch_devs[i].failed) {
+			r = false;
+			continue;
+		}
+		bcache_unset_last_byte(scan_bcache, _batch_devs[i].di);
+	}
+
+	return r;
+}
+
+bool dev_write_batch_failed(struct device *dev)
+{
+	struct batch_dev *bd;
+
+	if (!(bd = _batch_find(dev)))
+		return false;
+
+	return bd->failed ? true : false;
+}
+
 bool dev_write_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 {
+	struct batch_dev *bd;
+
 	if (test_mode())
 		return true;
 
@@ -1948,11 +2091,17 @@ bool dev_write_bytes(struct device *dev, uint64_t start, size_t len, void *data)
 	if (!bcache_write_bytes(scan_bcache, dev->bcache_di, start, len, data)) {
 		log_error("Error writing device %s at %llu length %u.",
 			  dev_name(dev), (unsigned long long)start, (uint32_t)len);
+		if (_batch_active && (bd = _batch_find(dev)))
+			bd->failed = 1;
 		dev_unset_last_byte(dev);
 		label_scan_invalidate(dev);
 		return false;
 	}
 
+	/* The batch is flushed by dev_write_batch_end(). */
+	if (_batch_active)
+		return _batch_add(dev) ? true : false;
+
 	if (!bcache_flush(scan_bcache)) {
 		log_error("Error writing device %s at %llu length %u.",
 			  dev_name(dev), (unsigned long long)start, (uint32_t)len);
@@ -2040,6 +2189,19 @@ void dev_set_last_byte(struct device *dev, uint64_t offset)
 	unsigned int physical_block_size = 0;
 	unsigned int logical_block_size = 0;
 	unsigned int bs;
+	uint64_t cur;
+
+	/*
+	 * A batched write still waiting for the flush may be clamped by
+	 * the current limit of this device, so flush it before the limit
+	 * is changed.
+	 */
+	if (_batch_active && _batch_find(dev) &&
+	    (cur = bcache_get_last_byte(scan_bcache, dev->bcache_di)) && (cur != offset)) {
+		log_debug_devs("Flushing write batch to change last byte of %s.", dev_name(dev));
+		if (!bcache_flush(scan_bcache))
+			_batch_check_errors();
+	}
 
 	if (!dev_get_direct_block_sizes(dev, &physical_block_size, &logical_block_size)) {
 		stack;
@@ -2069,5 +2231,9 @@ void dev_set_last_byte(struct device *dev, uint64_t offset)
 
 void dev_unset_last_byte(struct device *dev)
 {
+	/* The limit is kept for batched writes until the flush. */
+	if (_batch_active && _batch_find(dev))
+		return;
+
 	bcache_unset_last_byte(scan_bcache, dev->bcache_di);
 }
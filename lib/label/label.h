@@ -138,6 +138,16 @@ void dev_invalidate(struct device *dev);
 void dev_set_last_byte(struct device *dev, uint64_t offset);
 void dev_unset_last_byte(struct device *dev);
 
+/*
+ * Writes made between dev_write_batch_begin() and dev_write_batch_end()
+ * are queued in bcache and issued together by the single flush done in
+ * dev_write_batch_end(), which returns false if any of them failed.
+ * dev_write_batch_failed() then reports the devices whose writes failed.
+ */
+void dev_write_batch_begin(void);
+bool dev_write_batch_end(void);
+bool dev_write_batch_failed(struct device *dev);
+
 void prepare_open_file_limit(struct cmd_context *cmd, unsigned int num_devs);
 
 #endif
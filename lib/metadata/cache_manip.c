@@ -145,6 +145,7 @@ int cache_set_cache_mode(struct lv_segment *seg, cache_mode_t mode)
 		return 0;
 	}
 
+	lv_set_changed(setting_seg->lv);
 	if (mode != CACHE_MODE_UNSELECTED) {
 		setting_seg->cache_mode = mode;
 		return 1;
@@ -153,6 +154,7 @@ int cache_set_cache_mode(struct lv_segment *seg, cache_mode_t mode)
 	if (setting_seg->cache_mode != CACHE_MODE_UNSELECTED)
 		return 1;
 
+	lv_set_changed(setting_seg->lv);
 	setting_seg->cache_mode = _get_cache_mode_from_config(cmd, seg->lv->profile, seg->lv);
 
 	return 1;
@@ -679,6 +681,7 @@ int lv_cache_remove(struct logical_volume *cache_lv)
 		cache_seg->metadata_id = metadata_id;
 		cache_pool_lv->status |= LV_CACHE_VOL;
 		/* Unused settings set only for passing metadata validation. */
+		lv_set_changed(cache_seg->lv);
 		cache_seg->cache_mode = CACHE_MODE_WRITETHROUGH;
 		cache_seg->chunk_size = DM_CACHE_MAX_DATA_BLOCK_SIZE;
 		cache_seg->cache_metadata_format = CACHE_METADATA_FORMAT_2;
@@ -795,6 +798,7 @@ int cache_set_policy(struct lv_segment *lvseg, const char *name,
 		return 0;
 	}
 
+	lv_set_changed(seg->lv);
 	if (name) {
 		if (!(seg->policy_name = dm_pool_strdup(seg->lv->vg->vgmem, name))) {
 			log_error("Failed to duplicate policy name.");
@@ -906,6 +910,8 @@ int cache_set_metadata_format(struct lv_segment *seg, cache_metadata_format_t fo
 		return 0;
 	}
 
+	lv_set_changed(seg->lv);
+
 	/*
 	 * If policy is unselected, but format 2 is selected, policy smq is enforced.
 	 */
@@ -1004,6 +1010,7 @@ int cache_vol_set_params(struct cmd_context *cmd,
 	if (mode == CACHE_MODE_UNSELECTED)
 		mode = _get_cache_mode_from_config(cmd, profile, cache_lv);
 
+	lv_set_changed(cache_seg->lv);
 	cache_seg->cache_mode = mode;
 
 
@@ -1210,6 +1217,7 @@ int cache_set_params(struct lv_segment *seg,
 		if (seg_is_cache(seg) &&
 		    !validate_lv_cache_chunk_size(pool_seg->lv, chunk_size))
 			return_0;
+		lv_set_changed(pool_seg->lv);
 		pool_seg->chunk_size = chunk_size;
 	} else if (seg_is_cache(seg)) {
 		/* Chunk size in profile has priority over cache-pool chunk size */
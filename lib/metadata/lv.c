@@ -1497,15 +1497,8 @@ int lv_set_creation(struct logical_volume *lv,
 		hostname = _utsname.nodename;
 	}
 
-	if (!(hn = dm_hash_lookup(lv->vg->hostnames, hostname))) {
-		if (!(hn = dm_pool_strdup(lv->vg->vgmem, hostname))) {
-			log_error("Failed to duplicate hostname");
-			return 0;
-		}
-
-		if (!dm_hash_insert(lv->vg->hostnames, hostname, (void*)hn))
-			return_0;
-	}
+	if (!(hn = vg_intern_str(lv->vg, hostname)))
+		return_0;
 
 	lv->hostname = hn;
 	lv->timestamp = timestamp ? : (uint64_t) time(NULL);
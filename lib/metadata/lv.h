@@ -60,6 +60,16 @@ struct logical_volume {
 	unsigned to_remove:1; /* set when LV is known to be removed */
 	const char *hostname;
 	const char *lock_args;
+
+	/*
+	 * Set when the segments of the LV were last checked, and cleared
+	 * by lv_set_changed(), so that vg_validate() can skip LVs that did
+	 * not change since then.
+	 */
+	unsigned validated:1;
+	unsigned validate_changed:1;
+	unsigned validate_now:1;
+	uint64_t validated_status;
 };
 
 /*
@@ -860,6 +860,9 @@ int add_seg_to_segs_using_this_lv(struct logical_volume *lv,
 {
 	struct seg_list *sl;
 
+	lv_set_changed(lv);
+	lv_set_changed(seg->lv);
+
 	dm_list_iterate_items(sl, &lv->segs_using_this_lv) {
 		if (sl->seg == seg) {
 			sl->count++;
@@ -887,6 +890,9 @@ int remove_seg_from_segs_using_this_lv(struct logical_volume *lv,
 {
 	struct seg_list *sl;
 
+	lv_set_changed(lv);
+	lv_set_changed(seg->lv);
+
 	dm_list_iterate_items(sl, &lv->segs_using_this_lv) {
 		if (sl->seg != seg)
 			continue;
@@ -1090,6 +1096,8 @@ struct lv_segment *alloc_lv_segment(const struct segment_type *segtype,
 	dm_list_init(&seg->origin_list);
 	dm_list_init(&seg->thin_messages);
 
+	lv_set_changed(lv);
+
 	if (log_lv && !attach_mirror_log(seg, log_lv))
 		return_NULL;
 
@@ -1252,6 +1260,8 @@ int release_and_discard_lv_segment_area(struct lv_segment *seg, uint32_t s, uint
 
 int release_lv_segment_area(struct lv_segment *seg, uint32_t s, uint32_t area_reduction)
 {
+	lv_set_changed(seg->lv);
+
 	return _release_and_discard_lv_segment_area(seg, s, area_reduction, 0);
 }
 
@@ -1310,6 +1320,8 @@ int move_lv_segment_area(struct lv_segment *seg_to, uint32_t area_to,
 int set_lv_segment_area_pv(struct lv_segment *seg, uint32_t area_num,
 			   struct physical_volume *pv, uint32_t pe)
 {
+	lv_set_changed(seg->lv);
+
 	seg->areas[area_num].type = AREA_PV;
 
 	if (!(seg_pvseg(seg, area_num) =
@@ -1335,6 +1347,7 @@ int set_lv_segment_area_lv(struct lv_segment *seg, uint32_t area_num,
 			  area_num, seg->area_count, display_lvname(seg->lv));
 		return 0;
 	}
+	lv_set_changed(seg->lv);
 	lv->status |= status;
 	if (lv_is_raid_metadata(lv)) {
 		seg->meta_areas[area_num].type = AREA_LV;
@@ -1373,6 +1386,7 @@ int add_lv_segment_areas(struct lv_segment *seg, uint32_t new_area_count)
 	if (seg->area_count)
 		memcpy(newareas, seg->areas, seg->area_count * sizeof(*seg->areas));
 
+	lv_set_changed(seg->lv);
 	seg->areas = newareas;
 	seg->area_count = new_area_count;
 
@@ -1448,6 +1462,7 @@ static int _lv_segment_reduce(struct lv_segment *seg, uint32_t reduction)
 		if (!release_and_discard_lv_segment_area(seg, s, area_reduction))
 			return_0;
 
+	lv_set_changed(seg->lv);
 	seg->len -= reduction;
 
 	if (seg_is_raid(seg))
@@ -1507,6 +1522,7 @@ static int _setup_lv_size(struct logical_volume *lv, uint32_t extents)
 {
 	struct lv_segment *seg;
 
+	lv_set_changed(lv);
 	lv->le_count = extents;
 	lv->size = (uint64_t) extents * lv->vg->extent_size;
 
@@ -1514,6 +1530,7 @@ static int _setup_lv_size(struct logical_volume *lv, uint32_t extents)
 		if (!(seg = get_only_segment_using_this_lv(lv)))
 			return_0;
 
+		lv_set_changed(seg->lv);
 		seg->lv->le_count =
 			seg->len =
 			seg->area_len = lv->le_count;
@@ -1545,6 +1562,7 @@ static int _lv_reduce(struct logical_volume *lv, uint32_t extents, int delete)
 		data_copies = seg->data_copies;
 	}
 
+	lv_set_changed(lv);
 	if (lv_is_merging_origin(lv)) {
 		log_debug_metadata("Dropping snapshot merge of %s to removed origin %s.",
 				   find_snapshot(lv)->lv->name, lv->name);
@@ -3527,6 +3545,7 @@ static int _lv_add_vdo_segment(struct logical_volume *lv, uint64_t status,
 
 	if (!dm_list_empty(&lv->segments) &&
 	    (seg = last_seg(lv)) && (seg->segtype == segtype)) {
+		lv_set_changed(lv);
 		seg->area_len += extents;
 		seg->len += extents;
 	} else {
@@ -3560,6 +3579,7 @@ int lv_add_virtual_segment(struct logical_volume *lv, uint64_t status,
 
 	if (!dm_list_empty(&lv->segments) &&
 	    (seg = last_seg(lv)) && (seg->segtype == segtype)) {
+		lv_set_changed(lv);
 		seg->area_len += extents;
 		seg->len += extents;
 	} else {
@@ -4387,6 +4407,7 @@ static int _lv_extend_layered_lv(struct alloc_handle *ah,
 			}
 
 			/* new size in sectors */
+			lv_set_changed(lv_image);
 			lv_image->size = lv_iorig->size;
 			seg_image->integrity_data_sectors = lv_iorig->size;
 			/* new size in extents */
@@ -4396,6 +4417,7 @@ static int _lv_extend_layered_lv(struct alloc_handle *ah,
 		}
 	}
 
+	lv_set_changed(seg->lv);
 	seg->len += extents;
 	if (seg_is_raid(seg))
 		seg->area_len = seg->len;
@@ -4480,6 +4502,7 @@ int lv_extend(struct logical_volume *lv,
 	uint32_t new_extents;	/* Total logical size after extension. */
 	uint64_t raid_size;
 
+	lv_set_changed(lv);
 	log_very_verbose("Adding segment of type %s to LV %s.", segtype->name, lv->name);
 
 	if (segtype_is_virtual(segtype))
@@ -7383,6 +7406,18 @@ void lv_set_hidden(struct logical_volume *lv)
 	log_debug_metadata("LV %s in VG %s is now hidden.",  lv->name, lv->vg->name);
 }
 
+/*
+ * Mark LV as changed so the next vg_validate() checks its segments
+ * even when it only checks the LVs changed since the last check.
+ * Every function changing the segments, areas, size or segment
+ * settings of an LV must call this before the next vg_write().
+ */
+void lv_set_changed(struct logical_volume *lv)
+{
+	if (lv)
+		lv->validated = 0;
+}
+
 static int _lv_remove_check_in_use(struct logical_volume *lv, force_t force)
 {
 	struct volume_group *vg = lv->vg;
@@ -7570,6 +7605,7 @@ int lv_remove_single(struct cmd_context *cmd, struct logical_volume *lv,
 
 	/* Special case removing a striped raid LV with allocated reshape space */
 	if (seg && seg->reshape_len) {
+		lv_set_changed(lv);
 		if (!(seg->segtype = get_segtype_from_string(cmd, SEG_TYPE_NAME_STRIPED)))
 			return_0;
 		lv->le_count = seg->len = seg->area_len = seg_lv(seg, 0)->le_count * seg->area_count;
@@ -8053,6 +8089,7 @@ int remove_layers_for_segments(struct cmd_context *cmd,
 				return_0;
 
 			/* Replace mirror with error segment */
+			lv_set_changed(lseg->lv);
 			if (!(lseg->segtype =
 			      get_segtype_from_string(lv->vg->cmd, SEG_TYPE_NAME_ERROR))) {
 				log_error("Missing error segtype");
@@ -8125,6 +8162,8 @@ int move_lv_segments(struct logical_volume *lv_to,
 			return 0;
 		}
 
+	lv_set_changed(lv_to);
+	lv_set_changed(lv_from);
 	dm_list_init(&lv_to->segments);
 	dm_list_splice(&lv_to->segments, &lv_from->segments);
 
@@ -8349,6 +8388,7 @@ struct logical_volume *insert_layer_for_lv(struct cmd_context *cmd,
 		return_NULL;
 
 	/* add the new segment to the layer LV */
+	lv_set_changed(lv_where);
 	dm_list_add(&lv_where->segments, &mapseg->list);
 	lv_where->le_count = layer_lv->le_count;
 	lv_where->size = (uint64_t) lv_where->le_count * lv_where->vg->extent_size;
@@ -8408,6 +8448,7 @@ static int _extend_layer_lv_for_segment(struct logical_volume *layer_lv,
 		return_0;
 
 	/* add the new segment to the layer LV */
+	lv_set_changed(layer_lv);
 	dm_list_add(&layer_lv->segments, &mapseg->list);
 	layer_lv->le_count += seg->area_len;
 	layer_lv->size += (uint64_t) seg->area_len * layer_lv->vg->extent_size;
@@ -54,6 +54,8 @@ int lv_merge_segments(struct logical_volume *lv)
 	    (lv_is_locked(seg->lv) || lv_is_pvmove(seg->lv)))
 		return 1;
 
+	lv_set_changed(lv);
+
 	dm_list_iterate_safe(segh, t, &lv->segments) {
 		current = dm_list_item(segh, struct lv_segment);
 
@@ -1031,7 +1031,7 @@ struct volume_group *vg_create(struct cmd_context *cmd, const char *vg_name)
 	};
 	struct format_instance *fid;
 
-	if (!(vg = alloc_vg("vg_create", cmd, vg_name)))
+	if (!(vg = alloc_vg("vg_create", cmd, vg_name, 0)))
 		goto_bad;
 
 	if (!id_create(&vg->id)) {
@@ -2239,7 +2239,123 @@ static int _validate_lv_lock_args(struct logical_volume *lv)
 	return r;
 }
 
-int vg_validate(struct volume_group *vg)
+/*
+ * Segment and area changes clear lv->validated through lv_set_changed().
+ * Status flags are set directly in too many places, so they are
+ * compared with their state at the last check instead.
+ */
+static int _lv_unchanged(const struct logical_volume *lv)
+{
+	return lv->validated && (lv->validated_status == lv->status);
+}
+
+static void _lv_set_validate_now(struct logical_volume *lv)
+{
+	if (lv)
+		lv->validate_now = 1;
+}
+
+/*
+ * A changed LV is checked with the LVs it references and the LVs
+ * using it, since the checks compare the links in both directions,
+ * and the PVs its areas are on.
+ */
+static void _lv_set_validate_neighbours(struct logical_volume *lv)
+{
+	struct lv_segment *seg;
+	struct seg_list *sl;
+	uint32_t s;
+
+	dm_list_iterate_items(sl, &lv->segs_using_this_lv)
+		_lv_set_validate_now(sl->seg->lv);
+
+	dm_list_iterate_items(seg, &lv->segments) {
+		for (s = 0; s < seg->area_count; s++) {
+			if (seg_type(seg, s) == AREA_LV)
+				_lv_set_validate_now(seg_lv(seg, s));
+			else if ((seg_type(seg, s) == AREA_PV) && seg_pvseg(seg, s) && seg_pv(seg, s))
+				seg_pv(seg, s)->validated = 0;
+
+			if (seg->meta_areas && (seg_metatype(seg, s) == AREA_LV))
+				_lv_set_validate_now(seg_metalv(seg, s));
+		}
+
+		_lv_set_validate_now(seg->origin);
+		_lv_set_validate_now(seg->merge_lv);
+		_lv_set_validate_now(seg->cow);
+		_lv_set_validate_now(seg->log_lv);
+		_lv_set_validate_now(seg->metadata_lv);
+		_lv_set_validate_now(seg->external_lv);
+		_lv_set_validate_now(seg->pool_lv);
+		_lv_set_validate_now(seg->writecache);
+		_lv_set_validate_now(seg->integrity_meta_dev);
+	}
+}
+
+/*
+ * Select the LVs whose segments are checked by a scoped vg_validate().
+ * Returns the number of them.
+ */
+static unsigned _vg_select_changed(struct volume_group *vg)
+{
+	struct lv_list *lvl;
+	unsigned count = 0;
+
+	dm_list_iterate_items(lvl, &vg->lvs)
+		lvl->lv->validate_now = lvl->lv->validate_changed = _lv_unchanged(lvl->lv) ? 0 : 1;
+
+	dm_list_iterate_items(lvl, &vg->lvs)
+		if (lvl->lv->validate_changed)
+			_lv_set_validate_neighbours(lvl->lv);
+
+	dm_list_iterate_items(lvl, &vg->lvs)
+		if (lvl->lv->validate_now)
+			count++;
+
+	return count;
+}
+
+/*
+ * Record the current state of all LVs and PVs after their segments
+ * were found consistent, by vg_read or vg_validate.
+ */
+static void _vg_set_validated(struct volume_group *vg, int valid)
+{
+	struct lv_list *lvl;
+	struct pv_list *pvl;
+	struct logical_volume *lv;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		lv = lvl->lv;
+		lv->validate_now = lv->validate_changed = 0;
+		lv->validated = valid ? 1 : 0;
+		lv->validated_status = lv->status;
+	}
+
+	dm_list_iterate_items(pvl, &vg->pvs)
+		pvl->pv->validated = valid ? 1 : 0;
+}
+
+/*
+ * When metadata/full_validate_interval is not 1, vg_write checks
+ * the segments of only the LVs and PVs that changed since the VG was
+ * read or last written (and their neighbours), except for every Nth
+ * seqno.  All the other checks of vg_validate are always done.
+ */
+static int _vg_validate_scoped(struct volume_group *vg)
+{
+	int interval = find_config_tree_int(vg->cmd, metadata_full_validate_interval_CFG, NULL);
+
+	if (interval == 1)
+		return 0;
+
+	if ((interval > 1) && !((vg->seqno + 1) % interval))
+		return 0;
+
+	return 1;
+}
+
+static int _vg_validate(struct volume_group *vg, int scoped)
 {
 	struct pv_list *pvl;
 	struct lv_list *lvl;
@@ -2257,6 +2373,13 @@ int vg_validate(struct volume_group *vg)
 	size_t vg_name_len = strlen(vg->name);
 	size_t dev_name_len;
 	struct validate_hash vhash = { NULL };
+	unsigned changed_count;
+
+	if (scoped) {
+		changed_count = _vg_select_changed(vg);
+		log_debug_metadata("Validating segments of %u changed of %u LVs in VG %s.",
+				   changed_count, dm_list_size(&vg->lvs), vg->name);
+	}
 
 	if (vg->alloc == ALLOC_CLING_BY_TAGS) {
 		log_error(INTERNAL_ERROR "VG %s allocation policy set to invalid cling_by_tags.",
@@ -2331,7 +2454,7 @@ int vg_validate(struct volume_group *vg)
 	}
 
 
-	if (!check_pv_segments(vg)) {
+	if (!check_pv_segments(vg, scoped)) {
 		log_error(INTERNAL_ERROR "PV segments corrupted in %s.",
 			  vg->name);
 		r = 0;
@@ -2396,7 +2519,8 @@ int vg_validate(struct volume_group *vg)
 			}
 		}
 
-		if (!check_lv_segments(lvl->lv, 0)) {
+		if ((!scoped || lvl->lv->validate_now) &&
+		    !check_lv_segments(lvl->lv, 0)) {
 			log_error(INTERNAL_ERROR "LV segments corrupted in %s.",
 				  lvl->lv->name);
 			r = 0;
@@ -2481,7 +2605,8 @@ int vg_validate(struct volume_group *vg)
 			r = 0;
 		}
 
-		if (!check_lv_segments(lvl->lv, 1)) {
+		if ((!scoped || lvl->lv->validate_now) &&
+		    !check_lv_segments(lvl->lv, 1)) {
 			log_error(INTERNAL_ERROR "LV segments corrupted in %s.",
 				  lvl->lv->name);
 			r = 0;
@@ -2747,6 +2872,8 @@ int vg_validate(struct volume_group *vg)
 	}
 
 out:
+	_vg_set_validated(vg, r);
+
 	if (vhash.lvid)
 		dm_hash_destroy(vhash.lvid);
 	if (vhash.lvname)
@@ -2763,6 +2890,20 @@ out:
 	return r;
 }
 
+int vg_validate(struct volume_group *vg)
+{
+	return _vg_validate(vg, 0);
+}
+
+/*
+ * As vg_validate(), but only the segments of LVs and PVs changed since
+ * they were last checked are checked, see lv_set_changed().
+ */
+int vg_validate_changed(struct volume_group *vg)
+{
+	return _vg_validate(vg, 1);
+}
+
 static int _pv_in_pv_list(struct physical_volume *pv, struct dm_list *head)
 {
 	struct pv_list *pvl;
@@ -2904,6 +3045,37 @@ static void _wipe_outdated_pvs(struct cmd_context *cmd, struct volume_group *vg)
 	lvmcache_del_outdated_devs(cmd, vg->name, vgid);
 }
 
+/*
+ * The metadata writes of each phase (write, precommit, commit) to all
+ * the mdas are issued together and completed by a single flush, which
+ * still keeps each phase on disk before the next one is started.
+ * Returns the number of mdas written in the batch whose device failed,
+ * marking them MDA_FAILED if requested.
+ */
+static int _mdas_write_batch_end(struct volume_group *vg, int mark_failed)
+{
+	struct metadata_area *mda;
+	struct device *dev;
+	int ok = dev_write_batch_end();
+	int failed = 0;
+
+	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
+		if (!(mda->status & MDA_WRITE_PENDING))
+			continue;
+
+		mda->status &= ~MDA_WRITE_PENDING;
+
+		if (ok || !(dev = mda_get_device(mda)) || !dev_write_batch_failed(dev))
+			continue;
+
+		if (mark_failed)
+			mda->status |= MDA_FAILED;
+		failed++;
+	}
+
+	return failed;
+}
+
 /*
  * After vg_write() returns success,
  * caller MUST call either vg_commit() or vg_revert()
@@ -2916,7 +3088,7 @@ int vg_write(struct volume_group *vg)
 	struct metadata_area *mda;
 	struct lv_list *lvl;
 	struct device *mda_dev;
-	int revert = 0, wrote = 0;
+	int revert = 0, wrote = 0, failed;
 
 	vgid[ID_LEN] = 0;
 	memcpy(vgid, &vg->id.uuid, ID_LEN);
@@ -2938,7 +3110,7 @@ int vg_write(struct volume_group *vg)
 		return 0;
 	}
 
-	if (!vg_validate(vg))
+	if (!_vg_validate(vg, _vg_validate_scoped(vg)))
 		return_0;
 
 	if (vg->status & PARTIAL_VG) {
@@ -3014,6 +3186,8 @@ int vg_write(struct volume_group *vg)
 	}
 
 	/* Write to each copy of the metadata area */
+	dev_write_batch_begin();
+
 	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
 		mda_dev = mda_get_device(mda);
 
@@ -3051,8 +3225,18 @@ int vg_write(struct volume_group *vg)
 				revert = 1;
 				break;
 			}
-		} else
+		} else {
+			mda->status |= MDA_WRITE_PENDING;
 			++ wrote;
+		}
+	}
+
+	if ((failed = _mdas_write_batch_end(vg, vg->cmd->handles_missing_pvs))) {
+		if (vg->cmd->handles_missing_pvs) {
+			log_warn("WARNING: Failed to write %d MDA(s) of VG %s.", failed, vg->name);
+			wrote -= failed;
+		} else
+			revert = 1;
 	}
 
 	if (revert || !wrote) {
@@ -3072,23 +3256,33 @@ int vg_write(struct volume_group *vg)
 	}
 
 	/* Now pre-commit each copy of the new metadata */
+	dev_write_batch_begin();
+
 	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
 		if (mda->status & MDA_FAILED)
 			continue;
 		if (mda->ops->vg_precommit &&
 		    !mda->ops->vg_precommit(vg->fid, vg, mda)) {
 			stack;
-			/* Revert */
-			dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
-				if (mda->status & MDA_FAILED)
-					continue;
-				if (mda->ops->vg_revert &&
-				    !mda->ops->vg_revert(vg->fid, vg, mda)) {
-					stack;
-				}
+			revert = 1;
+			break;
+		}
+		mda->status |= MDA_WRITE_PENDING;
+	}
+
+	if (_mdas_write_batch_end(vg, 0))
+		revert = 1;
+
+	if (revert) {
+		dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
+			if (mda->status & MDA_FAILED)
+				continue;
+			if (mda->ops->vg_revert &&
+			    !mda->ops->vg_revert(vg->fid, vg, mda)) {
+				stack;
 			}
-			return 0;
 		}
+		return 0;
 	}
 
 	lockd_vg_update(vg);
@@ -3111,15 +3305,22 @@ static int _vg_commit_mdas(struct volume_group *vg)
 		dm_list_move(&vg->fid->metadata_areas_in_use, &mda->list);
 
 	/* Commit to each copy of the metadata area */
+	dev_write_batch_begin();
+
 	dm_list_iterate_items(mda, &vg->fid->metadata_areas_in_use) {
 		if (mda->status & MDA_FAILED)
 			continue;
 		if (mda->ops->vg_commit &&
 		    !mda->ops->vg_commit(vg->fid, vg, mda)) {
 			stack;
-		} else
+		} else {
+			mda->status |= MDA_WRITE_PENDING;
 			good++;
+		}
 	}
+
+	good -= _mdas_write_batch_end(vg, 0);
+
 	if (good)
 		return 1;
 	return 0;
@@ -5100,7 +5301,7 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 	if (missing_pv_dev || missing_pv_flag)
 		vg_mark_partial_lvs(vg, 1);
 
-	if (!check_pv_segments(vg)) {
+	if (!check_pv_segments(vg, 0)) {
 		log_error(INTERNAL_ERROR "PV segments corrupted in %s.", vg->name);
 		failure |= FAILED_INTERNAL_ERROR;
 		goto bad;
@@ -5123,6 +5324,9 @@ struct volume_group *vg_read(struct cmd_context *cmd, const char *vg_name, const
 		}
 	}
 
+	/* The segments of all LVs and PVs have just been checked. */
+	_vg_set_validated(vg, 1);
+
 	if (!check_pv_dev_sizes(vg))
 		log_warn("WARNING: One or more devices used as PVs in VG %s have changed sizes.", vg->name);
 
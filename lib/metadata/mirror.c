@@ -877,6 +877,7 @@ static int _remove_mirror_images(struct logical_volume *lv,
 		if (!release_lv_segment_area(mirrored_seg, m, mirrored_seg->area_len))
 			return_0;
 	}
+	lv_set_changed(mirrored_seg->lv);
 	mirrored_seg->area_count = new_area_count;
 
 	/* If no more mirrors, remove mirror layer */
@@ -1219,6 +1220,7 @@ int remove_mirrors_from_segments(struct logical_volume *lv,
 			if (!release_and_discard_lv_segment_area(seg, s, seg->area_len))
 				return_0;
 
+		lv_set_changed(seg->lv);
 		seg->area_count = new_mirrors + 1;
 
 		if (!new_mirrors)
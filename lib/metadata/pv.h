@@ -63,6 +63,7 @@ struct physical_volume {
         /* This is true whenever the represented PV has a label associated. */
         uint64_t is_labelled:1;
         uint64_t unused_missing_cleared:1;
+        uint64_t validated:1;	/* pv segments unchanged since last checked */
 
         /* NB. label_sector is valid whenever is_labelled is true */
 	uint64_t label_sector;
@@ -34,7 +34,7 @@ int pv_split_segment(struct dm_pool *mem,
 		     struct pv_segment **pvseg_allocated);
 int discard_pv_segment(struct pv_segment *peg, uint32_t discard_area_reduction);
 int release_pv_segment(struct pv_segment *peg, uint32_t area_reduction);
-int check_pv_segments(struct volume_group *vg);
+int check_pv_segments(struct volume_group *vg, int changed_only);
 void merge_pv_segments(struct pv_segment *peg1, struct pv_segment *peg2);
 
 #endif
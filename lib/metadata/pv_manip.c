@@ -111,6 +111,7 @@ static struct pv_segment *_pv_split_segment(struct dm_pool *mem,
 	peg->len = peg->len - peg_new->len;
 
 	dm_list_add_h(&peg->list, &peg_new->list);
+	pv->validated = 0;
 
 	if (peg->lvseg) {
 		peg->pv->pe_alloc_count -= peg_new->len;
@@ -181,6 +182,7 @@ struct pv_segment *assign_peg_to_lvseg(struct physical_volume *pv,
 
 	peg->lvseg = seg;
 	peg->lv_area = area_num;
+	peg->pv->validated = 0;
 
 	peg->pv->pe_alloc_count += area_len;
 	peg->lvseg->lv->vg->free_count -= area_len;
@@ -307,6 +309,8 @@ int release_pv_segment(struct pv_segment *peg, uint32_t area_reduction)
 		return 0;
 	}
 
+	peg->pv->validated = 0;
+
 	if (peg->lvseg->area_len == area_reduction) {
 		peg->pv->pe_alloc_count -= area_reduction;
 		peg->lvseg->lv->vg->free_count += area_reduction;
@@ -336,6 +340,7 @@ int release_pv_segment(struct pv_segment *peg, uint32_t area_reduction)
  */
 void merge_pv_segments(struct pv_segment *peg1, struct pv_segment *peg2)
 {
+	peg1->pv->validated = 0;
 	peg1->len += peg2->len;
 
 	dm_list_del(&peg2->list);
@@ -387,9 +392,11 @@ uint32_t pv_list_extents_free(const struct dm_list *pvh)
 }
 
 /*
- * Check all pv_segments in VG for consistency
+ * Check all pv_segments in VG for consistency.
+ * With changed_only, the segments of PVs that did not change since
+ * they were last checked are not walked again.
  */
-int check_pv_segments(struct volume_group *vg)
+int check_pv_segments(struct volume_group *vg, int changed_only)
 {
 	struct physical_volume *pv;
 	struct pv_list *pvl;
@@ -406,6 +413,12 @@ int check_pv_segments(struct volume_group *vg)
 		alloced = 0;
 		pv_count++;
 
+		if (changed_only && pv->validated) {
+			extent_count += pv->pe_count;
+			free_count += pv->pe_count - pv->pe_alloc_count;
+			continue;
+		}
+
 		dm_list_iterate_items(peg, &pv->segments) {
 			s = peg->lv_area;
 
@@ -512,6 +525,7 @@ static int _reduce_pv(struct physical_volume *pv, struct volume_group *vg,
 	}
 
 	pv->pe_count = new_pe_count;
+	pv->validated = 0;
 
 	vg->extent_count -= (old_pe_count - new_pe_count);
 	vg->free_count -= (old_pe_count - new_pe_count);
@@ -540,6 +554,7 @@ static int _extend_pv(struct physical_volume *pv, struct volume_group *vg,
 	dm_list_add(&pv->segments, &peg->list);
 
 	pv->pe_count = new_pe_count;
+	pv->validated = 0;
 
 	vg->extent_count += (new_pe_count - old_pe_count);
 	vg->free_count += (new_pe_count - old_pe_count);
@@ -156,6 +156,7 @@ static void _check_and_adjust_region_size(struct logical_volume *lv)
 	struct lv_segment *seg = first_seg(lv);
 	uint32_t region_size;
 
+	lv_set_changed(lv);
 	seg->region_size = seg->region_size ? : get_default_region_size(lv->vg->cmd);
 	region_size = raid_ensure_min_region_size(lv, lv->size, seg->region_size);
 	if (seg->region_size != region_size) {
@@ -529,6 +530,7 @@ static int _reset_flags_passed_to_kernel(struct logical_volume *lv, int *flags_r
 	}
 
 	/* Reset passed in data offset (reshaping) */
+	lv_set_changed(lv);
 	if (lv_count)
 		seg->data_offset = 0;
 
@@ -958,6 +960,7 @@ static int _shift_and_rename_image_components(struct lv_segment *seg)
 		seg->meta_areas[s - missing] = seg->meta_areas[s];
 	}
 
+	lv_set_changed(seg->lv);
 	seg->area_count -= missing;
 	return 1;
 }
@@ -1314,6 +1317,7 @@ static int _lv_set_reshape_len(struct logical_volume *lv, uint32_t reshape_len)
 	if (reshape_len >= lv->le_count - 1)
 		return_0;
 
+	lv_set_changed(lv);
 	seg->reshape_len = reshape_len;
 
 	for (s = 0; s < seg->area_count; s++) {
@@ -1322,6 +1326,7 @@ static int _lv_set_reshape_len(struct logical_volume *lv, uint32_t reshape_len)
 
 		reshape_len = seg->reshape_len;
 		dm_list_iterate_items(data_seg, &seg_lv(seg, s)->segments) {
+			lv_set_changed(data_seg->lv);
 			data_seg->reshape_len = reshape_len;
 			reshape_len = 0;
 		}
@@ -1348,6 +1353,7 @@ static int _lv_set_image_lvs_start_les(struct logical_volume *lv)
 
 		le = 0;
 		dm_list_iterate_items(data_seg, &(seg_lv(seg, s)->segments)) {
+			lv_set_changed(data_seg->lv);
 			data_seg->reshape_len = le ? 0 : seg->reshape_len;
 			data_seg->le = le;
 			le += data_seg->len;
@@ -1430,6 +1436,7 @@ static int _lv_relocate_reshape_space(struct logical_volume *lv, enum alloc_wher
 
 		le = 0;
 		dm_list_iterate_items(data_seg, &dlv->segments) {
+			lv_set_changed(data_seg->lv);
 			data_seg->reshape_len = le ? 0 : _reshape_len_per_dev(seg);
 			data_seg->le = le;
 			le += data_seg->len;
@@ -1491,6 +1498,7 @@ static int _lv_alloc_reshape_post_extend(struct logical_volume *lv,
 
 	if (seg->area_count < 3) {
 		/* Reset segment type, stripe and lv size */
+		lv_set_changed(lv);
 		seg->segtype = segtype;
 		seg->stripe_size = stripe_size;
 		lv->size = lv_size_cur;
@@ -1569,6 +1577,7 @@ static int _lv_alloc_reshape_space(struct logical_volume *lv,
 
 		/* Special case needed to add reshape space for raid4/5 with 2 total stripes */
 		if (seg->area_count < 3) {
+			lv_set_changed(lv);
 			if ((mirrors = seg->area_count) < 2)
 				return_0;
 			if (!seg_is_raid4(seg) &&
@@ -1611,6 +1620,7 @@ static int _lv_alloc_reshape_space(struct logical_volume *lv,
 	}
 
 	/* Preset data offset in case we fail relocating reshape space below */
+	lv_set_changed(lv);
 	seg->data_offset = 0;
 
 	/*
@@ -1686,12 +1696,14 @@ static int _lv_free_reshape_space_with_status(struct logical_volume *lv, enum al
 		 * The special, unused value '1' for seg->data_offset will cause
 		 * "data_offset 0" to be emitted in the segment line.
 		 */
+		lv_set_changed(lv);
 		seg->data_offset = (where == alloc_begin) ? 1 : 0;
 
 		if (seg->data_offset &&
 		    !lv_update_and_reload(lv))
 			return_0;
 
+		lv_set_changed(lv);
 		seg->extents_copied = first_seg(lv)->area_len;
 		if (!lv_reduce(lv, total_reshape_len))
 			return_0;
@@ -1801,6 +1813,7 @@ static int _reshape_adjust_to_size(struct logical_volume *lv,
 		return_0;
 
 	/* Externally visible LV size w/o reshape space */
+	lv_set_changed(lv);
 	lv->le_count = seg->len = new_le_count;
 	lv->size = (lv->le_count - (uint64_t) new_image_count * _reshape_len_per_dev(seg)) * lv->vg->extent_size;
 	/* seg->area_len does not change */
@@ -1928,6 +1941,7 @@ static int _raid_reshape_add_images(struct logical_volume *lv,
 		}
 	}
 
+	lv_set_changed(lv);
 	seg->stripe_size = new_stripe_size;
 
 	/* Define image adding reshape (used as SEGTYPE_FLAG to avoid incompatible activations on old runtime) */
@@ -2033,6 +2047,7 @@ static int _raid_reshape_remove_images(struct logical_volume *lv,
 		for (s = new_image_count; s < old_image_count; s++)
 			seg_lv(seg, s)->status |= LV_RESHAPE_DELTA_DISKS_MINUS;
 
+		lv_set_changed(lv);
 		if (seg_is_any_raid5(seg) && new_image_count == 2)
 			seg->data_copies = 2;
 
@@ -2075,6 +2090,7 @@ static int _raid_reshape_remove_images(struct logical_volume *lv,
 		if (!_lv_raid_change_image_count(lv, 1, new_image_count, allocate_pvs, removal_lvs, 0, 0))
 			return_0;
 
+		lv_set_changed(lv);
 		seg->area_count = new_image_count;
 		break;
 
@@ -2084,6 +2100,7 @@ static int _raid_reshape_remove_images(struct logical_volume *lv,
 	}
 
 	/* May allow stripe size changes > 2 legs */
+	lv_set_changed(lv);
 	if (new_image_count > 2)
 		seg->stripe_size = new_stripe_size;
 	else {
@@ -2144,6 +2161,7 @@ static int _raid_reshape_keep_images(struct logical_volume *lv,
 	if (seg->stripe_size != new_stripe_size)
 		alloc_reshape_space = 1;
 
+	lv_set_changed(lv);
 	seg->stripe_size = new_stripe_size;
 
 	if (seg->area_count == 2)
@@ -2175,6 +2193,7 @@ static int _raid_reshape_keep_images(struct logical_volume *lv,
 	}
 
 
+	lv_set_changed(lv);
 	seg->segtype = new_segtype;
 
 	/* Define stripesize/raid algorithm reshape (used as SEGTYPE_FLAG to avoid incompatible activations on old runtime) */
@@ -2437,6 +2456,7 @@ static int _raid_reshape(struct logical_volume *lv,
 	/* HM FIXME: workaround for not resetting "nosync" flag */
 	init_mirror_in_sync(0);
 
+	lv_set_changed(lv);
 	seg->region_size = new_region_size;
 
 	if (seg->area_count != 2 || old_image_count != seg->area_count) {
@@ -2644,6 +2664,7 @@ static int _raid_add_images_without_commit(struct logical_volume *lv,
 			status_mask = ~(LV_REBUILD);
 
 		/* FIXME: allow setting region size on upconvert from linear */
+		lv_set_changed(lv);
 		seg->region_size = get_default_region_size(lv->vg->cmd);
 		/* MD's bitmap is limited to tracking 2^21 regions */
 		seg->region_size = raid_ensure_min_region_size(lv, lv->size, seg->region_size);
@@ -2704,6 +2725,7 @@ static int _raid_add_images_without_commit(struct logical_volume *lv,
 
 		lv->status |= RAID;
 		seg = first_seg(lv);
+		lv_set_changed(lv);
 		seg->region_size = region_size;
 		seg_lv(seg, 0)->status |= RAID_IMAGE | LVM_READ | LVM_WRITE;
 		if (!(seg->segtype = get_segtype_from_string(lv->vg->cmd, SEG_TYPE_NAME_RAID1)))
@@ -2727,6 +2749,7 @@ to be left for these sub-lvs.
 		goto fail;
 	}
 	memcpy(new_areas, seg->areas, seg->area_count * sizeof(*seg->areas));
+	lv_set_changed(lv);
 	seg->areas = new_areas;
 
 	/* Expand meta_areas array */
@@ -3728,6 +3751,7 @@ static int _extract_image_component_error_seg(struct lv_segment *seg,
 {
 	struct logical_volume *lv;
 
+	lv_set_changed(seg->lv);
 	switch (type) {
 		case RAID_META:
 			lv = seg_metalv(seg, idx);
@@ -3787,6 +3811,7 @@ static int _extract_image_component_sublist(struct lv_segment *seg,
 		lvl++;
 	}
 
+	lv_set_changed(seg->lv);
 	if (!idx && end == seg->area_count) {
 		if (type == RAID_IMAGE)
 			seg->areas = NULL;
@@ -3869,6 +3894,7 @@ static int _alloc_and_add_rmeta_devs_for_lv(struct logical_volume *lv, struct dm
 	}
 
 	/* Set segment areas for metadata sub_lvs */
+	lv_set_changed(lv);
 	seg->meta_areas = seg_meta_areas;
 	log_debug_metadata("Adding newly allocated metadata LVs to %s.",
 			   display_lvname(lv));
@@ -3937,6 +3963,7 @@ static int _raid0_add_or_remove_metadata_lvs(struct logical_volume *lv,
 		if (seg->meta_areas) {
 			if (!_extract_image_component_list(seg, RAID_META, 0, removal_lvs))
 				return_0;
+			lv_set_changed(lv);
 			seg->meta_areas = NULL;
 		}
 		new_raid_type_flag = SEG_RAID0;
@@ -3947,6 +3974,7 @@ static int _raid0_add_or_remove_metadata_lvs(struct logical_volume *lv,
 		new_raid_type_flag = SEG_RAID0_META;
 	}
 
+	lv_set_changed(lv);
 	if (!(seg->segtype = get_segtype_from_flag(lv->vg->cmd, new_raid_type_flag)))
 		return_0;
 
@@ -4058,6 +4086,7 @@ static int _convert_mirror_to_raid1(struct logical_volume *lv,
 		}
 	}
 
+	lv_set_changed(lv);
 	seg->meta_areas = meta_areas;
 	s = 0;
 
@@ -4092,6 +4121,7 @@ static int _convert_mirror_to_raid1(struct logical_volume *lv,
 	init_mirror_in_sync(1);
 
 	log_debug_metadata("Setting new segtype for %s.", display_lvname(lv));
+	lv_set_changed(lv);
 	seg->segtype = new_segtype;
 	lv->status &= ~MIRROR;
 	lv->status &= ~MIRRORED;
@@ -4154,6 +4184,7 @@ static int _convert_raid1_to_mirror(struct logical_volume *lv,
 	if (!_extract_image_component_list(seg, RAID_META, 0, removal_lvs))
 		return_0;
 
+	lv_set_changed(lv);
 	seg->meta_areas = NULL;
 
 	/* Rename all data sub LVs from "*_rimage_*" to "*_mimage_*" and set their status */
@@ -4218,6 +4249,7 @@ static int _striped_to_raid0_move_segs_to_raid0_lvs(struct logical_volume *lv,
 		}
 
 		/* Adjust le count and LV size */
+		lv_set_changed(dlv);
 		dlv->le_count = le;
 		dlv->size = (uint64_t) le * lv->vg->extent_size;
 		s++;
@@ -4353,6 +4385,7 @@ static int _convert_raid0_to_striped(struct logical_volume *lv,
 
 	lv->status &= ~RAID;
 
+	lv_set_changed(lv);
 	if (!(seg->segtype = get_segtype_from_string(lv->vg->cmd, SEG_TYPE_NAME_STRIPED)))
 		return_0;
 
@@ -4959,6 +4992,7 @@ static int _clear_meta_lvs(struct logical_volume *lv)
 		return_0;
 
 	/* Memorize meta areas and segtype to set again after initializing. */
+	lv_set_changed(lv);
 	seg->meta_areas = NULL;
 
 	if (seg_is_raid0_meta(seg) &&
@@ -4991,6 +5025,7 @@ static int _clear_meta_lvs(struct logical_volume *lv)
 	}
 
 	/* Set memorized meta areas and raid0_meta segtype */
+	lv_set_changed(lv);
 	seg->meta_areas = tmp_areas;
 	seg->segtype = tmp_segtype;
 
@@ -5046,6 +5081,7 @@ static void _switch_area_lvs(struct lv_segment *seg, uint32_t s1, uint32_t s2)
 	struct logical_volume *lvt;
 
 	lvt = seg_lv(seg, s1);
+	lv_set_changed(seg->lv);
 	seg_lv(seg, s1) = seg_lv(seg, s2);
 	seg_lv(seg, s2) = lvt;
 
@@ -5157,6 +5193,7 @@ static int _raid45_to_raid54_wrapper(TAKEOVER_FN_ARGS)
 
 	/* Don't resync */
 	init_mirror_in_sync(1);
+	lv_set_changed(lv);
 	seg->region_size = new_region_size ?: region_size;
 	seg->segtype = new_segtype;
 
@@ -5268,6 +5305,7 @@ static int _takeover_downconvert_wrapper(TAKEOVER_FN_ARGS)
 		if (!_lv_raid_change_image_count(lv, 1, new_image_count, allocate_pvs, &removal_lvs, 0, 0))
 			return_0;
 
+		lv_set_changed(lv);
 		seg->area_count = new_image_count;
 	}
 
@@ -5350,6 +5388,7 @@ static void _set_takeover_upconvert_sizes(struct logical_volume *lv,
 					  uint32_t extents_copied, uint32_t seg_len) {
 	struct lv_segment *seg = first_seg(lv);
 
+	lv_set_changed(lv);
 	seg->segtype = new_segtype;
 	seg->region_size = region_size;
 	seg->stripe_size = stripe_size;
@@ -5453,6 +5492,7 @@ static int _takeover_upconvert_wrapper(TAKEOVER_FN_ARGS)
 
 	/* In case of raid4/5, adjust to allow for allocation of additional image pairs */
 	if (seg_is_raid4(seg) || seg_is_any_raid5(seg)) {
+		lv_set_changed(lv);
 		if (!(seg->segtype = get_segtype_from_flag(lv->vg->cmd, SEG_RAID0_META)))
 			return_0;
 		seg->area_len = seg_lv(seg, 0)->le_count;
@@ -5539,6 +5579,7 @@ static int _takeover_upconvert_wrapper(TAKEOVER_FN_ARGS)
 			return_0;
 	}
 
+	lv_set_changed(lv);
 	seg->data_copies = new_data_copies;
 
 	if (segtype_is_raid4(new_segtype) &&
@@ -177,6 +177,7 @@ struct logical_volume *origin_from_cow(const struct logical_volume *lv)
 void init_snapshot_seg(struct lv_segment *seg, struct logical_volume *origin,
 		       struct logical_volume *cow, uint32_t chunk_size, int merge)
 {
+	lv_set_changed(seg->lv);
 	seg->chunk_size = chunk_size;
 	seg->origin = origin;
 	seg->cow = cow;
@@ -285,6 +286,7 @@ int vg_add_snapshot(struct logical_volume *origin,
 				     ALLOC_INHERIT, origin->vg)))
 		return_0;
 
+	lv_set_changed(snap);
 	snap->le_count = extent_count;
 
 	if (!(seg = _alloc_snapshot_seg(snap)))
@@ -121,6 +121,7 @@ int update_vdo_pool_virtual_size(struct lv_segment *vdo_pool_seg)
 		extents += sl->seg->len;
 
 	/* Only growing virtual/logical VDO size */
+	lv_set_changed(vdo_pool_seg->lv);
 	if (extents > vdo_pool_seg->vdo_pool_virtual_extents)
 		vdo_pool_seg->vdo_pool_virtual_extents = extents;
 
@@ -464,6 +465,7 @@ struct logical_volume *convert_vdo_pool_lv(struct logical_volume *data_lv,
 		return_NULL;
 
 	vdo_pool_seg = first_seg(vdo_pool_lv);
+	lv_set_changed(vdo_pool_lv);
 	vdo_pool_seg->segtype = vdo_pool_segtype;
 	vdo_pool_seg->vdo_params = *vtp;
 	vdo_pool_seg->vdo_pool_header_size = vdo_pool_header_size;
@@ -20,8 +20,12 @@
 #include "lib/commands/toolcontext.h"
 #include "lib/format_text/archiver.h"
 
+/*
+ * nr_lvs is the number of LVs expected in the VG.  Tags may be unique to
+ * each LV, so the table of interned strings is sized from it.
+ */
 struct volume_group *alloc_vg(const char *pool_name, struct cmd_context *cmd,
-			      const char *vg_name)
+			      const char *vg_name, unsigned nr_lvs)
 {
 	struct dm_pool *vgmem;
 	struct volume_group *vg;
@@ -46,8 +50,8 @@ struct volume_group *alloc_vg(const char *pool_name, struct cmd_context *cmd,
 	vg->vgmem = vgmem;
 	vg->alloc = ALLOC_NORMAL;
 
-	if (!(vg->hostnames = dm_hash_create(14))) {
-		log_error("Failed to allocate VG hostname hashtable.");
+	if (!(vg->strings = dm_hash_create(14 + nr_lvs))) {
+		log_error("Failed to allocate VG string hashtable.");
 		dm_pool_destroy(vgmem);
 		return NULL;
 	}
@@ -81,7 +85,7 @@ static void _free_vg(struct volume_group *vg)
 
 	if (vg->committed_cft)
 		config_destroy(vg->committed_cft);
-	dm_hash_destroy(vg->hostnames);
+	dm_hash_destroy(vg->strings);
 	dm_pool_destroy(vg->vgmem);
 }
 
@@ -107,6 +111,24 @@ void free_orphan_vg(struct volume_group *vg)
 	_free_vg(vg);
 }
 
+const char *vg_intern_str(struct volume_group *vg, const char *str)
+{
+	char *s;
+
+	if ((s = dm_hash_lookup(vg->strings, str)))
+		return s;
+
+	if (!(s = dm_pool_strdup(vg->vgmem, str))) {
+		log_error("Failed to duplicate string %s.", str);
+		return NULL;
+	}
+
+	if (!dm_hash_insert(vg->strings, str, s))
+		return_NULL;
+
+	return s;
+}
+
 int link_lv_to_vg(struct volume_group *vg, struct logical_volume *lv)
 {
 	struct lv_list *lvl;
@@ -121,6 +143,7 @@ int link_lv_to_vg(struct volume_group *vg, struct logical_volume *lv)
 	lv->vg = vg;
 	dm_list_add(&vg->lvs, &lvl->list);
 	lv->status &= ~LV_REMOVED;
+	lv_set_changed(lv);
 
 	return 1;
 }
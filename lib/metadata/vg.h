@@ -128,14 +128,14 @@ struct volume_group {
 
 	uint32_t mda_copies; /* target number of mdas for this VG */
 
-	struct dm_hash_table *hostnames; /* map of creation hostnames */
+	struct dm_hash_table *strings; /* interned hostnames, tags, dlm lock args */
 	struct logical_volume *pool_metadata_spare_lv; /* one per VG */
 	struct logical_volume *sanlock_lv; /* one per VG */
 	struct dm_list msg_list;
 };
 
 struct volume_group *alloc_vg(const char *pool_name, struct cmd_context *cmd,
-			      const char *vg_name);
+			      const char *vg_name, unsigned nr_lvs);
 
 /*
  * release_vg() must be called on every struct volume_group allocated
@@ -144,6 +144,12 @@ struct volume_group *alloc_vg(const char *pool_name, struct cmd_context *cmd,
 void release_vg(struct volume_group *vg);
 void free_orphan_vg(struct volume_group *vg);
 
+/*
+ * Return a copy of str in vg->vgmem that is shared by all callers asking
+ * for the same string.  The result must not be modified.
+ */
+const char *vg_intern_str(struct volume_group *vg, const char *str);
+
 char *vg_fmt_dup(const struct volume_group *vg);
 char *vg_name_dup(const struct volume_group *vg);
 char *vg_system_id_dup(const struct volume_group *vg);
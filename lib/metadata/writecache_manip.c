@@ -430,6 +430,7 @@ int lv_writecache_set_cleaner(struct logical_volume *lv)
 {
 	struct lv_segment *seg = first_seg(lv);
 
+	lv_set_changed(lv);
 	seg->writecache_settings.cleaner = 1;
 	seg->writecache_settings.cleaner_set = 1;
 
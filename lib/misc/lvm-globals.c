@@ -30,6 +30,7 @@ static int _internal_filtering = 0;
 static int _fwraid_filtering = 0;
 static int _pvmove = 0;
 static int _obtain_device_list_from_udev = DEFAULT_OBTAIN_DEVICE_LIST_FROM_UDEV;
+static int _obtain_device_list_from_sysfs = DEFAULT_OBTAIN_DEVICE_LIST_FROM_SYSFS;
 static enum dev_ext_e _external_device_info_source = DEV_EXT_NONE;
 static int _debug_level = 0;
 static int _debug_classes_logged = 0;
@@ -102,6 +103,11 @@ void init_obtain_device_list_from_udev(int device_list_from_udev)
 	_obtain_device_list_from_udev = device_list_from_udev;
 }
 
+void init_obtain_device_list_from_sysfs(int device_list_from_sysfs)
+{
+	_obtain_device_list_from_sysfs = device_list_from_sysfs;
+}
+
 void init_external_device_info_source(enum dev_ext_e src)
 {
 	_external_device_info_source = src;
@@ -280,6 +286,11 @@ int obtain_device_list_from_udev(void)
 	return _obtain_device_list_from_udev;
 }
 
+int obtain_device_list_from_sysfs(void)
+{
+	return _obtain_device_list_from_sysfs;
+}
+
 enum dev_ext_e external_device_info_source(void)
 {
 	return _external_device_info_source;
@@ -32,6 +32,7 @@ void init_fwraid_filtering(int level);
 void init_pvmove(int level);
 void init_external_device_info_source(enum dev_ext_e src);
 void init_obtain_device_list_from_udev(int device_list_from_udev);
+void init_obtain_device_list_from_sysfs(int device_list_from_sysfs);
 void init_debug(int level);
 void init_debug_classes_logged(int classes);
 void init_cmd_name(int status);
@@ -64,6 +65,7 @@ int internal_filtering(void);
 int fwraid_filtering(void);
 int pvmove_mode(void);
 int obtain_device_list_from_udev(void);
+int obtain_device_list_from_sysfs(void);
 enum dev_ext_e external_device_info_source(void);
 int verbose_level(void);
 int silent_mode(void);
@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/time.h>
+#include <time.h>
 #include <sys/resource.h>
 #include <malloc.h>
 
@@ -145,6 +146,56 @@ static char _procselfmaps[PATH_MAX] = "";
 
 static size_t _mstats; /* statistic for maps locking */
 
+/*
+ * With activation/mlock_maps_cache, ranges stay locked after the
+ * critical section until the process exits, and later sections only
+ * mlock mappings (or their parts) that were not locked before.
+ * Both arrays are sorted by address like /proc/self/maps.
+ *
+ * A lock does not survive munmap, and a new mapping may be created at
+ * the address of an unmapped one.  So only file mappings are kept, and
+ * only while the mapping at the address has the same perms, offset,
+ * device and inode.  As a further check, every mapping with a skipped
+ * part must have the locked flag in /proc/self/smaps VmFlags, otherwise
+ * all maps are locked.
+ */
+struct maps_range {
+	unsigned long from;
+	unsigned long to;
+	unsigned long offset;
+	unsigned long inode;
+	unsigned long skip_to;		/* end of the part still locked before */
+	unsigned dev_major;
+	unsigned dev_minor;
+	char perms[4];
+};
+
+static unsigned _cache_maps;
+static struct maps_range *_locked_maps;	/* locked in previous sections */
+static unsigned _locked_maps_count;
+static unsigned _locked_maps_pos;
+static struct maps_range *_new_maps;	/* locked in this section */
+static unsigned _new_maps_count;
+static unsigned _maps_alloc;
+static uint64_t _locked_maps_skipped;	/* bytes not locked again */
+static char _procselfsmaps[PATH_MAX] = "";
+#define SELF_SMAPS "/self/smaps"
+
+/* timing statistics for maps locking */
+static unsigned _mstats_lock_count;
+static uint64_t _mstats_lock_usec;
+static uint64_t _mstats_unlock_usec;
+
+static uint64_t _usec_now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts))
+		return 0;
+
+	return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 static void _touch_memory(void *mem, size_t size)
 {
 	size_t pagesize = lvm_getpagesize();
@@ -239,15 +290,233 @@ static void _release_memory(void)
 	free(_malloc_mem);
 }
 
+/*
+ * Remember the mapping as locked and return the start of its part
+ * that was locked by a previous critical section for the same mapping.
+ */
+static unsigned long _locked_maps_update(const struct maps_range *map)
+{
+	const struct maps_range *old;
+	unsigned long start = map->from;
+
+	while ((_locked_maps_pos < _locked_maps_count) &&
+	       (_locked_maps[_locked_maps_pos].from < map->from))
+		_locked_maps_pos++;
+
+	if (_locked_maps_pos < _locked_maps_count) {
+		old = &_locked_maps[_locked_maps_pos];
+		if ((old->from == map->from) && map->inode &&
+		    (old->offset == map->offset) &&
+		    (old->inode == map->inode) &&
+		    (old->dev_major == map->dev_major) &&
+		    (old->dev_minor == map->dev_minor) &&
+		    !memcmp(old->perms, map->perms, sizeof(map->perms)))
+			start = (old->to < map->to) ? old->to : map->to;
+	}
+
+	if (_new_maps_count < _maps_alloc) {
+		_new_maps[_new_maps_count] = *map;
+		_new_maps[_new_maps_count++].skip_to = start;
+	}
+
+	_locked_maps_skipped += start - map->from;
+
+	return start;
+}
+
+static int _locked_maps_prepare(const char *maps)
+{
+	struct maps_range *new_maps;
+	unsigned lines = 0;
+
+	while ((maps = strchr(maps, '\n'))) {
+		maps++;
+		lines++;
+	}
+
+	if (lines > _maps_alloc) {
+		lines *= 2;
+		if (!(new_maps = realloc(_new_maps, lines * sizeof(*new_maps)))) {
+			log_error("Allocation of locked maps failed.");
+			return 0;
+		}
+		_new_maps = new_maps;
+		if (!(new_maps = realloc(_locked_maps, lines * sizeof(*new_maps)))) {
+			log_error("Allocation of locked maps failed.");
+			return 0;
+		}
+		_locked_maps = new_maps;
+		_maps_alloc = lines;
+	}
+
+	_locked_maps_pos = 0;
+	_new_maps_count = 0;
+	_locked_maps_skipped = 0;
+
+	return 1;
+}
+
+/*
+ * Return 1 when the address range of a smaps entry overlaps a part of
+ * a mapping that was skipped as still locked.  Entries come sorted by
+ * address, @pos keeps the position in _new_maps between calls.
+ */
+static int _locked_maps_skipped_range(unsigned long from, unsigned long to, unsigned *pos)
+{
+	unsigned i;
+
+	while ((*pos < _new_maps_count) && (_new_maps[*pos].to <= from))
+		(*pos)++;
+
+	for (i = *pos; (i < _new_maps_count) && (_new_maps[i].from < to); i++)
+		if ((_new_maps[i].skip_to > _new_maps[i].from) &&
+		    (_new_maps[i].skip_to > from))
+			return 1;
+
+	return 0;
+}
+
+/* Return 1 when the VmFlags of a smaps entry contain "lo" (VM_LOCKED). */
+static int _vmflags_locked(const char *flags)
+{
+	for (;;) {
+		while (*flags == ' ')
+			flags++;
+		if (!*flags)
+			return 0;
+		if ((flags[0] == 'l') && (flags[1] == 'o') &&
+		    (!flags[2] || (flags[2] == ' ')))
+			return 1;
+		while (*flags && (*flags != ' '))
+			flags++;
+	}
+}
+
+/*
+ * Check in /proc/self/smaps that every mapping with a part skipped as
+ * still locked really is locked.  Reads with a buffer on the stack, as
+ * this runs right before entering the critical section.
+ * Returns 0 when any of them is not locked or smaps cannot be checked.
+ */
+static int _locked_maps_check_smaps(void)
+{
+	char buf[PATH_MAX + 256];
+	char *line, *line_end;
+	unsigned long start, end, from = 0, to = 0;
+	unsigned pos = 0;
+	size_t len = 0;
+	ssize_t n;
+	int checking = 0, r = 1;
+	int fd;
+
+	if ((fd = open(_procselfsmaps, O_RDONLY)) < 0) {
+		log_sys_debug("open", _procselfsmaps);
+		return 0;
+	}
+
+	while (r) {
+		if ((n = read(fd, buf + len, sizeof(buf) - 1 - len)) <= 0) {
+			if (n < 0) {
+				log_sys_debug("read", _procselfsmaps);
+				r = 0;
+			}
+			break;
+		}
+		len += n;
+		buf[len] = '\0';
+
+		for (line = buf; r && (line_end = strchr(line, '\n')); line = line_end + 1) {
+			*line_end = '\0';
+			if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+				from = start;
+				to = end;
+				if (checking) {
+					log_debug_mem("No VmFlags in %s.", _procselfsmaps);
+					r = 0;
+				}
+				checking = _locked_maps_skipped_range(from, to, &pos);
+			} else if (checking && !strncmp(line, "VmFlags:", 8)) {
+				if (!_vmflags_locked(line + 8)) {
+					log_debug_mem("Mapping %lx - %lx is no longer locked.", from, to);
+					r = 0;
+				}
+				checking = 0;
+			}
+		}
+
+		len = buf + len - line;
+		if (len == sizeof(buf) - 1) {
+			log_debug_mem("Too long line in %s.", _procselfsmaps);
+			r = 0;
+		}
+		memmove(buf, line, len);
+	}
+
+	if (checking) {
+		log_debug_mem("No VmFlags in %s.", _procselfsmaps);
+		r = 0;
+	}
+
+	if (close(fd))
+		log_sys_debug("close", _procselfsmaps);
+
+	return r;
+}
+
+/*
+ * Every mapping skipped as still locked must be locked according to
+ * /proc/self/smaps, otherwise lock the whole of every map.
+ */
+static int _locked_maps_verify(void)
+{
+	unsigned i;
+	int r = 1;
+
+	if (!_locked_maps_skipped || _locked_maps_check_smaps())
+		return 1;
+
+	log_debug_mem("Skipped %" PRIu64 " bytes not verified as locked, locking all maps.",
+		      _locked_maps_skipped);
+
+	for (i = 0; i < _new_maps_count; i++)
+		if (mlock((const void *) _new_maps[i].from, _new_maps[i].to - _new_maps[i].from) < 0) {
+			log_sys_error("mlock", "");
+			r = 0;
+		}
+
+	return r;
+}
+
+static void _locked_maps_commit(void)
+{
+	struct maps_range *maps = _locked_maps;
+
+	_locked_maps = _new_maps;
+	_locked_maps_count = _new_maps_count;
+	_new_maps = maps;
+	_new_maps_count = 0;
+}
+
+static void _locked_maps_release(void)
+{
+	free(_locked_maps);
+	free(_new_maps);
+	_locked_maps = _new_maps = NULL;
+	_locked_maps_count = _new_maps_count = _maps_alloc = 0;
+}
+
 /*
  * mlock/munlock memory areas from /proc/self/maps
  * format described in kernel/Documentation/filesystem/proc.txt
  */
 static int _maps_line(const struct dm_config_node *cn, lvmlock_t lock,
-		      const char *line, size_t *mstats)
+		      const char *line, size_t *mstats, size_t *mnew)
 {
+	unsigned long start;
 	const struct dm_config_value *cv;
+	struct maps_range map = { 0 };
 	unsigned long from, to;
+	unsigned new_maps_count;
 	int pos;
 	unsigned i;
 	char fr, fw, fx, fp;
@@ -310,12 +579,34 @@ static int _maps_line(const struct dm_config_node *cn, lvmlock_t lock,
 	log_debug_mem("%s %10ldKiB %12lx - %12lx %c%c%c%c%s", lock_str,
 		      ((long)sz + 1023) / 1024, from, to, fr, fw, fx, fp, line + pos);
 
+	if (!sz)
+		return 1;
+
 	if (lock == LVM_MLOCK) {
-		if (mlock((const void*)from, sz) < 0) {
+		start = from;
+		new_maps_count = _new_maps_count;
+		if (_cache_maps) {
+			map.from = from;
+			map.to = to;
+			map.perms[0] = fr;
+			map.perms[1] = fw;
+			map.perms[2] = fx;
+			map.perms[3] = fp;
+			if (sscanf(line + pos, " %lx %x:%x %lu", &map.offset,
+				   &map.dev_major, &map.dev_minor, &map.inode) != 4)
+				log_debug_mem("Failed to parse maps line ids: %s", line);
+			else
+				start = _locked_maps_update(&map);
+		}
+		if (start >= to)
+			return 1; /* still locked */
+		*mnew += to - start;
+		if (mlock((const void*)start, to - start) < 0) {
 			log_sys_error("mlock", line);
+			_new_maps_count = new_maps_count; /* not locked */
 			return 0;
 		}
-	} else {
+	} else if (!_cache_maps) {
 		if (munlock((const void*)from, sz) < 0) {
 			log_sys_error("munlock", line);
 			return 0;
@@ -330,6 +621,7 @@ static int _memlock_maps(struct cmd_context *cmd, lvmlock_t lock, size_t *mstats
 	const struct dm_config_node *cn;
 	char *line, *line_end;
 	size_t len;
+	size_t mnew = 0;
 	ssize_t n;
 	int ret = 1;
 
@@ -386,15 +678,31 @@ static int _memlock_maps(struct cmd_context *cmd, lvmlock_t lock, size_t *mstats
 	line = _maps_buffer;
 	cn = find_config_tree_array(cmd, activation_mlock_filter_CFG, NULL);
 
+	if (_cache_maps && (lock == LVM_MLOCK) &&
+	    !_locked_maps_prepare(_maps_buffer)) {
+		_locked_maps_release();
+		_cache_maps = 0;
+	}
+
 	while ((line_end = strchr(line, '\n'))) {
 		*line_end = '\0'; /* remove \n */
-		if (!_maps_line(cn, lock, line, mstats))
+		if (!_maps_line(cn, lock, line, mstats, &mnew))
 			ret = 0;
 		line = line_end + 1;
 	}
 
-	log_debug_mem("%socked %ld bytes",
-		      (lock == LVM_MLOCK) ? "L" : "Unl", (long)*mstats);
+	if (_cache_maps && (lock == LVM_MLOCK)) {
+		if (!_locked_maps_verify())
+			ret = 0;
+		_locked_maps_commit();
+	}
+
+	if (lock == LVM_MLOCK)
+		log_debug_mem("Locked %ld bytes, %ld bytes newly locked.",
+			      (long)*mstats, (long)mnew);
+	else
+		log_debug_mem("%s %ld bytes.", _cache_maps ? "Keeping locked" : "Unlocked",
+			      (long)*mstats);
 
 	return ret;
 }
@@ -525,6 +833,8 @@ static void _restore_priority_if_possible(struct cmd_context *cmd)
 /* Stop memory getting swapped out */
 static void _lock_mem(struct cmd_context *cmd)
 {
+	uint64_t start;
+
 	_allocate_memory();
 	(void)strerror(0);		/* Force libc.mo load */
 	(void)dm_udev_get_sync_support(); /* udev is initialized */
@@ -547,6 +857,14 @@ static void _lock_mem(struct cmd_context *cmd)
 			return;
 		}
 
+		if (_cache_maps && !*_procselfsmaps &&
+		    dm_snprintf(_procselfsmaps, sizeof(_procselfsmaps),
+				"%s" SELF_SMAPS, cmd->proc_dir) < 0) {
+			log_debug_mem("proc_dir too long, not caching locked maps.");
+			_locked_maps_release();
+			_cache_maps = 0;
+		}
+
 		if (!(_maps_fd = open(_procselfmaps, O_RDONLY))) {
 			log_sys_error("open", _procselfmaps);
 			return;
@@ -556,19 +874,32 @@ static void _lock_mem(struct cmd_context *cmd)
 			stack;
 	}
 
+	start = _usec_now();
+
 	if (!_memlock_maps(cmd, LVM_MLOCK, &_mstats))
 		stack;
+
+	_mstats_lock_usec += _usec_now() - start;
+	_mstats_lock_count++;
 }
 
 static void _unlock_mem(struct cmd_context *cmd)
 {
 	size_t unlock_mstats = 0;
+	uint64_t start;
 
 	log_very_verbose("Unlocking memory");
 
+	start = _usec_now();
+
 	if (!_memlock_maps(cmd, LVM_MUNLOCK, &unlock_mstats))
 		stack;
 
+	_mstats_unlock_usec += _usec_now() - start;
+
+	log_debug_mem("Memory locked %u times in %" PRIu64 " usec, unlocked in %" PRIu64 " usec.",
+		      _mstats_lock_count, _mstats_lock_usec, _mstats_unlock_usec);
+
 	if (!_use_mlockall) {
 		_restore_mmap();
 		if (close(_maps_fd))
@@ -698,6 +1029,7 @@ void memlock_init(struct cmd_context *cmd)
 				 find_config_tree_int(cmd, activation_reserved_stack_CFG, NULL));
 	_size_malloc_tmp = find_config_tree_int(cmd, activation_reserved_memory_CFG, NULL) * 1024ULL;
 	_default_priority = find_config_tree_int(cmd, activation_process_priority_CFG, NULL);
+	_cache_maps = find_config_tree_bool(cmd, activation_mlock_maps_cache_CFG, NULL);
 }
 
 void memlock_reset(void)
@@ -708,6 +1040,8 @@ void memlock_reset(void)
 	_critical_section = 0;
 	_prioritized_section = 0;
 	_memlock_count_daemon = 0;
+	/* Memory locks are not inherited by a forked child. */
+	_locked_maps_release();
 }
 
 void memlock_unlock(struct cmd_context *cmd)
@@ -25,7 +25,9 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <netinet/in.h>
+#include <sys/socket.h>
 #include <sys/un.h>
+#include <poll.h>
 #include <unistd.h>
 #include <signal.h>
 
@@ -48,9 +50,57 @@ static int _pthread_create(pthread_t *t, void *(*fun)(void *), void *arg, int st
 static volatile sig_atomic_t _shutdown_requested = 0;
 static int _systemd_activation = 0;
 
+/*
+ * Client connections are watched by the main loop.  Once a complete
+ * request is read, the connection is queued for the pool of worker
+ * threads and it is not watched until the worker sent the reply.
+ */
+enum client_conn_state {
+	CLIENT_READING,		/* Main loop reads the request */
+	CLIENT_QUEUED,		/* Owned by a worker until replied */
+	CLIENT_DONE,		/* Reply sent, wait for next request */
+	CLIENT_FAILED,		/* Worker failed, connection is closed */
+};
+
+struct client_conn {
+	struct dm_list list;	/* Main loop only */
+	struct dm_list queue;	/* Protected by _server.lock */
+	client_handle client;
+	request req;
+	enum client_conn_state state;	/* Protected by _server.lock */
+};
+
+static struct {
+	daemon_state s;		/* Copy handed to request handlers */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	struct dm_list queue;	/* Connections with a request to handle */
+	struct dm_list clients;	/* All connections, main loop only */
+	int stop;
+	int wake_pipe[2];
+	pthread_t *workers;
+	int worker_count;
+} _server = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+	.wake_pipe = { -1, -1 },
+};
+
+/* Async signal safe. */
+static void _wake_main_loop(void)
+{
+	int saved_errno = errno;
+
+	if (_server.wake_pipe[1] >= 0)
+		(void) !write(_server.wake_pipe[1], "", 1);
+
+	errno = saved_errno;
+}
+
 static void _exit_handler(int sig __attribute__((unused)))
 {
 	_shutdown_requested = 1;
+	_wake_main_loop();
 }
 
 #define EXIT_ALREADYRUNNING 13
@@ -82,7 +132,7 @@ static void _exit_handler(int sig __attribute__((unused)))
 
 static int _is_idle(daemon_state s)
 {
-	return s.idle && s.idle->is_idle && !s.threads->next;
+	return s.idle && s.idle->is_idle && dm_list_empty(&_server.clients);
 }
 
 static struct timespec *_get_timeout(daemon_state s)
@@ -448,59 +498,161 @@ static response _builtin_handler(daemon_state s, client_handle h, request r)
 	return res;
 }
 
-static void *_client_thread(void *state)
+/* Handle one request read by the main loop.  Runs in a worker thread. */
+static int _handle_request(daemon_state s, struct client_conn *conn)
 {
-	thread_state *ts = state;
-	request req;
+	request *req = &conn->req;
 	response res;
+	int r;
 
-	buffer_init(&req.buffer);
+	req->cft = config_tree_from_string_without_dup_node_check(req->buffer.mem);
 
-	while (1) {
-		if (!buffer_read(ts->client.socket_fd, &req.buffer))
-			goto fail;
-
-		req.cft = config_tree_from_string_without_dup_node_check(req.buffer.mem);
+	if (!req->cft)
+		fprintf(stderr, "error parsing request:\n %s\n", req->buffer.mem);
+	else
+		daemon_log_cft(s.log, DAEMON_LOG_WIRE, "<- ", req->cft->root);
 
-		if (!req.cft)
-			fprintf(stderr, "error parsing request:\n %s\n", req.buffer.mem);
-		else
-			daemon_log_cft(ts->s.log, DAEMON_LOG_WIRE, "<- ", req.cft->root);
+	res = _builtin_handler(s, conn->client, *req);
 
-		res = _builtin_handler(ts->s, ts->client, req);
+	if (res.error == EPROTO) /* Not a builtin, delegate to the custom handler. */
+		res = s.handler(s, conn->client, *req);
 
-		if (res.error == EPROTO) /* Not a builtin, delegate to the custom handler. */
-			res = ts->s.handler(ts->s, ts->client, req);
+	if (req->cft) {
+		dm_config_destroy(req->cft);
+		req->cft = NULL;
+	}
+	buffer_destroy(&req->buffer);
 
-		if (!res.buffer.mem) {
-			if (!dm_config_write_node(res.cft->root, buffer_line, &res.buffer))
-				goto fail;
-			if (!buffer_append(&res.buffer, "\n\n"))
-				goto fail;
+	if (!res.buffer.mem) {
+		if (!dm_config_write_node(res.cft->root, buffer_line, &res.buffer) ||
+		    !buffer_append(&res.buffer, "\n\n")) {
 			dm_config_destroy(res.cft);
+			buffer_destroy(&res.buffer);
+			return 0;
 		}
+		dm_config_destroy(res.cft);
+	}
+
+	daemon_log_multi(s.log, DAEMON_LOG_WIRE, "-> ", res.buffer.mem);
+	r = buffer_write(conn->client.socket_fd, &res.buffer);
 
-		if (req.cft)
-			dm_config_destroy(req.cft);
-		buffer_destroy(&req.buffer);
+	buffer_destroy(&res.buffer);
 
-		daemon_log_multi(ts->s.log, DAEMON_LOG_WIRE, "-> ", res.buffer.mem);
-		buffer_write(ts->client.socket_fd, &res.buffer);
+	return r;
+}
 
-		buffer_destroy(&res.buffer);
+static void *_worker_thread(void *arg __attribute__((unused)))
+{
+	struct client_conn *conn;
+	int r;
+
+	pthread_mutex_lock(&_server.lock);
+
+	/* On stop, requests already queued are still replied. */
+	while (1) {
+		while (!_server.stop && dm_list_empty(&_server.queue))
+			pthread_cond_wait(&_server.cond, &_server.lock);
+
+		if (dm_list_empty(&_server.queue))
+			break;
+
+		conn = dm_list_struct_base(dm_list_first(&_server.queue),
+					   struct client_conn, queue);
+		dm_list_del(&conn->queue);
+		pthread_mutex_unlock(&_server.lock);
+
+		conn->client.thread_id = pthread_self();
+		r = _handle_request(_server.s, conn);
+
+		pthread_mutex_lock(&_server.lock);
+		conn->state = r ? CLIENT_DONE : CLIENT_FAILED;
+		_wake_main_loop();
 	}
-fail:
-	/* TODO what should we really do here? */
-	if (close(ts->client.socket_fd))
-		perror("close");
-	buffer_destroy(&req.buffer);
-	ts->active = 0;
+
+	pthread_mutex_unlock(&_server.lock);
+
 	return NULL;
 }
 
-static int _handle_connect(daemon_state s)
+static int _start_workers(daemon_state s)
+{
+	pthread_attr_t attr;
+	int count = s.worker_threads ? : DAEMON_WORKER_THREADS;
+
+	if (pipe(_server.wake_pipe)) {
+		ERROR(&s, "Failed to create wake up pipe: %s.", strerror(errno));
+		return 0;
+	}
+
+	if (fcntl(_server.wake_pipe[0], F_SETFL, O_NONBLOCK) ||
+	    fcntl(_server.wake_pipe[1], F_SETFL, O_NONBLOCK) ||
+	    fcntl(_server.wake_pipe[0], F_SETFD, FD_CLOEXEC) ||
+	    fcntl(_server.wake_pipe[1], F_SETFD, FD_CLOEXEC)) {
+		ERROR(&s, "Failed to set up wake up pipe: %s.", strerror(errno));
+		return 0;
+	}
+
+	if (!(_server.workers = calloc(count, sizeof(*_server.workers)))) {
+		ERROR(&s, "Failed to allocate worker threads.");
+		return 0;
+	}
+
+	if (pthread_attr_init(&attr))
+		return 0;
+
+	if (s.thread_stack_size)
+		(void) pthread_attr_setstacksize(&attr, s.thread_stack_size + getpagesize());
+
+	_server.s = s;
+
+	for (; _server.worker_count < count; _server.worker_count++)
+		if ((errno = pthread_create(&_server.workers[_server.worker_count],
+					    &attr, _worker_thread, NULL))) {
+			ERROR(&s, "Failed to create worker thread: %s.", strerror(errno));
+			break;
+		}
+
+	(void) pthread_attr_destroy(&attr);
+
+	return (_server.worker_count == count);
+}
+
+static void _close_client(struct client_conn *conn)
+{
+	dm_list_del(&conn->list);
+	if (close(conn->client.socket_fd))
+		perror("close");
+	buffer_destroy(&conn->req.buffer);
+	free(conn);
+}
+
+static void _stop_workers(daemon_state s)
+{
+	struct client_conn *conn, *tmp;
+	int i;
+
+	pthread_mutex_lock(&_server.lock);
+	_server.stop = 1;
+	pthread_cond_broadcast(&_server.cond);
+	pthread_mutex_unlock(&_server.lock);
+
+	for (i = 0; i < _server.worker_count; i++)
+		if ((errno = pthread_join(_server.workers[i], NULL)))
+			ERROR(&s, "pthread_join failed: %s", strerror(errno));
+
+	dm_list_iterate_items_safe(conn, tmp, &_server.clients)
+		_close_client(conn);
+
+	free(_server.workers);
+
+	for (i = 0; i < 2; i++)
+		if ((_server.wake_pipe[i] >= 0) && close(_server.wake_pipe[i]))
+			perror("close");
+}
+
+static void _handle_connect(daemon_state s)
 {
-	thread_state *ts;
+	struct client_conn *conn;
 	struct sockaddr_un sockaddr;
 	client_handle client = { .thread_id = 0 };
 	socklen_t sl = sizeof(sockaddr);
@@ -509,7 +661,7 @@ static int _handle_connect(daemon_state s)
 	if (client.socket_fd < 0) {
 		if (errno != EAGAIN)
 			ERROR(&s, "Failed to accept connection: %s.", strerror(errno));
-		goto bad;
+		return;
 	}
 
 	if (_shutdown_requested) {
@@ -520,62 +672,93 @@ static int _handle_connect(daemon_state s)
 	if (fcntl(client.socket_fd, F_SETFD, FD_CLOEXEC))
 		WARN(&s, "setting CLOEXEC on client socket fd %d failed", client.socket_fd);
 
-	if (!(ts = malloc(sizeof(thread_state)))) {
-		ERROR(&s, "Failed to allocate thread state");
+	if (!(conn = zalloc(sizeof(*conn)))) {
+		ERROR(&s, "Failed to allocate client state");
 		goto bad;
 	}
 
-	ts->next = s.threads->next;
-	s.threads->next = ts;
+	conn->client = client;
+	conn->state = CLIENT_READING;
+	buffer_init(&conn->req.buffer);
+	dm_list_add(&_server.clients, &conn->list);
 
-	ts->active = 1;
-	ts->s = s;
-	ts->client = client;
+	return;
+bad:
+	if (close(client.socket_fd))
+		perror("close");
+}
 
-	if ((errno = pthread_create(&ts->client.thread_id, NULL, _client_thread, ts))) {
-		ERROR(&s, "Failed to create client thread: %s.", strerror(errno));
-		ts->active = 0;
-		goto bad;
+/*
+ * Read what the client has sent so far without blocking, and queue
+ * the connection for workers when the request is complete.
+ * Returns 0 when the connection should be closed.
+ */
+static int _client_read(struct client_conn *conn)
+{
+	struct buffer *b = &conn->req.buffer;
+	ssize_t result;
+
+	while (1) {
+		if ((b->allocated - b->used < 32) &&
+		    !buffer_realloc(b, b->allocated ? 1024 : 32))
+			return 0;
+
+		result = recv(conn->client.socket_fd, b->mem + b->used,
+			      b->allocated - b->used, MSG_DONTWAIT);
+		if (result > 0) {
+			b->used += result;
+			if (b->used >= 4 && !strncmp(b->mem + b->used - 4, "\n##\n", 4)) {
+				b->used -= 4;
+				b->mem[b->used] = 0;
+				break; /* success, we have the full message now */
+			}
+		} else if (!result)
+			return 0; /* client closed connection */
+		else if (errno != EINTR)
+			return (errno == EAGAIN);
 	}
 
-	return 1;
-bad:
-	if ((client.socket_fd >= 0) && close(client.socket_fd))
-		perror("close");
+	pthread_mutex_lock(&_server.lock);
+	conn->state = CLIENT_QUEUED;
+	dm_list_add(&_server.queue, &conn->queue);
+	pthread_cond_signal(&_server.cond);
+	pthread_mutex_unlock(&_server.lock);
 
-	return 0;
+	return 1;
 }
 
-static void _reap(daemon_state s, int waiting)
+/* Take back connections from workers, return number of those to watch. */
+static unsigned _collect_clients(void)
 {
-	thread_state *last = s.threads, *ts = last->next;
-	void *rv;
-
-	while (ts) {
-		if (waiting || !ts->active) {
-			if (ts->client.thread_id) {
-				if ((errno = pthread_kill(ts->client.thread_id, SIGTERM)) &&
-				    (errno != ESRCH))
-					ERROR(&s, "pthread_kill failed for pid %ld",
-					      (long)ts->client.thread_id);
-				if ((errno = pthread_join(ts->client.thread_id, &rv)))
-					ERROR(&s, "pthread_join failed: %s", strerror(errno));
-			}
-			last->next = ts->next;
-			free(ts);
-		} else
-			last = ts;
-		ts = last->next;
+	struct client_conn *conn, *tmp;
+	unsigned count = 0;
+	char buf[64];
+
+	while (read(_server.wake_pipe[0], buf, sizeof(buf)) > 0)
+		;
+
+	pthread_mutex_lock(&_server.lock);
+	dm_list_iterate_items_safe(conn, tmp, &_server.clients) {
+		if (conn->state == CLIENT_FAILED)
+			_close_client(conn);
+		else if (conn->state != CLIENT_QUEUED) {
+			conn->state = CLIENT_READING;
+			count++;
+		}
 	}
+	pthread_mutex_unlock(&_server.lock);
+
+	return count;
 }
 
 void daemon_start(daemon_state s)
 {
 	int failed = 0;
 	log_state _log = { { 0 } };
-	thread_state _threads = { .next = NULL };
 	unsigned timeout_count = 0;
-	fd_set in;
+	struct pollfd *fds = NULL;
+	struct client_conn **fd_clients = NULL, *conn;
+	unsigned i, nfds, fds_size = 0;
 	sigset_t new_set, old_set;
 	int ret;
 
@@ -596,7 +779,8 @@ void daemon_start(daemon_state s)
 
 	s.log = &_log;
 	s.log->name = s.name;
-	s.threads = &_threads;
+	dm_list_init(&_server.queue);
+	dm_list_init(&_server.clients);
 
 	/* Log important things to syslog by default. */
 	daemon_log_enable(s.log, DAEMON_LOG_OUTLET_SYSLOG, DAEMON_LOG_FATAL, 1);
@@ -659,8 +843,8 @@ void daemon_start(daemon_state s)
 		if (!s.daemon_init(&s))
 			failed = 1;
 
-	if (s.socket_fd >= FD_SETSIZE)
-		failed = 1; /* FD out of available selectable set */
+	if (!failed && !_start_workers(s))
+		failed = 1;
 
 	sigfillset(&new_set);
 	if (sigprocmask(SIG_SETMASK, NULL, &old_set))
@@ -668,30 +852,53 @@ void daemon_start(daemon_state s)
 
 	while (!failed && !_shutdown_requested) {
 		_reset_timeout(s);
-		FD_ZERO(&in);
-		FD_SET(s.socket_fd, &in);
+
+		nfds = 2 + _collect_clients();
+		if (nfds > fds_size) {
+			fds_size = nfds * 2;
+			free(fds);
+			free(fd_clients);
+			if (!(fds = malloc(fds_size * sizeof(*fds))) ||
+			    !(fd_clients = malloc(fds_size * sizeof(*fd_clients)))) {
+				ERROR(&s, "Failed to allocate poll descriptors.");
+				failed = 1;
+				break;
+			}
+		}
+
+		fds[0] = (struct pollfd) { .fd = s.socket_fd, .events = POLLIN };
+		fds[1] = (struct pollfd) { .fd = _server.wake_pipe[0], .events = POLLIN };
+		nfds = 2;
+		/* Only the main loop moves connections to CLIENT_QUEUED. */
+		dm_list_iterate_items(conn, &_server.clients)
+			if (conn->state == CLIENT_READING) {
+				fd_clients[nfds] = conn;
+				fds[nfds++] = (struct pollfd) { .fd = conn->client.socket_fd, .events = POLLIN };
+			}
 
 		if (sigprocmask(SIG_SETMASK, &new_set, NULL))
 			perror("sigprocmask error");
-		ret = pselect(s.socket_fd + 1, &in, NULL, NULL, _get_timeout(s), &old_set);
+		ret = ppoll(fds, nfds, _get_timeout(s), &old_set);
 		if (sigprocmask(SIG_SETMASK, &old_set, NULL))
 			perror("sigprocmask error");
 
 		if (ret < 0) {
 			if ((errno != EINTR) && (errno != EAGAIN))
-				perror("select error");
-			_reap(s, 0);
+				perror("poll error");
 			continue;
 		}
 
-		if (FD_ISSET(s.socket_fd, &in)) {
+		for (i = 2; i < nfds; i++)
+			if (fds[i].revents && !_client_read(fd_clients[i]))
+				_close_client(fd_clients[i]);
+
+		if (fds[0].revents & POLLIN) {
 			timeout_count = 0;
 			_handle_connect(s);
 		}
-		_reap(s, 0);
 
 		/* s.idle == NULL equals no shutdown on timeout */
-		if (_is_idle(s)) {
+		if (!ret && _is_idle(s)) {
 			DEBUGLOG(&s, "timeout occured");
 			if (++timeout_count >= _get_max_timeouts(s)) {
 				INFO(&s, "Inactive for %d seconds. Exiting.", timeout_count);
@@ -703,8 +910,10 @@ void daemon_start(daemon_state s)
 	if (_shutdown_requested)
 		INFO(&s, "%s shutdown requested", s.name);
 
-	INFO(&s, "%s waiting for client threads to finish", s.name);
-	_reap(s, 1);
+	INFO(&s, "%s waiting for client requests to finish", s.name);
+	_stop_workers(s);
+	free(fds);
+	free(fd_clients);
 out:
 	/* If activated by systemd, do not unlink the socket - systemd takes care of that! */
 	if (!_systemd_activation && s.socket_fd >= 0)
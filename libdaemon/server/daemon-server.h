@@ -85,7 +85,8 @@ typedef struct {
 	const char *name;
 } log_state;
 
-struct thread_state;
+/* Default number of threads handling client requests. */
+#define DAEMON_WORKER_THREADS 4
 
 typedef struct daemon_state {
 	/*
@@ -95,6 +96,12 @@ typedef struct daemon_state {
 	 */
 	int thread_stack_size;
 
+	/*
+	 * Requests from all clients are handled by a fixed pool of
+	 * this many threads, 0 selects DAEMON_WORKER_THREADS.
+	 */
+	int worker_threads;
+
 	/* Flags & attributes affecting the behaviour of the daemon. */
 	unsigned avoid_oom:1;
 	unsigned foreground:1;
@@ -113,7 +120,6 @@ typedef struct daemon_state {
 	int socket_fd;
 
 	log_state *log;
-	struct thread_state *threads;
 
 	/* suport for shutdown on idle */
 	daemon_idle *idle;
@@ -121,13 +127,6 @@ typedef struct daemon_state {
 	void *private; /* the global daemon state */
 } daemon_state;
 
-typedef struct thread_state {
-	daemon_state s;
-	client_handle client;
-	struct thread_state *next;
-	volatile int active;
-} thread_state;
-
 /*
  * Start serving the requests. This does all the daemonisation, socket setup
  * work and so on. This function takes over the process, and upon failure, it
@@ -859,10 +859,114 @@ out:
 	return r;
 }
 
+/*
+ * Stats handles kept between the intervals of a repeating report: each
+ * device is bound and listed once, and the devices already known are
+ * sampled together by _sweep_stats_handles() at the start of every
+ * following interval.
+ */
+struct stats_handle {
+	struct dm_list list;
+	uint32_t major;
+	uint32_t minor;
+	char *name;
+	struct dm_stats *dms;
+	int sampled; /* sampled by the sweep for this interval */
+};
+
+static DM_LIST_INIT(_stats_handles);
+
+static void _destroy_stats_handle(struct stats_handle *sh)
+{
+	dm_list_del(&sh->list);
+	dm_stats_destroy(sh->dms);
+	dm_free(sh->name);
+	dm_free(sh);
+}
+
+static void _destroy_stats_handles(void)
+{
+	struct stats_handle *sh, *tmp;
+
+	dm_list_iterate_items_safe(sh, tmp, &_stats_handles)
+		_destroy_stats_handle(sh);
+}
+
+static void _sweep_stats_handles(void)
+{
+	struct dm_stats_sweep *sweep;
+	struct stats_handle *sh, *tmp;
+
+	if (dm_list_empty(&_stats_handles))
+		return;
+
+	/* Without a sweep each device is sampled as it is reported. */
+	if (!(sweep = dm_stats_sweep_create(0))) {
+		stack;
+		return;
+	}
+
+	dm_list_iterate_items(sh, &_stats_handles)
+		if (!dm_stats_sweep_add(sweep, sh->dms))
+			goto_out;
+
+	if (!dm_stats_sweep_run(sweep, _program_id))
+		stack;
+
+	/* Drop handles of devices that could not be sampled. */
+	dm_list_iterate_items_safe(sh, tmp, &_stats_handles)
+		if (!(sh->sampled = (dm_stats_get_nr_samples(sh->dms) > 0)))
+			_destroy_stats_handle(sh);
+out:
+	dm_stats_sweep_destroy(sweep);
+}
+
+static struct stats_handle *_get_stats_handle(struct dm_task *dmt,
+					      struct dm_info *info)
+{
+	const char *name = dm_task_get_name(dmt);
+	struct stats_handle *sh;
+
+	dm_list_iterate_items(sh, &_stats_handles)
+		if ((sh->major == info->major) && (sh->minor == info->minor)) {
+			if (!strcmp(sh->name, name))
+				return sh;
+			/* Device number reused by another device. */
+			_destroy_stats_handle(sh);
+			break;
+		}
+
+	if (!(sh = dm_zalloc(sizeof(*sh))))
+		return_NULL;
+
+	if (!(sh->name = dm_strdup(name)) ||
+	    !(sh->dms = dm_stats_create(DM_STATS_PROGRAM_ID)))
+		goto_bad;
+
+	if (!dm_stats_bind_devno(sh->dms, info->major, info->minor) ||
+	    !dm_stats_set_history(sh->dms, 1))
+		goto_bad;
+
+	sh->major = info->major;
+	sh->minor = info->minor;
+	dm_list_add(&_stats_handles, &sh->list);
+
+	return sh;
+
+bad:
+	if (sh->dms)
+		dm_stats_destroy(sh->dms);
+	dm_free(sh->name);
+	dm_free(sh);
+	return NULL;
+}
+
 static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 {
 	struct dmsetup_report_obj obj;
+	struct stats_handle *sh;
 	uint64_t walk_flags = _statstype;
+	int keep_stats = 0;
 	int r = 0;
 	int selected;
 	char *device_name;
@@ -910,7 +1014,25 @@ static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 	 * Obtain statistics for the current reporting object and set
 	 * the interval estimate used for stats rate conversion.
 	 */
-	if (_report_type & DR_STATS) {
+	if ((_report_type & DR_STATS) && _timer_running()) {
+		if (!(sh = _get_stats_handle(dmt, info)))
+			goto_out;
+
+		obj.stats = sh->dms;
+		keep_stats = 1;
+
+		if (sh->sampled)
+			sh->sampled = 0;
+		else if (!dm_stats_sample(obj.stats, _program_id)) {
+			r = 1;
+			goto out;
+		}
+
+		if (!dm_stats_get_nr_regions(obj.stats)) {
+			r = 1;
+			goto out;
+		}
+	} else if (_report_type & DR_STATS) {
 		if (!(obj.stats = dm_stats_create(DM_STATS_PROGRAM_ID)))
 			goto_out;
 
@@ -920,6 +1042,9 @@ static int _display_info_cols(struct dm_task *dmt, struct dm_info *info)
 			r = 1;
 			goto out;
 		}
+	}
+
+	if (_report_type & DR_STATS) {
 
 		/* Update timestamps and handle end-of-interval accounting. */
 		_update_interval_times();
@@ -966,7 +1091,7 @@ out:
 		dm_task_destroy(obj.deps_task);
 	if (obj.split_name)
 		_destroy_split_name(obj.split_name);
-	if (obj.stats)
+	if (obj.stats && !keep_stats)
 		dm_stats_destroy(obj.stats);
 	return r;
 }
@@ -7470,6 +7595,9 @@ doit:
 			    (argc || (!_switches[UUID_ARG] && !_switches[MAJOR_ARG])));
 
 	do {
+		if (_report && (_report_type & DR_STATS) && _timer_running())
+			_sweep_stats_handles();
+
 		r = _perform_command_for_all_repeatable_args(cmd, subcommand, argc, argv, NULL, multiple_devices);
 		if (_concise_output_produced) {
 			putchar('\n');
@@ -7505,6 +7633,8 @@ out:
 	if (_dtree)
 		dm_tree_free(_dtree);
 
+	_destroy_stats_handles();
+
 	free(_table);
 
 	if (_initial_timestamp)
@@ -2038,6 +2038,20 @@ int dm_task_get_errno(struct dm_task *dmt)
 	return dmt->ioctl_errno;
 }
 
+/*
+ * Later ioctls start with the largest buffer needed so far.  Raise the
+ * shared factor without losing a larger value set by another thread.
+ */
+static void _ioctl_buffer_factor_raise(unsigned factor)
+{
+	unsigned cur = __atomic_load_n(&_ioctl_buffer_double_factor, __ATOMIC_RELAXED);
+
+	while (cur < factor &&
+	       !__atomic_compare_exchange_n(&_ioctl_buffer_double_factor, &cur, factor,
+					    0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
 int dm_task_run(struct dm_task *dmt)
 {
 	struct dm_ioctl *dmi;
@@ -2046,6 +2060,7 @@ int dm_task_run(struct dm_task *dmt)
 	int rely_on_udev;
 	int suspended_counter;
 	unsigned ioctl_retry = 1;
+	unsigned buffer_factor;
 	int retryable = 0;
 	const char *dev_name = DEV_NAME(dmt);
 	const char *dev_uuid = DEV_UUID(dmt);
@@ -2094,8 +2109,9 @@ int dm_task_run(struct dm_task *dmt)
 			  dmt->major > 0 ? ") " : "");
 
 	/* FIXME Detect and warn if cookie set but should not be. */
+	buffer_factor = __atomic_load_n(&_ioctl_buffer_double_factor, __ATOMIC_RELAXED);
 repeat_ioctl:
-	if (!(dmi = _do_dm_ioctl(dmt, command, _ioctl_buffer_double_factor,
+	if (!(dmi = _do_dm_ioctl(dmt, command, buffer_factor,
 				 ioctl_retry, &retryable))) {
 		/*
 		 * Async udev rules that scan devices commonly cause transient
@@ -2122,7 +2138,7 @@ repeat_ioctl:
 		case DM_DEVICE_TABLE:
 		case DM_DEVICE_WAITEVENT:
 		case DM_DEVICE_TARGET_MSG:
-			_ioctl_buffer_double_factor++;
+			_ioctl_buffer_factor_raise(++buffer_factor);
 			_dm_zfree_dmi(dmi);
 			goto repeat_ioctl;
 		default:
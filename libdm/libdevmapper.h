@@ -458,10 +458,10 @@ int dm_get_status_thin(struct dm_pool *mem, const char *params,
  * Internally the dm_stats handle contains a pointer to a table of one
  * or more dm_stats_region objects representing the regions registered
  * with the dm_stats_create_region() method. These in turn point to a
- * table of one or more dm_stats_counters objects containing the
- * counter sets for each defined area within the region:
+ * dm_stats_counters object holding one column of values per counter,
+ * with an entry for each defined area within the region:
  *
- * dm_stats->dm_stats_region[nr_regions]->dm_stats_counters[nr_areas]
+ * dm_stats->dm_stats_region[nr_regions]->dm_stats_counters->values[nr_counters][nr_areas]
  *
  * This structure is private to the library and may change in future
  * versions: all users should make use of the public interface and treat
@@ -605,6 +605,77 @@ int dm_stats_list(struct dm_stats *dms, const char *program_id);
 int dm_stats_populate(struct dm_stats *dms, const char *program_id,
 		      uint64_t region_id);
 
+/*
+ * Keep a history of the last nr_samples samples taken with
+ * dm_stats_sample() for every area of every region of the bound device.
+ *
+ * Storage for the history is allocated once for the current region
+ * layout and is only rebuilt when the set of regions changes.
+ * Changing the history length discards any samples already taken.
+ */
+int dm_stats_set_history(struct dm_stats *dms, unsigned nr_samples);
+
+/*
+ * Take a sample of all regions selected by program_id (interpreted as
+ * for dm_stats_populate()) into the sample history of dms and clear
+ * the kernel counters.
+ *
+ * The region and group layout of the handle is kept between calls and
+ * revalidated with a single @stats_list message: regions are only
+ * re-read when it has changed, in which case the previous samples are
+ * discarded.
+ *
+ * On success the counters of the new sample become the current values
+ * returned by dm_stats_get_counter() and dm_stats_get_metric(), and the
+ * sampling interval is set to the time since the previous sample.
+ */
+int dm_stats_sample(struct dm_stats *dms, const char *program_id);
+
+/*
+ * Return the number of samples currently held in the history of dms.
+ */
+unsigned dm_stats_get_nr_samples(const struct dm_stats *dms);
+
+/*
+ * Copy the time at which the most recent sample of dms was taken into
+ * ts. Returns zero if the history holds no samples.
+ */
+int dm_stats_get_sample_timestamp(const struct dm_stats *dms,
+				  struct dm_timestamp *ts);
+
+/*
+ * Return the total duration in nanoseconds of the most recent
+ * nr_samples sampling intervals.
+ */
+uint64_t dm_stats_get_history_interval_ns(const struct dm_stats *dms,
+					  unsigned nr_samples);
+
+/*
+ * Sample many devices at once.
+ *
+ * A dm_stats_sweep holds a set of bound dm_stats handles with a sample
+ * history. dm_stats_sweep_run() calls dm_stats_sample() for every
+ * handle in the set using up to nr_threads threads (zero selects the
+ * number of online CPUs) and returns once all handles have been
+ * sampled, so that each handle holds one new sample with its own
+ * timestamp for the sweep.
+ *
+ * A handle must not be used by the caller while a sweep that contains
+ * it is running. dm_stats_sweep_run() returns zero if any handle
+ * failed to sample: the history of a failed handle is emptied, so
+ * dm_stats_get_nr_samples() returns zero for it.
+ *
+ * The rest of libdevmapper is not thread-safe. The workers serialise
+ * their own ioctls, but no other thread may call into libdevmapper
+ * while a sweep is running.
+ */
+struct dm_stats_sweep;
+
+struct dm_stats_sweep *dm_stats_sweep_create(unsigned nr_threads);
+int dm_stats_sweep_add(struct dm_stats_sweep *sweep, struct dm_stats *dms);
+int dm_stats_sweep_run(struct dm_stats_sweep *sweep, const char *program_id);
+void dm_stats_sweep_destroy(struct dm_stats_sweep *sweep);
+
 /*
  * Create a new statistics region on the device bound to dms.
  *
@@ -2253,6 +2324,17 @@ int dm_bit_get_next(dm_bitset_t bs, int last_bit);
 int dm_bit_get_last(dm_bitset_t bs);
 int dm_bit_get_prev(dm_bitset_t bs, int last_bit);
 
+/*
+ * Word-at-a-time helpers: out = in1 & ~in2, first/next clear bit (-1 if
+ * none), number of set bits, and setting or clearing len bits from start.
+ */
+void dm_bit_andnot(dm_bitset_t out, dm_bitset_t in1, dm_bitset_t in2);
+int dm_bit_get_first_clear(dm_bitset_t bs);
+int dm_bit_get_next_clear(dm_bitset_t bs, int last_bit);
+unsigned dm_bit_count(dm_bitset_t bs);
+void dm_bit_set_range(dm_bitset_t bs, unsigned start, unsigned len);
+void dm_bit_clear_range(dm_bitset_t bs, unsigned start, unsigned len);
+
 #define DM_BITS_PER_INT ((unsigned)sizeof(int) * CHAR_BIT)
 
 #define dm_bit(bs, i) \
@@ -3241,6 +3323,30 @@ uint64_t dm_stats_get_counter(const struct dm_stats *dms,
 			      dm_stats_counter_t counter,
 			      uint64_t region_id, uint64_t area_id);
 
+/*
+ * Return the sum of a counter over the most recent nr_samples samples
+ * in the history of dms. Region, area and group aggregation follow
+ * dm_stats_get_counter(). Divide by dm_stats_get_history_interval_ns()
+ * for the same nr_samples to obtain a rate.
+ */
+uint64_t dm_stats_get_history_counter(const struct dm_stats *dms,
+				      dm_stats_counter_t counter,
+				      uint64_t region_id, uint64_t area_id,
+				      unsigned nr_samples);
+
+/*
+ * Store in area_ids the area_ids of up to nr_areas areas of region_id
+ * with the largest sum of counter over the most recent nr_samples
+ * samples, in descending order of that sum.
+ *
+ * Returns the number of area_ids stored, or zero if no samples are
+ * available.
+ */
+int dm_stats_get_top_areas(const struct dm_stats *dms,
+			   dm_stats_counter_t counter, uint64_t region_id,
+			   unsigned nr_samples, uint64_t *area_ids,
+			   unsigned nr_areas);
+
 uint64_t dm_stats_get_reads(const struct dm_stats *dms,
 			    uint64_t region_id, uint64_t area_id);
 
@@ -3453,6 +3559,14 @@ dm_percent_t dm_histogram_get_bin_percent(const struct dm_histogram *dmh,
  */
 uint64_t dm_histogram_get_sum(const struct dm_histogram *dmh);
 
+/*
+ * Return the upper bound in nanoseconds of the bin containing the
+ * given percentile (0.0 to 100.0) of the observations counted in the
+ * histogram, or zero if the histogram is empty.
+ */
+uint64_t dm_histogram_get_percentile(const struct dm_histogram *dmh,
+				     double percentile);
+
 /*
  * Histogram formatting flags.
  */
@@ -20,6 +20,7 @@
 
 #include "math.h" /* log10() */
 
+#include <pthread.h>
 #include <sys/sysmacros.h>
 #include <sys/ioctl.h>
 #include <sys/vfs.h> /* fstatfs */
@@ -71,22 +72,16 @@ struct dm_histogram {
 /*
  * See Documentation/device-mapper/statistics.txt for full descriptions
  * of the device-mapper statistics counter fields.
+ *
+ * Counter data for all areas of a region is stored by column: one
+ * array of nr_areas values for each dm_stats_counter_t, in the order
+ * that the fields appear in @stats_print output. Aggregating a counter
+ * over a region is then a simple sum over one contiguous array.
  */
 struct dm_stats_counters {
-	uint64_t reads;		    /* Num reads completed */
-	uint64_t reads_merged;	    /* Num reads merged */
-	uint64_t read_sectors;	    /* Num sectors read */
-	uint64_t read_nsecs;	    /* Num milliseconds spent reading */
-	uint64_t writes;	    /* Num writes completed */
-	uint64_t writes_merged;	    /* Num writes merged */
-	uint64_t write_sectors;	    /* Num sectors written */
-	uint64_t write_nsecs;	    /* Num milliseconds spent writing */
-	uint64_t io_in_progress;    /* Num I/Os currently in progress */
-	uint64_t io_nsecs;	    /* Num milliseconds spent doing I/Os */
-	uint64_t weighted_io_nsecs; /* Weighted num milliseconds doing I/Os */
-	uint64_t total_read_nsecs;  /* Total time spent reading in milliseconds */
-	uint64_t total_write_nsecs; /* Total time spent writing in milliseconds */
-	struct dm_histogram *histogram; /* Histogram. */
+	uint64_t nr_areas;	    /* Number of areas in each column */
+	uint64_t *values[DM_STATS_NR_COUNTERS]; /* Counter columns */
+	struct dm_histogram **histogram; /* Per-area histograms or NULL */
 };
 
 struct dm_stats_region {
@@ -101,6 +96,7 @@ struct dm_stats_region {
 	struct dm_histogram *bounds; /* histogram configuration */
 	struct dm_histogram *histogram; /* aggregate cache */
 	struct dm_stats_counters *counters;
+	struct dm_stats_counters **history; /* ring of sampled counters */
 };
 
 struct dm_stats_group {
@@ -128,6 +124,14 @@ struct dm_stats {
 	int precise; /* use precise_timestamps when creating regions */
 	struct dm_stats_region *regions;
 	struct dm_stats_group *groups;
+	/* sample history */
+	struct dm_pool *history_mem; /* pool for history ring buffers */
+	char *history_list; /* @stats_list response the rings were built for */
+	struct dm_timestamp *history_ts; /* time of the most recent sample */
+	uint64_t *history_interval_ns; /* sampling interval of each slot */
+	unsigned history_len; /* number of slots in each ring */
+	unsigned history_cur; /* slot holding the most recent sample */
+	unsigned history_count; /* number of valid samples */
 	/* statistics cursor */
 	uint64_t walk_flags; /* walk control flags */
 	uint64_t cur_flags;
@@ -307,8 +311,8 @@ static void _stats_histograms_destroy(struct dm_pool *mem,
 	/*
 	 * Free everything in the pool back to the first histogram.
 	 */
-	if (region->counters[0].histogram)
-		dm_pool_free(mem, region->counters[0].histogram);
+	if (region->counters->histogram && region->counters->histogram[0])
+		dm_pool_free(mem, region->counters->histogram[0]);
 }
 
 static void _stats_region_destroy(struct dm_stats_region *region)
@@ -328,6 +332,7 @@ static void _stats_region_destroy(struct dm_stats_region *region)
 	 */
 
 	region->counters = NULL;
+	region->history = NULL;
 	region->bounds = NULL;
 
 	dm_free(region->program_id);
@@ -342,6 +347,10 @@ static void _stats_regions_destroy(struct dm_stats *dms)
 	struct dm_pool *mem = dms->mem;
 	uint64_t i;
 
+	/* Rings are rebuilt by the next dm_stats_sample(). */
+	dm_free(dms->history_list);
+	dms->history_list = NULL;
+
 	if (!dms->regions)
 		return;
 
@@ -591,11 +600,42 @@ bad:
 	return NULL;
 }
 
+/*
+ * The ioctl layer keeps process-wide state (the control fd, the version
+ * check, log suppression and the dm major bitset) that is not safe to
+ * change from several threads, so stats tasks issued by sweep workers
+ * are created and run under one lock.  Parsing the responses runs in
+ * parallel.
+ */
+static pthread_mutex_t _stats_ioctl_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct dm_task *_stats_task_create(int type)
+{
+	struct dm_task *dmt;
+
+	pthread_mutex_lock(&_stats_ioctl_lock);
+	dmt = dm_task_create(type);
+	pthread_mutex_unlock(&_stats_ioctl_lock);
+
+	return dmt;
+}
+
+static int _stats_task_run(struct dm_task *dmt)
+{
+	int r;
+
+	pthread_mutex_lock(&_stats_ioctl_lock);
+	r = dm_task_run(dmt);
+	pthread_mutex_unlock(&_stats_ioctl_lock);
+
+	return r;
+}
+
 static struct dm_task *_stats_send_message(struct dm_stats *dms, char *msg)
 {
 	struct dm_task *dmt;
 
-	if (!(dmt = dm_task_create(DM_DEVICE_TARGET_MSG)))
+	if (!(dmt = _stats_task_create(DM_DEVICE_TARGET_MSG)))
 		return_0;
 
 	if (!_set_stats_device(dms, dmt))
@@ -604,7 +644,7 @@ static struct dm_task *_stats_send_message(struct dm_stats *dms, char *msg)
 	if (!dm_task_set_message(dmt, msg))
 		goto_bad;
 
-	if (!dm_task_run(dmt))
+	if (!_stats_task_run(dmt))
 		goto_bad;
 
 	return dmt;
@@ -624,13 +664,13 @@ static int _stats_set_name_cache(struct dm_stats *dms)
 	if (dms->name)
 		return 1;
 
-	if (!(dmt = dm_task_create(DM_DEVICE_INFO)))
+	if (!(dmt = _stats_task_create(DM_DEVICE_INFO)))
 		return_0;
 
 	if (!_set_stats_device(dms, dmt))
 		goto_bad;
 
-	if (!dm_task_run(dmt))
+	if (!_stats_task_run(dmt))
 		goto_bad;
 
 	if (!(dms->name = dm_strdup(dm_task_get_name(dmt))))
@@ -978,6 +1018,7 @@ static int _stats_parse_list_region(struct dm_stats *dms,
 	}
 
 	region->counters = NULL;
+	region->history = NULL;
 	return 1;
 }
 
@@ -1136,7 +1177,7 @@ bad:
 /*
  * Parse histogram data returned from a @stats_print operation.
  */
-static int _stats_parse_histogram(struct dm_pool *mem, char *hist_str,
+static int _stats_parse_histogram(struct dm_pool *mem, const char *hist_str,
 				  struct dm_histogram **histogram,
 				  struct dm_stats_region *region)
 {
@@ -1215,36 +1256,113 @@ bad:
 	return 0;
 }
 
-static int _stats_parse_region(struct dm_stats *dms, const char *resp,
-			       struct dm_stats_region *region,
-			       uint64_t timescale)
+/*
+ * Parse an unsigned decimal value at *p and advance *p past it.
+ */
+static int _stats_parse_u64(const char **p, uint64_t *val)
 {
-	struct dm_histogram *hist = NULL;
-	struct dm_pool *mem = dms->mem;
-	struct dm_stats_counters cur;
-	FILE *stats_rows = NULL;
-	uint64_t start = 0, len = 0;
-	char row[STATS_ROW_BUF_LEN];
-	int r;
+	const char *c = *p;
+	uint64_t v = 0;
 
-	if (!resp) {
-		log_error("Could not parse empty @stats_print response.");
+	if (*c < '0' || *c > '9')
 		return 0;
+
+	do {
+		if (v > (UINT64_MAX - (uint64_t)(*c - '0')) / 10)
+			return 0; /* overflow */
+		v = v * 10 + (uint64_t)(*c - '0');
+	} while (*++c >= '0' && *c <= '9');
+
+	*p = c;
+	*val = v;
+
+	return 1;
+}
+
+static void _stats_skip_blanks(const char **p)
+{
+	while (**p == ' ' || **p == '\t')
+		(*p)++;
+}
+
+static uint64_t _stats_count_rows(const char *resp)
+{
+	uint64_t nr_rows = 0;
+	const char *c = resp;
+
+	while ((c = strchr(c, '\n'))) {
+		nr_rows++;
+		c++;
 	}
 
-	region->start = UINT64_MAX;
+	/* Final row without a trailing newline. */
+	if (*resp && resp[strlen(resp) - 1] != '\n')
+		nr_rows++;
 
-	if (!dm_pool_begin_object(mem, 512))
-		goto_bad;
+	return nr_rows;
+}
 
-	/*
-	 * dm_task_get_message_response() returns a 'const char *' but
-	 * since fmemopen also permits "w" it expects a 'char *'.
-	 */
-	/* coverity[alloc_strlen] intentional */
-	stats_rows = fmemopen((char *)resp, strlen(resp), "r");
-	if (!stats_rows)
-		goto_bad;
+/*
+ * Allocate counter columns for nr_areas areas from a single block.
+ */
+static struct dm_stats_counters *_stats_counters_alloc(struct dm_pool *mem,
+						       uint64_t nr_areas,
+						       int histogram)
+{
+	struct dm_stats_counters *counters;
+	uint64_t *values;
+	size_t size;
+	int i;
+
+	size = sizeof(*counters)
+		+ DM_STATS_NR_COUNTERS * nr_areas * sizeof(uint64_t);
+	if (histogram)
+		size += nr_areas * sizeof(struct dm_histogram *);
+
+	if (!(counters = dm_pool_alloc_aligned(mem, size, sizeof(uint64_t))))
+		return_NULL;
+
+	counters->nr_areas = nr_areas;
+	values = (uint64_t *)(counters + 1);
+	for (i = 0; i < DM_STATS_NR_COUNTERS; i++)
+		counters->values[i] = values + i * nr_areas;
+
+	counters->histogram = (histogram)
+		? (struct dm_histogram **)(values + DM_STATS_NR_COUNTERS * nr_areas)
+		: NULL;
+
+	return counters;
+}
+
+static void _stats_scale_column(uint64_t *values, uint64_t nr_areas,
+				uint64_t timescale)
+{
+	uint64_t i;
+
+	for (i = 0; i < nr_areas; i++)
+		values[i] *= timescale;
+}
+
+/*
+ * Parse the rows of a @stats_print response into counters, which must
+ * have room for exactly the number of areas present in the response.
+ */
+static int _stats_parse_counters(struct dm_stats *dms, const char *resp,
+				 struct dm_stats_region *region,
+				 struct dm_stats_counters *counters,
+				 uint64_t timescale)
+{
+	static const dm_stats_counter_t _time_counters[] = {
+		DM_STATS_READ_NSECS, DM_STATS_WRITE_NSECS,
+		DM_STATS_IO_NSECS, DM_STATS_WEIGHTED_IO_NSECS,
+		DM_STATS_TOTAL_READ_NSECS, DM_STATS_TOTAL_WRITE_NSECS
+	};
+	struct dm_histogram *hist = NULL;
+	uint64_t start = 0, len = 0, area = 0;
+	const char *c;
+	unsigned i;
+
+	region->start = UINT64_MAX;
 
 	/*
 	 * Output format for each step-sized area of a region:
@@ -1272,65 +1390,50 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 	 * 12. the total time spent reading in milliseconds
 	 * 13. the total time spent writing in milliseconds
 	 *
-	*/
-	while (fgets(row, sizeof(row), stats_rows)) {
-		r = sscanf(row, FMTu64 "+" FMTu64 /* start+len */
-			   /* reads */
-			   FMTu64 " " FMTu64 " " FMTu64 " " FMTu64 " "
-			   /* writes */
-			   FMTu64 " " FMTu64 " " FMTu64 " " FMTu64 " "
-			   /* in flight & io nsecs */
-			   FMTu64 " " FMTu64 " " FMTu64 " "
-			   /* tot read/write nsecs */
-			   FMTu64 " " FMTu64, &start, &len,
-			   &cur.reads, &cur.reads_merged, &cur.read_sectors,
-			   &cur.read_nsecs,
-			   &cur.writes, &cur.writes_merged, &cur.write_sectors,
-			   &cur.write_nsecs,
-			   &cur.io_in_progress,
-			   &cur.io_nsecs, &cur.weighted_io_nsecs,
-			   &cur.total_read_nsecs, &cur.total_write_nsecs);
-		if (r != 15) {
-			log_error("Could not parse @stats_print row.");
-			goto bad;
+	 * The counters are stored directly into the column for the
+	 * corresponding dm_stats_counter_t, which follows the same order.
+	 * An optional histogram follows the counters.
+	 */
+	for (c = resp; *c; area++) {
+		if (area == counters->nr_areas) {
+			log_error("Too many areas in @stats_print response.");
+			return 0;
 		}
 
-		/* scale time values up if needed */
-		if (timescale != 1) {
-			cur.read_nsecs *= timescale;
-			cur.write_nsecs *= timescale;
-			cur.io_nsecs *= timescale;
-			cur.weighted_io_nsecs *= timescale;
-			cur.total_read_nsecs *= timescale;
-			cur.total_write_nsecs *= timescale;
+		if (!_stats_parse_u64(&c, &start) || (*c++ != '+') ||
+		    !_stats_parse_u64(&c, &len))
+			goto badrow;
+
+		for (i = 0; i < DM_STATS_NR_COUNTERS; i++) {
+			_stats_skip_blanks(&c);
+			if (!_stats_parse_u64(&c, &counters->values[i][area]))
+				goto badrow;
 		}
 
+		_stats_skip_blanks(&c);
+
 		if (region->bounds) {
-			/* Find first histogram separator. */
-			char *hist_str = strchr(row, ':');
-			if (!hist_str) {
+			if (!*c || (*c == '\n')) {
 				log_error("Could not parse histogram value.");
-				goto bad;
+				return 0;
 			}
-			/* Find space preceding histogram. */
-			while (hist_str && *(hist_str - 1) != ' ')
-				hist_str--;
 
-			/* Use a separate pool for histogram objects since we
-			 * are growing the area table and each area's histogram
-			 * table simultaneously.
+			/* Use a separate pool for histogram objects since
+			 * the area table is allocated from dms->mem.
 			 */
-			if (!_stats_parse_histogram(dms->hist_mem, hist_str,
+			if (!_stats_parse_histogram(dms->hist_mem, c,
 						    &hist, region))
-				goto_bad;
+				return_0;
 			hist->dms = dms;
 			hist->region = region;
+			counters->histogram[area] = hist;
 		}
 
-		cur.histogram = hist;
-
-		if (!dm_pool_grow_object(mem, &cur, sizeof(cur)))
-			goto_bad;
+		/* Skip anything else up to the end of the row. */
+		if (!(c = strchr(c, '\n')))
+			c = "";
+		else
+			c++;
 
 		if (region->start == UINT64_MAX) {
 			region->start = start;
@@ -1338,28 +1441,60 @@ static int _stats_parse_region(struct dm_stats *dms, const char *resp,
 		}
 	}
 
-	if (region->start == UINT64_MAX)
+	if (area != counters->nr_areas) {
 		/* no area data read from @stats_print */
-		goto bad;
+		if (area)
+			log_error("Too few areas in @stats_print response.");
+		return 0;
+	}
+
+	/* scale time values up if needed */
+	if (timescale != 1)
+		for (i = 0; i < DM_ARRAY_SIZE(_time_counters); i++)
+			_stats_scale_column(counters->values[_time_counters[i]],
+					    area, timescale);
 
 	region->len = (start + len) - region->start;
 	region->timescale = timescale;
-	region->counters = dm_pool_end_object(mem);
-
-	if (fclose(stats_rows))
-		stack;
 
 	return 1;
 
-bad:
-	if (stats_rows)
-		if (fclose(stats_rows))
-			stack;
-	dm_pool_abandon_object(mem);
+badrow:
+	log_error("Could not parse @stats_print row.");
 
 	return 0;
 }
 
+static int _stats_parse_region(struct dm_stats *dms, const char *resp,
+			       struct dm_stats_region *region,
+			       uint64_t timescale)
+{
+	struct dm_stats_counters *counters;
+	uint64_t nr_rows;
+
+	if (!resp) {
+		log_error("Could not parse empty @stats_print response.");
+		return 0;
+	}
+
+	if (!(nr_rows = _stats_count_rows(resp)))
+		/* no area data read from @stats_print */
+		return 0;
+
+	if (!(counters = _stats_counters_alloc(dms->mem, nr_rows,
+					       !!region->bounds)))
+		return_0;
+
+	if (!_stats_parse_counters(dms, resp, region, counters, timescale)) {
+		dm_pool_free(dms->mem, counters);
+		return 0;
+	}
+
+	region->counters = counters;
+
+	return 1;
+}
+
 static void _stats_walk_next_present(const struct dm_stats *dms,
 				     uint64_t *flags,
 				     uint64_t *cur_r, uint64_t *cur_a,
@@ -1753,10 +1888,8 @@ static size_t _stats_group_tag_fill(const struct dm_stats *dms,
 	i = dm_bit_get_first(regions);
 	for(; i >= 0; i = dm_bit_get_next(regions, i)) {
 		/* find range end */
-		j = i;
-		do
-			next = j + 1;
-		while ((j = dm_bit_get_next(regions, j)) == next);
+		if ((next = dm_bit_get_next_clear(regions, i)) < 0)
+			next = (int) *regions;
 
 		/* set to last set bit */
 		j = next - 1;
@@ -1801,10 +1934,8 @@ static size_t _stats_group_tag_len(const struct dm_stats *dms,
 		/* length of region_id or range start in characters */
 		id_len = (i) ? 1 + (size_t) log10(i) : 1;
 		buflen += id_len;
-		j = i;
-		do
-			next = j + 1;
-		while ((j = dm_bit_get_next(regions, j)) == next);
+		if ((next = dm_bit_get_next_clear(regions, (int) i)) < 0)
+			next = (int64_t) *regions;
 
 		/* set to last set bit */
 		j = next - 1;
@@ -2389,6 +2520,390 @@ bad:
 	return 0;
 }
 
+/*
+ * Sample history.
+ *
+ * A handle with a sample history keeps the region layout returned by
+ * @stats_list between samples, and stores the counters of each sample
+ * in a ring of preallocated counter sets for every region. The region
+ * table, groups and rings are only rebuilt when the @stats_list
+ * response changes.
+ */
+int dm_stats_set_history(struct dm_stats *dms, unsigned nr_samples)
+{
+	if (!nr_samples) {
+		log_error("Sample history must hold at least one sample.");
+		return 0;
+	}
+
+	if (!dms->history_mem &&
+	    !(dms->history_mem = dm_pool_create("history_pool", 4096)))
+		return_0;
+
+	/* Force the rings to be rebuilt by the next sample. */
+	_stats_regions_destroy(dms);
+	_stats_groups_destroy(dms);
+
+	dms->history_len = nr_samples;
+	dms->history_count = 0;
+
+	return 1;
+}
+
+static int _stats_history_build(struct dm_stats *dms, const char *resp)
+{
+	struct dm_stats_region *region;
+	unsigned slot;
+	uint64_t i;
+
+	/* Destroys the old region table before the rings are dropped. */
+	if (!_stats_parse_list(dms, resp))
+		return_0;
+
+	dm_pool_empty(dms->history_mem);
+	dms->history_count = 0;
+	dms->history_cur = dms->history_len - 1;
+
+	if (!(dms->history_interval_ns =
+	      dm_pool_zalloc(dms->history_mem,
+			     dms->history_len * sizeof(uint64_t))))
+		return_0;
+
+	for (i = 0; dms->regions && (i <= dms->max_region); i++) {
+		region = &dms->regions[i];
+		if (!_stats_region_present(region))
+			continue;
+
+		if (!(region->history =
+		      dm_pool_alloc(dms->history_mem, dms->history_len *
+				    sizeof(*region->history))))
+			return_0;
+
+		for (slot = 0; slot < dms->history_len; slot++)
+			if (!(region->history[slot] =
+			      _stats_counters_alloc(dms->history_mem,
+						    _nr_areas_region(region),
+						    !!region->bounds)))
+				return_0;
+	}
+
+	if (!(dms->history_list = dm_strdup(resp)))
+		return_0;
+
+	return 1;
+}
+
+/*
+ * Release the histograms of the previous sample and any aggregate
+ * histograms cached from them.
+ */
+static void _stats_history_drop_histograms(struct dm_stats *dms)
+{
+	uint64_t i;
+
+	/* walk backwards to obey pool order */
+	for (i = dms->max_region; (i != DM_STATS_REGION_NOT_PRESENT); i--) {
+		_stats_histograms_destroy(dms->hist_mem, &dms->regions[i]);
+		dms->regions[i].histogram = NULL;
+		if (dms->groups)
+			dms->groups[i].histogram = NULL;
+	}
+}
+
+int dm_stats_sample(struct dm_stats *dms, const char *program_id)
+{
+	char msg[STATS_MSG_BUF_LEN];
+	struct dm_stats_region *region;
+	struct dm_task *dmt;
+	struct dm_timestamp *now = NULL;
+	unsigned slot;
+	uint64_t i, delta_ns;
+
+	if (!dms->history_len) {
+		log_error("Stats handle has no sample history.");
+		return 0;
+	}
+
+	if (!_stats_bound(dms))
+		return_0;
+
+	if (!program_id)
+		program_id = dms->program_id;
+
+	if (!_stats_set_name_cache(dms))
+		return_0;
+
+	if (dm_snprintf(msg, sizeof(msg), "@stats_list %s", program_id) < 0) {
+		log_error("Failed to prepare stats message.");
+		return 0;
+	}
+
+	if (!(dmt = _stats_send_message(dms, msg)))
+		return_0;
+
+	if (!dms->history_list ||
+	    strcmp(dm_task_get_message_response(dmt), dms->history_list)) {
+		log_debug("Rebuilding stats sample history for %s.", dms->name);
+		if (!_stats_history_build(dms, dm_task_get_message_response(dmt))) {
+			log_error("Could not parse @stats_list response.");
+			goto bad;
+		}
+	}
+
+	dm_task_destroy(dmt);
+	dmt = NULL;
+
+	if (!(now = dm_timestamp_alloc()))
+		goto_bad;
+
+	if (dms->regions)
+		_stats_history_drop_histograms(dms);
+
+	slot = (dms->history_cur + 1) % dms->history_len;
+
+	for (i = 0; dms->regions && (i <= dms->max_region); i++) {
+		region = &dms->regions[i];
+		if (!_stats_region_present(region))
+			continue;
+
+		/* obtain all lines and clear counter values */
+		if (!(dmt = _stats_print_region(dms, i, 0, 0, 1)))
+			goto_bad;
+
+		if (!dm_task_get_message_response(dmt) ||
+		    !_stats_parse_counters(dms, dm_task_get_message_response(dmt),
+					   region, region->history[slot],
+					   region->timescale)) {
+			log_error("Could not parse @stats_print message response.");
+			goto bad;
+		}
+
+		dm_task_destroy(dmt);
+		dmt = NULL;
+
+		region->counters = region->history[slot];
+	}
+
+	if (!dm_timestamp_get(now))
+		goto_bad;
+
+	/*
+	 * The first sample covers the time since the counters were last
+	 * cleared, which is unknown: use the configured interval.
+	 */
+	if (!dms->history_ts) {
+		dms->history_ts = now;
+		delta_ns = dms->interval_ns;
+	} else {
+		delta_ns = dms->interval_ns =
+			dm_timestamp_delta(now, dms->history_ts);
+		dm_timestamp_copy(dms->history_ts, now);
+		dm_timestamp_destroy(now);
+	}
+	now = NULL;
+
+	dms->history_interval_ns[slot] = delta_ns;
+	dms->history_cur = slot;
+	if (dms->history_count < dms->history_len)
+		dms->history_count++;
+
+	return 1;
+
+bad:
+	if (dmt)
+		dm_task_destroy(dmt);
+	if (now)
+		dm_timestamp_destroy(now);
+
+	/* Partially updated rings: rebuild on the next sample. */
+	_stats_regions_destroy(dms);
+	_stats_groups_destroy(dms);
+	dms->history_count = 0;
+
+	return 0;
+}
+
+unsigned dm_stats_get_nr_samples(const struct dm_stats *dms)
+{
+	return dms->history_count;
+}
+
+int dm_stats_get_sample_timestamp(const struct dm_stats *dms,
+				  struct dm_timestamp *ts)
+{
+	if (!dms->history_count || !dms->history_ts)
+		return 0;
+
+	dm_timestamp_copy(ts, dms->history_ts);
+
+	return 1;
+}
+
+uint64_t dm_stats_get_history_interval_ns(const struct dm_stats *dms,
+					  unsigned nr_samples)
+{
+	uint64_t interval_ns = 0;
+	unsigned n;
+
+	if (nr_samples > dms->history_count)
+		nr_samples = dms->history_count;
+
+	for (n = 0; n < nr_samples; n++)
+		interval_ns += dms->history_interval_ns[(dms->history_cur
+							 + dms->history_len
+							 - n) % dms->history_len];
+
+	return interval_ns;
+}
+
+/*
+ * Multi-device sampling.
+ *
+ * A sweep samples a set of dm_stats handles with sample history, one
+ * handle at a time per worker thread. Each handle is only touched by
+ * the thread sampling it, so the handles themselves need no locking.
+ * The ioctls are serialised by _stats_task_run().
+ */
+struct dm_stats_sweep {
+	unsigned nr_threads; /* threads sampling during a sweep */
+	unsigned nr_handles; /* handles in the sweep */
+	unsigned max_handles; /* size of the handles table */
+	struct dm_stats **handles;
+	/* state of the running sweep */
+	pthread_mutex_t lock;
+	const char *program_id;
+	unsigned next; /* index of the next handle to sample */
+	unsigned failed; /* number of handles that failed to sample */
+};
+
+struct dm_stats_sweep *dm_stats_sweep_create(unsigned nr_threads)
+{
+	struct dm_stats_sweep *sweep;
+	long nr_cpus;
+
+	if (!nr_threads)
+		nr_threads = ((nr_cpus = sysconf(_SC_NPROCESSORS_ONLN)) > 0)
+			? (unsigned) nr_cpus : 1;
+
+	if (!(sweep = dm_zalloc(sizeof(*sweep))))
+		return_NULL;
+
+	if (pthread_mutex_init(&sweep->lock, NULL)) {
+		log_error("Failed to initialise stats sweep lock.");
+		dm_free(sweep);
+		return NULL;
+	}
+
+#ifdef DEBUG_MEM
+	/* The debugging allocator is not thread-safe. */
+	nr_threads = 1;
+#endif
+	sweep->nr_threads = nr_threads;
+
+	return sweep;
+}
+
+void dm_stats_sweep_destroy(struct dm_stats_sweep *sweep)
+{
+	if (!sweep)
+		return;
+
+	pthread_mutex_destroy(&sweep->lock);
+	dm_free(sweep->handles);
+	dm_free(sweep);
+}
+
+int dm_stats_sweep_add(struct dm_stats_sweep *sweep, struct dm_stats *dms)
+{
+	struct dm_stats **handles;
+	unsigned max_handles;
+
+	if (!dms->history_len) {
+		log_error("Stats handle has no sample history.");
+		return 0;
+	}
+
+	if (sweep->nr_handles == sweep->max_handles) {
+		max_handles = sweep->max_handles ? 2 * sweep->max_handles : 16;
+		if (!(handles = dm_realloc(sweep->handles,
+					   max_handles * sizeof(*handles))))
+			return_0;
+		sweep->handles = handles;
+		sweep->max_handles = max_handles;
+	}
+
+	sweep->handles[sweep->nr_handles++] = dms;
+
+	return 1;
+}
+
+static void *_stats_sweep_worker(void *arg)
+{
+	struct dm_stats_sweep *sweep = arg;
+	unsigned i;
+
+	for (;;) {
+		pthread_mutex_lock(&sweep->lock);
+		i = sweep->next++;
+		pthread_mutex_unlock(&sweep->lock);
+
+		if (i >= sweep->nr_handles)
+			break;
+
+		if (!dm_stats_sample(sweep->handles[i], sweep->program_id)) {
+			pthread_mutex_lock(&sweep->lock);
+			sweep->failed++;
+			pthread_mutex_unlock(&sweep->lock);
+		}
+	}
+
+	return NULL;
+}
+
+int dm_stats_sweep_run(struct dm_stats_sweep *sweep, const char *program_id)
+{
+	pthread_t *threads = NULL;
+	unsigned nr_threads, started = 0;
+
+	if (!sweep->nr_handles)
+		return 1;
+
+	sweep->program_id = program_id;
+	sweep->failed = 0;
+	sweep->next = 0;
+
+	/* The calling thread samples alongside the workers. */
+	nr_threads = sweep->nr_threads - 1;
+	if (nr_threads > sweep->nr_handles - 1)
+		nr_threads = sweep->nr_handles - 1;
+
+	if (nr_threads && !(threads = dm_malloc(nr_threads * sizeof(*threads))))
+		log_warn("WARNING: Sampling stats without worker threads.");
+	else
+		for (; started < nr_threads; started++)
+			if (pthread_create(&threads[started], NULL,
+					   _stats_sweep_worker, sweep)) {
+				log_sys_debug("pthread_create", "stats sweep worker");
+				break;
+			}
+
+	(void) _stats_sweep_worker(sweep);
+
+	while (started)
+		if (pthread_join(threads[--started], NULL))
+			log_sys_debug("pthread_join", "stats sweep worker");
+
+	dm_free(threads);
+
+	if (sweep->failed) {
+		log_error("Failed to sample %u of %u stats handles.",
+			  sweep->failed, sweep->nr_handles);
+		return 0;
+	}
+
+	return 1;
+}
+
 /**
  * destroy a dm_stats object and all associated regions and counter sets.
  */
@@ -2403,6 +2918,10 @@ void dm_stats_destroy(struct dm_stats *dms)
 	dm_pool_destroy(dms->mem);
 	dm_pool_destroy(dms->hist_mem);
 	dm_pool_destroy(dms->group_mem);
+	if (dms->history_mem)
+		dm_pool_destroy(dms->history_mem);
+	if (dms->history_ts)
+		dm_timestamp_destroy(dms->history_ts);
 	dm_free(dms->program_id);
 	dm_free((char *) dms->name);
 	dm_free(dms);
@@ -2434,52 +2953,48 @@ for ((i) = dm_bit_get_first((dms)->groups[(gid)].regions);	\
 _foreach_group_region(dms, gid, i)				\
 	_foreach_region_area(dms, i, j)
 
-static uint64_t _stats_get_counter(const struct dm_stats *dms,
-				   const struct dm_stats_counters *area,
-				   dm_stats_counter_t counter)
-{
-	switch(counter) {
-	case DM_STATS_READS_COUNT:
-		return area->reads;
-	case DM_STATS_READS_MERGED_COUNT:
-		return area->reads_merged;
-	case DM_STATS_READ_SECTORS_COUNT:
-		return area->read_sectors;
-	case DM_STATS_READ_NSECS:
-		return area->read_nsecs;
-	case DM_STATS_WRITES_COUNT:
-		return area->writes;
-	case DM_STATS_WRITES_MERGED_COUNT:
-		return area->writes_merged;
-	case DM_STATS_WRITE_SECTORS_COUNT:
-		return area->write_sectors;
-	case DM_STATS_WRITE_NSECS:
-		return area->write_nsecs;
-	case DM_STATS_IO_IN_PROGRESS_COUNT:
-		return area->io_in_progress;
-	case DM_STATS_IO_NSECS:
-		return area->io_nsecs;
-	case DM_STATS_WEIGHTED_IO_NSECS:
-		return area->weighted_io_nsecs;
-	case DM_STATS_TOTAL_READ_NSECS:
-		return area->total_read_nsecs;
-	case DM_STATS_TOTAL_WRITE_NSECS:
-		return area->total_write_nsecs;
-	case DM_STATS_NR_COUNTERS:
-	default:
-		log_error("Attempt to read invalid counter: %d", counter);
-	}
-	return 0;
+static uint64_t _stats_sum_column(const uint64_t *values, uint64_t nr_areas)
+{
+	uint64_t i, sum = 0;
+
+	for (i = 0; i < nr_areas; i++)
+		sum += values[i];
+
+	return sum;
 }
 
-uint64_t dm_stats_get_counter(const struct dm_stats *dms,
-			      dm_stats_counter_t counter,
-			      uint64_t region_id, uint64_t area_id)
+/*
+ * Return the counters of region_id for the given sample: the current
+ * counters if sample is negative, or the history slot sample places
+ * before the most recent one.
+ */
+static const struct dm_stats_counters *_stats_region_counters(const struct dm_stats *dms,
+							       uint64_t region_id,
+							       int sample)
+{
+	const struct dm_stats_region *region = &dms->regions[region_id];
+
+	if (sample < 0)
+		return region->counters;
+
+	return region->history[(dms->history_cur + dms->history_len
+				- (unsigned) sample) % dms->history_len];
+}
+
+static uint64_t _stats_get_counter(const struct dm_stats *dms,
+				   dm_stats_counter_t counter,
+				   uint64_t region_id, uint64_t area_id,
+				   int sample)
 {
-	uint64_t i, j, sum = 0; /* aggregation */
+	uint64_t i, sum = 0; /* aggregation */
 	int sum_regions = 0;
 	struct dm_stats_region *region;
-	struct dm_stats_counters *area;
+	const struct dm_stats_counters *counters;
+
+	if ((unsigned) counter >= DM_STATS_NR_COUNTERS) {
+		log_error("Attempt to read invalid counter: %d", counter);
+		return 0;
+	}
 
 	region_id = (region_id == DM_STATS_REGION_CURRENT)
 		     ? dms->cur_region : region_id ;
@@ -2505,30 +3020,113 @@ uint64_t dm_stats_get_counter(const struct dm_stats *dms,
 	if (_stats_region_is_grouped(dms, region_id) && (sum_regions)) {
 		/* group */
 		if (area_id & DM_STATS_WALK_GROUP)
-			_foreach_group_area(dms, region->group_id, i, j) {
-				area = &dms->regions[i].counters[j];
-				sum += _stats_get_counter(dms, area, counter);
+			_foreach_group_region(dms, region->group_id, i) {
+				counters = _stats_region_counters(dms, i, sample);
+				sum += _stats_sum_column(counters->values[counter],
+							 counters->nr_areas);
 			}
 		else
 			_foreach_group_region(dms, region->group_id, i) {
-				area = &dms->regions[i].counters[area_id];
-				sum += _stats_get_counter(dms, area, counter);
+				counters = _stats_region_counters(dms, i, sample);
+				sum += counters->values[counter][area_id];
 			}
 	} else if (area_id == DM_STATS_WALK_REGION) {
 		/* aggregate region */
-		_foreach_region_area(dms, region_id, j) {
-			area = &dms->regions[region_id].counters[j];
-			sum += _stats_get_counter(dms, area, counter);
-		}
+		counters = _stats_region_counters(dms, region_id, sample);
+		sum = _stats_sum_column(counters->values[counter],
+					counters->nr_areas);
 	} else {
 		/* plain region / area */
-		area = &region->counters[area_id];
-		sum = _stats_get_counter(dms, area, counter);
+		counters = _stats_region_counters(dms, region_id, sample);
+		sum = counters->values[counter][area_id];
 	}
 
 	return sum;
 }
 
+uint64_t dm_stats_get_counter(const struct dm_stats *dms,
+			      dm_stats_counter_t counter,
+			      uint64_t region_id, uint64_t area_id)
+{
+	return _stats_get_counter(dms, counter, region_id, area_id, -1);
+}
+
+uint64_t dm_stats_get_history_counter(const struct dm_stats *dms,
+				      dm_stats_counter_t counter,
+				      uint64_t region_id, uint64_t area_id,
+				      unsigned nr_samples)
+{
+	uint64_t sum = 0;
+	unsigned n;
+
+	if (nr_samples > dms->history_count)
+		nr_samples = dms->history_count;
+
+	for (n = 0; n < nr_samples; n++)
+		sum += _stats_get_counter(dms, counter, region_id, area_id,
+					  (int) n);
+
+	return sum;
+}
+
+int dm_stats_get_top_areas(const struct dm_stats *dms,
+			   dm_stats_counter_t counter, uint64_t region_id,
+			   unsigned nr_samples, uint64_t *area_ids,
+			   unsigned nr_areas)
+{
+	const struct dm_stats_counters *counters;
+	uint64_t *sums, *top, area, nr_region_areas;
+	unsigned n, nr_top = 0, pos;
+
+	if ((unsigned) counter >= DM_STATS_NR_COUNTERS) {
+		log_error("Attempt to read invalid counter: %d", counter);
+		return 0;
+	}
+
+	region_id = (region_id == DM_STATS_REGION_CURRENT)
+		     ? dms->cur_region : region_id ;
+
+	if (!dm_stats_region_present(dms, region_id) ||
+	    !dms->regions[region_id].history)
+		return 0;
+
+	if (nr_samples > dms->history_count)
+		nr_samples = dms->history_count;
+
+	if (!nr_samples || !nr_areas)
+		return 0;
+
+	nr_region_areas = _nr_areas_region(&dms->regions[region_id]);
+
+	if (!(sums = dm_zalloc((nr_region_areas + nr_areas) * sizeof(*sums))))
+		return_0;
+	top = sums + nr_region_areas;
+
+	for (n = 0; n < nr_samples; n++) {
+		counters = _stats_region_counters(dms, region_id, (int) n);
+		for (area = 0; area < nr_region_areas; area++)
+			sums[area] += counters->values[counter][area];
+	}
+
+	/* Insertion into a descending list of the nr_areas largest sums. */
+	for (area = 0; area < nr_region_areas; area++) {
+		if ((nr_top == nr_areas) && (sums[area] <= top[nr_top - 1]))
+			continue;
+
+		pos = (nr_top < nr_areas) ? nr_top++ : nr_top - 1;
+		for (; pos && (top[pos - 1] < sums[area]); pos--) {
+			top[pos] = top[pos - 1];
+			area_ids[pos] = area_ids[pos - 1];
+		}
+		top[pos] = sums[area];
+		area_ids[pos] = area;
+	}
+
+	dm_free(sums);
+
+	return (int) nr_top;
+}
+
 /*
  * Methods for accessing named counter fields. All methods share the
  * following naming scheme and prototype:
@@ -3309,7 +3907,7 @@ static void _sum_histogram_bins(const struct dm_stats *dms,
 	int bin;
 
 	region = &dms->regions[region_id];
-	dmh_cur = region->counters[area_id].histogram;
+	dmh_cur = region->counters->histogram[area_id];
 	bins = dmh_aggr->bins;
 
 	for (bin = 0; bin < dmh_aggr->nr_bins; bin++)
@@ -3343,7 +3941,7 @@ static struct dm_histogram *_aggregate_histogram(const struct dm_stats *dms,
 		if (dms->regions[region_id].histogram)
 			return dms->regions[region_id].histogram;
 
-		dmh_cur = dms->regions[region_id].counters[0].histogram;
+		dmh_cur = dms->regions[region_id].counters->histogram[0];
 		dmh_cachep = &dms->regions[region_id].histogram;
 		nr_bins = dms->regions[region_id].bounds->nr_bins;
 	} else {
@@ -3362,7 +3960,7 @@ static struct dm_histogram *_aggregate_histogram(const struct dm_stats *dms,
 		if (dms->groups[group_id].histogram)
 			return dms->groups[group_id].histogram;
 
-		dmh_cur = dms->regions[group_id].counters[0].histogram;
+		dmh_cur = dms->regions[group_id].counters->histogram[0];
 		dmh_cachep = &dms->groups[group_id].histogram;
 		nr_bins = dms->regions[group_id].bounds->nr_bins;
 	}
@@ -3431,7 +4029,10 @@ struct dm_histogram *dm_stats_get_histogram(const struct dm_stats *dms,
 	if (!dms->regions[region_id].counters)
 		return dms->regions[region_id].bounds;
 
-	return dms->regions[region_id].counters[area_id].histogram;
+	if (!dms->regions[region_id].counters->histogram)
+		return NULL;
+
+	return dms->regions[region_id].counters->histogram[area_id];
 }
 
 int dm_histogram_get_nr_bins(const struct dm_histogram *dmh)
@@ -3467,6 +4068,34 @@ uint64_t dm_histogram_get_sum(const struct dm_histogram *dmh)
 	return dmh->sum;
 }
 
+uint64_t dm_histogram_get_percentile(const struct dm_histogram *dmh,
+				     double percentile)
+{
+	uint64_t rank, count = 0;
+	int bin;
+
+	if (!dmh->sum || !dmh->nr_bins)
+		return 0;
+
+	if (percentile < 0.0)
+		percentile = 0.0;
+	else if (percentile > 100.0)
+		percentile = 100.0;
+
+	/* Rank of the sample at this percentile, counting from one. */
+	if (!(rank = (uint64_t) ceil(percentile * (double) dmh->sum / 100.0)))
+		rank = 1;
+
+	for (bin = 0; bin < dmh->nr_bins; bin++)
+		if ((count += dmh->bins[bin].count) >= rank)
+			break;
+
+	if (bin == dmh->nr_bins)
+		bin--;
+
+	return dmh->bins[bin].upper;
+}
+
 dm_percent_t dm_histogram_get_bin_percent(const struct dm_histogram *dmh,
 					  int bin)
 {
@@ -4106,7 +4735,7 @@ int dm_stats_delete_group(struct dm_stats *dms, uint64_t group_id,
 {
 	struct dm_stats_region *leader;
 	dm_bitset_t regions;
-	uint64_t i;
+	int64_t i;
 
 	if (group_id > dms->max_region) {
 		log_error("Invalid group ID: " FMTu64, group_id);
@@ -4122,13 +4751,12 @@ int dm_stats_delete_group(struct dm_stats *dms, uint64_t group_id,
 	leader = &dms->regions[group_id];
 
 	/* delete all but the group leader */
-	for (i = (*regions - 1); i > leader->region_id; i--) {
-		if (dm_bit(regions, i)) {
-			dm_bit_clear(regions, i);
-			if (remove_regions && !dm_stats_delete_region(dms, i))
-				log_warn("WARNING: Failed to delete region "
-					 FMTu64 " on %s.", i, dms->name);
-		}
+	for (i = dm_bit_get_last(regions); i > (int64_t) leader->region_id;
+	     i = dm_bit_get_prev(regions, i)) {
+		dm_bit_clear(regions, i);
+		if (remove_regions && !dm_stats_delete_region(dms, i))
+			log_warn("WARNING: Failed to delete region "
+				 FMTd64 " on %s.", i, dms->name);
 	}
 
 	/* clear group and mark as not present */
@@ -4478,17 +5106,35 @@ bad:
 	return NULL;
 }
 
-#define MATCH_EXTENT(e, s, l) \
-(((e).start == (s)) && ((e).len == (l)))
+/*
+ * Comparison function to sort extents in ascending (start, len) order.
+ */
+static int _extent_compare(const void *p1, const void *p2)
+{
+	const struct _extent *r1 = (const struct _extent *) p1;
+	const struct _extent *r2 = (const struct _extent *) p2;
+
+	if (r1->start != r2->start)
+		return (r1->start < r2->start) ? -1 : 1;
+	if (r1->len != r2->len)
+		return (r1->len < r2->len) ? -1 : 1;
+	return 0;
+}
 
+/*
+ * Find the extent matching start and len in a table of nr_extents
+ * extents sorted with _extent_compare().
+ */
 static struct _extent *_find_extent(uint64_t nr_extents, struct _extent *extents,
 				    uint64_t start, uint64_t len)
 {
-	size_t i;
-	for (i = 0; i < nr_extents; i++)
-		if (MATCH_EXTENT(extents[i], start, len))
-			return extents + i;
-	return NULL;
+	struct _extent key = { .start = start, .len = len };
+
+	if (!nr_extents)
+		return NULL;
+
+	return bsearch(&key, extents, nr_extents, sizeof(*extents),
+		       _extent_compare);
 }
 
 /*
@@ -4508,28 +5154,45 @@ static void _stats_cleanup_region_ids(struct dm_stats *dms, uint64_t *regions,
 
 /*
  * First update pass: prune no-longer-allocated extents from the group
- * and build a table of the remaining extents so that their creation
- * can be skipped in the second pass.
+ * and build a table of the remaining extents, sorted for lookup with
+ * _find_extent(), so that their creation can be skipped in the second
+ * pass.
+ *
+ * Regions are removed from the group bitmap without updating the group
+ * descriptor: the caller stores the new descriptor once all regions
+ * have been created or deleted. If the group leader is deleted the
+ * group is dissolved and regroup is set instead.
  */
 static int _stats_unmap_regions(struct dm_stats *dms, uint64_t group_id,
 				struct dm_pool *mem, struct _extent *extents,
 				struct _extent **old_extents, uint64_t *count,
-				int *regroup)
+				uint64_t *nr_deleted, int *regroup)
 {
 	struct dm_stats_region *region = NULL;
 	struct dm_stats_group *group = NULL;
+	struct _extent *sorted = NULL;
 	uint64_t nr_kept, nr_old;
 	struct _extent ext = { .id = 0 };
-	int64_t i;
+	int64_t i, prev;
 
 	group = &dms->groups[group_id];
 
 	log_very_verbose("Checking for changed file extents in group ID "
 			 FMTu64, group_id);
 
+	/* Sorted copy of the current extents for lookup by region. */
+	if (extents) {
+		if (!(sorted = dm_pool_alloc(mem, *count * sizeof(*sorted)))) {
+			log_error("Could not allocate sorted extent table.");
+			return -1;
+		}
+		memcpy(sorted, extents, *count * sizeof(*sorted));
+		qsort(sorted, *count, sizeof(*sorted), _extent_compare);
+	}
+
 	if (!dm_pool_begin_object(mem, sizeof(**old_extents))) {
 		log_error("Could not allocate extent table.");
-		return 0;
+		return -1;
 	}
 
 	nr_kept = nr_old = 0; /* counts of old and retained extents */
@@ -4538,13 +5201,15 @@ static int _stats_unmap_regions(struct dm_stats *dms, uint64_t group_id,
 	 * First pass: delete de-allocated extents and set regroup=1 if
 	 * deleting the current group leader.
 	 */
-	i = dm_bit_get_last(group->regions);
-	for (; i >= 0; i = dm_bit_get_prev(group->regions, i)) {
+	for (i = dm_bit_get_last(group->regions); i >= 0; i = prev) {
+		/* The bitmap is destroyed with the group leader. */
+		prev = (i == (int64_t) group_id)
+			? -1 : dm_bit_get_prev(group->regions, i);
 		region = &dms->regions[i];
 		nr_old++;
 
-		if (extents && _find_extent(*count, extents,
-				  region->start, region->len)) {
+		if (_find_extent(sorted ? *count : 0, sorted,
+				 region->start, region->len)) {
 			ext.start = region->start;
 			ext.len = region->len;
 			ext.id = i;
@@ -4554,19 +5219,25 @@ static int _stats_unmap_regions(struct dm_stats *dms, uint64_t group_id,
 				goto out;
 
 			log_very_verbose("Kept region " FMTu64, i);
-		} else {
-
-			if (i == group_id)
-				*regroup = 1;
+			continue;
+		}
 
-			if (!_stats_delete_region(dms, i)) {
-				log_error("Could not remove region ID " FMTu64,
-					  i);
-				goto out;
-			}
+		if (i == (int64_t) group_id) {
+			*regroup = 1;
+			_stats_clear_group_regions(dms, group_id);
+			_stats_group_destroy(group);
+		} else if (!*regroup) {
+			dm_bit_clear(group->regions, i);
+			region->group_id = DM_STATS_GROUP_NOT_PRESENT;
+		}
 
-			log_very_verbose("Deleted region " FMTu64, i);
+		if (!_stats_delete_region(dms, i)) {
+			log_error("Could not remove region ID " FMTu64, i);
+			goto out;
 		}
+
+		(*nr_deleted)++;
+		log_very_verbose("Deleted region " FMTu64, i);
 	}
 
 	*old_extents = dm_pool_end_object(mem);
@@ -4574,6 +5245,9 @@ static int _stats_unmap_regions(struct dm_stats *dms, uint64_t group_id,
 		log_error("Could not finalize region extent table.");
 		goto out;
 	}
+
+	qsort(*old_extents, nr_kept, sizeof(**old_extents), _extent_compare);
+
 	log_very_verbose("Kept " FMTd64 " of " FMTd64 " old extents",
 			 nr_kept, nr_old);
 	log_very_verbose("Found " FMTu64 " new extents",
@@ -4595,11 +5269,16 @@ out:
  * that group_id corresponds to a group containing existing regions that
  * were mapped to this file at an earlier time: regions will be added or
  * removed to reflect the current status of the file.
+ *
+ * The number of regions created or deleted is returned in the memory
+ * pointed to by changed: if it is zero the region table of the handle
+ * is unmodified and the group descriptor is not rewritten.
  */
 static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 					 struct dm_histogram *bounds,
 					 int precise, uint64_t group_id,
-					 uint64_t *count, int *regroup)
+					 uint64_t *count, uint64_t *changed,
+					 int *regroup)
 {
 	struct _extent *extents = NULL, *old_extents = NULL;
 	uint64_t *regions = NULL, fail_region, i, num_bits;
@@ -4612,7 +5291,7 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 	struct stat buf;
 	int update;
 
-	*count = 0;
+	*count = *changed = 0;
 	update = _stats_group_id_present(dms, group_id);
 
 #ifdef BTRFS_SUPER_MAGIC
@@ -4673,7 +5352,8 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 		group = &dms->groups[group_id];
 		if ((nr_kept = _stats_unmap_regions(dms, group_id, extent_mem,
 						     extents, &old_extents,
-						     count, regroup)) < 0)
+						     count, changed,
+						     regroup)) < 0)
 			goto_out;
 	}
 
@@ -4717,6 +5397,7 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 		log_very_verbose("Created new region mapping " FMTu64 "+" FMTu64
 				 " with region ID " FMTu64, extents[i].start,
 				 extents[i].len, regions[i]);
+		(*changed)++;
 
 		if (!*regroup && update) {
 			/* expand group bitmap */
@@ -4734,8 +5415,8 @@ static uint64_t *_stats_map_file_regions(struct dm_stats *dms, int fd,
 	}
 	regions[*count] = DM_STATS_REGION_NOT_PRESENT;
 
-	/* Update group leader aux_data for new group members. */
-	if (!*regroup && update)
+	/* Update group leader aux_data once for all changed members. */
+	if (!*regroup && update && *changed)
 		if (!_stats_set_aux(dms, group_id,
 				    dms->regions[group_id].aux_data))
 			log_error("Failed to update group aux_data.");
@@ -4778,7 +5459,7 @@ uint64_t *dm_stats_create_regions_from_fd(struct dm_stats *dms, int fd,
 					  struct dm_histogram *bounds,
 					  const char *alias)
 {
-	uint64_t *regions, count;
+	uint64_t *regions, count, changed;
 	int regroup = 1;
 
 	if (alias && !group) {
@@ -4788,7 +5469,7 @@ uint64_t *dm_stats_create_regions_from_fd(struct dm_stats *dms, int fd,
 
 	if (!(regions = _stats_map_file_regions(dms, fd, bounds, precise,
 						DM_STATS_GROUP_NOT_PRESENT,
-						&count, &regroup)))
+						&count, &changed, &regroup)))
 		return NULL;
 
 	if (!group)
@@ -4813,7 +5494,7 @@ uint64_t *dm_stats_update_regions_from_fd(struct dm_stats *dms, int fd,
 {
 	struct dm_histogram *bounds = NULL;
 	int nr_bins, precise, regroup;
-	uint64_t *regions = NULL, count = 0;
+	uint64_t *regions = NULL, count = 0, changed = 0;
 	const char *alias = NULL;
 
 	if (!dms->regions || !dm_stats_group_present(dms, group_id)) {
@@ -4870,12 +5551,13 @@ uint64_t *dm_stats_update_regions_from_fd(struct dm_stats *dms, int fd,
 	precise = (dms->regions[group_id].timescale == 1);
 
 	regions = _stats_map_file_regions(dms, fd, bounds, precise,
-					  group_id, &count, &regroup);
+					  group_id, &count, &changed, &regroup);
 
 	if (!regions)
 		goto_out;
 
-	if (!dm_stats_list(dms, NULL))
+	/* An unchanged mapping leaves the listed region table valid. */
+	if (changed && !dm_stats_list(dms, NULL))
 		goto_bad;
 
 	/* regroup if there are regions to group */
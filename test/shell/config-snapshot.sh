@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+# Test binary snapshots of parsed config files
+
+SKIP_WITH_LVMPOLLD=1
+
+RUNDIR="/run"
+test -d "$RUNDIR" || RUNDIR="/var/run"
+CONFIG_SNAPSHOT_DIR="$RUNDIR/lvm/config_snapshots"
+
+. lib/inittest
+
+CONF="$LVM_SYSTEM_DIR/lvm.conf"
+SNAPSHOT="$CONFIG_SNAPSHOT_DIR/$(echo "$CONF" | tr / _)"
+
+aux lvmconf "global/suffix = 1"
+rm -f "$SNAPSHOT"
+
+# Config files are read before the command line debug options apply,
+# so snapshot use is checked by the inode of the snapshot file, which
+# changes each time a new snapshot is written.
+snapshot_ino() {
+	stat -c %i "$SNAPSHOT"
+}
+
+# first command parses lvm.conf and saves the snapshot, second one uses it
+lvmconfig global/suffix
+test -f "$SNAPSHOT"
+sino=$(snapshot_ino)
+lvmconfig global/suffix | grep "suffix=1"
+test "$(snapshot_ino)" -eq "$sino"
+
+# edit lvm.conf in place, keeping its inode and size
+sed -e 's/suffix = 1/suffix = 0/' "$CONF" > conf.new
+test "$(stat -c %s conf.new)" -eq "$(stat -c %s "$CONF")"
+ino=$(stat -c %i "$CONF")
+cat conf.new > "$CONF"
+test "$(stat -c %i "$CONF")" -eq "$ino"
+
+# the old snapshot must not be used, a new one is written
+lvmconfig global/suffix | grep "suffix=0"
+test "$(snapshot_ino)" -ne "$sino"
+sino=$(snapshot_ino)
+lvmconfig global/suffix | grep "suffix=0"
+test "$(snapshot_ino)" -eq "$sino"
+
+# a replaced lvm.conf must not use the old snapshot either
+sed -e 's/suffix = 0/suffix = 1/' "$CONF" > conf.new
+mv -f conf.new "$CONF"
+lvmconfig global/suffix | grep "suffix=1"
+test "$(snapshot_ino)" -ne "$sino"
+
+# disabled by environment
+rm -f "$SNAPSHOT"
+LVM_SUPPRESS_CONFIG_SNAPSHOTS=1 lvmconfig global/suffix
+LVM_SUPPRESS_CONFIG_SNAPSHOTS=1 lvmconfig global/suffix
+not ls "$SNAPSHOT"
+
+# a snapshot present is ignored when disabled
+lvmconfig global/suffix
+sino=$(snapshot_ino)
+sed -e 's/suffix = 1/suffix = 0/' "$CONF" > conf.new
+cat conf.new > "$CONF"
+LVM_SUPPRESS_CONFIG_SNAPSHOTS=1 lvmconfig global/suffix | grep "suffix=0"
+test "$(snapshot_ino)" -eq "$sino"
+
+# disabled by config/snapshots
+rm -f "$SNAPSHOT"
+aux lvmconf "config/snapshots = 0"
+lvmconfig global/suffix
+lvmconfig global/suffix
+not ls "$SNAPSHOT"
+
+aux lvmconf "config/snapshots = 1"
+lvmconfig global/suffix
+test -f "$SNAPSHOT"
+rm -f "$SNAPSHOT"
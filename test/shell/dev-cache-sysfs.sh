@@ -0,0 +1,56 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+# Test dev-cache populated from /sys/dev/block
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_devs 3
+
+# Any other regex filter pattern disables obtaining the list from sysfs.
+aux lvmconf 'devices/obtain_device_list_from_sysfs = 1' \
+	    'devices/global_filter = [ "a|.*|" ]'
+
+vgcreate $SHARED $vg "$dev1" "$dev2"
+
+# PVs are found under their dm names without walking the dev dir.
+pvs "$dev1" "$dev2"
+vgs $vg
+check pv_field "$dev1" vg_name $vg
+check pv_field "$dev2" vg_name $vg
+
+# A symlink that is not collected is added as an alias when used.
+ln -s "$dev1" "$DM_DEV_DIR/lvmtest_sysfs_link"
+pvs "$DM_DEV_DIR/lvmtest_sysfs_link" | tee out
+grep lvmtest_sysfs_link out
+
+# A symlink given with --devices is looked up and matched.
+pvs --devices "$DM_DEV_DIR/lvmtest_sysfs_link" -o vg_name | tee out
+grep $vg out
+
+# A filter naming the symlink still accepts the device.
+pvs --config "devices/global_filter = [ \"a|lvmtest_sysfs_link|\", \"r|.*|\" ]" \
+	-o vg_name | tee out
+grep $vg out
+rm -f "$DM_DEV_DIR/lvmtest_sysfs_link"
+
+pvcreate "$dev3"
+vgextend $vg "$dev3"
+check pv_field "$dev3" vg_name $vg
+
+lvcreate -l1 -n $lv1 $vg
+check lv_exists $vg $lv1
+lvremove -f $vg/$lv1
+
+vgremove -ff $vg
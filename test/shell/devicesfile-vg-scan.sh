@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='devices file VG scan'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_devs 4
+
+DFDIR="$LVM_SYSTEM_DIR/devices"
+mkdir -p "$DFDIR" || true
+DF="$DFDIR/system.devices"
+touch "$DF"
+
+aux lvmconf 'devices/use_devicesfile = 1' \
+	    'devices/devicesfile_vg_scan = 1' \
+	    'devices/hints = "none"'
+
+vgcreate $vg1 "$dev1" "$dev2"
+vgcreate $vg2 "$dev3"
+pvcreate "$dev4"
+
+# A full scan records the VG of each PV.
+pvs
+cat "$DF"
+grep "$dev1" "$DF" | grep "VGNAME=$vg1"
+grep "$dev2" "$DF" | grep "VGNAME=$vg1"
+grep "$dev3" "$DF" | grep "VGNAME=$vg2"
+not grep "$dev4.*VGNAME" "$DF"
+
+# Only the PVs of vg2 (and the orphan) are scanned.
+vgs -vvvv $vg2 2>&1 | tee out
+grep "Devices file entries for VG $vg2 select 2 devs" out
+not grep "Will scan" out
+check vg_field $vg2 pv_count 1
+
+# A stale entry falls back to scanning the other devices.
+sed -e "/$(basename "$dev2")/s/VGNAME=$vg1/VGNAME=$vg2/" "$DF" > "$DF.tmp"
+mv "$DF.tmp" "$DF"
+vgs -vvvv $vg1 2>&1 | tee out
+grep "Will scan" out
+check vg_field $vg1 pv_count 2
+grep "$dev2" "$DF" | grep "VGNAME=$vg1"
+
+# Renamed VG is found by the full scan and recorded.
+vgrename $vg2 $vg3
+vgs $vg3
+pvs
+grep "$dev3" "$DF" | grep "VGNAME=$vg3"
+
+vgextend $vg1 "$dev4"
+pvs
+grep "$dev4" "$DF" | grep "VGNAME=$vg1"
+check vg_field $vg1 pv_count 3
+
+vgremove -ff $vg1 $vg3
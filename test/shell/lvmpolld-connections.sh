@@ -0,0 +1,39 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='lvmpolld serves thousands of short client connections'
+
+SKIP_WITH_LVMLOCKD=1
+
+. lib/inittest
+
+test -e LOCAL_LVMPOLLD || skip
+
+# 20 clients in parallel, each connecting 100 times.
+for i in $(seq 1 20); do
+	(
+		for j in $(seq 1 100); do
+			lvmpolld --dump -s "$TESTDIR/lvmpolld.socket" > /dev/null || exit 1
+		done
+	) &
+	echo $! >> CLIENTS
+done
+
+for pid in $(< CLIENTS); do
+	wait "$pid"
+done
+
+# The daemon still answers and did not leak any connection.
+lvmpolld --dump -s "$TESTDIR/lvmpolld.socket" | tee dump.txt
+grep "Registered polling operations" dump.txt
+kill -0 "$(< LOCAL_LVMPOLLD)"
+test "$(ls /proc/"$(< LOCAL_LVMPOLLD)"/fd | wc -l)" -lt 20
@@ -0,0 +1,42 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+test_description='validation of changed LVs only on VG write'
+
+SKIP_WITH_LVMPOLLD=1
+
+. lib/inittest
+
+aux prepare_vg 2
+
+for i in 1 2 3 4 5 6; do
+	lvcreate -an -Zn -l1 -n lv$i $vg
+done
+
+CFG="metadata/full_validate_interval = 0"
+
+lvchange --config "$CFG" --addtag tag1 -vvvv $vg/lv1 2> debug.log
+grep "Validating segments of 0 changed of 6 LVs" debug.log
+
+lvextend --config "$CFG" -l+1 -vvvv $vg/lv2 2> debug.log
+grep "Validating segments of 1 changed of 6 LVs" debug.log
+
+lvremove --config "$CFG" -y $vg/lv3
+lvcreate --config "$CFG" -an -Zn -l2 -n lv7 $vg
+vgck $vg
+
+# Full validation does not log the scoped message.
+lvextend -l+1 -vvvv $vg/lv7 2> debug.log
+not grep "Validating segments of" debug.log
+
+vgck $vg
+vgremove -ff $vg
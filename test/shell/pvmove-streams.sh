@@ -0,0 +1,66 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+# Check pvmove copies several segments at once with activation/pvmove_streams
+
+SKIP_WITH_LVMLOCKD=1
+
+. lib/inittest
+
+aux prepare_vg 3 40
+
+for i in 1 2 3; do
+	lvcreate -an -Zn -l10 -n $lv$i $vg "$dev1"
+done
+
+aux delay_dev "$dev2" 0 30 "$(get first_extent_sector "$dev2"):"
+test -e HAVE_DM_DELAY || skip
+
+pvmove --config 'activation/pvmove_streams = 2' -i1 -b "$dev1" "$dev2"
+aux wait_pvmove_lv_ready "$vg-pvmove0"
+
+# Two of the three segments are copied in parallel
+dmsetup table "$vg-pvmove0" | tee out
+test "$(grep -c " mirror " out)" -eq 2
+
+wait_pvmove_done() {
+	for i in {100..0} ; do # wait for 10 secs at max
+		get lv_field $vg name -a | grep -E "^\[?pvmove" || break
+		sleep .1
+	done
+	test $i -gt 0 || die "Pvmove is too slow or does not progress."
+}
+
+aux enable_dev "$dev2"
+wait_pvmove_done
+
+for i in 1 2 3; do
+	check lv_on $vg $lv$i "$dev2"
+done
+
+# Values below 1 are replaced by 1 with a warning
+aux delay_dev "$dev1" 0 30 "$(get first_extent_sector "$dev1"):"
+pvmove --config 'activation/pvmove_streams = -1' -i1 -b "$dev2" "$dev1" 2>&1 | tee err
+grep "pvmove_streams -1 is set below minimum" err
+aux wait_pvmove_lv_ready "$vg-pvmove0"
+
+dmsetup table "$vg-pvmove0" | tee out
+test "$(grep -c " mirror " out)" -eq 1
+
+aux enable_dev "$dev1"
+wait_pvmove_done
+
+for i in 1 2 3; do
+	check lv_on $vg $lv$i "$dev1"
+done
+
+vgremove -ff $vg
@@ -0,0 +1,137 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+#
+# This copyrighted material is made available to anyone wishing to use,
+# modify, copy, or redistribute it subject to the terms and conditions
+# of the GNU General Public License v.2.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software Foundation,
+# Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+
+SKIP_WITH_LVMPOLLD=1
+
+RUNDIR="/run"
+test -d "$RUNDIR" || RUNDIR="/var/run"
+PVS_ONLINE_DIR="$RUNDIR/lvm/pvs_online"
+VGS_ONLINE_DIR="$RUNDIR/lvm/vgs_online"
+PVS_LOOKUP_DIR="$RUNDIR/lvm/pvs_lookup"
+PVSCAN_QUEUE_DIR="$RUNDIR/lvm/pvscan_queue"
+
+# FIXME: kills logic for running system
+_clear_online_files() {
+	# wait till udev is finished
+	aux udev_wait
+	rm -f "$PVS_ONLINE_DIR"/*
+	rm -f "$VGS_ONLINE_DIR"/*
+	rm -f "$PVS_LOOKUP_DIR"/*
+	rm -f "$PVSCAN_QUEUE_DIR"/*
+}
+
+_udev_pvscan() {
+	pvscan --cache --listvg --checkcomplete --vgonline --autoactivation event --udevoutput "$1"
+}
+
+. lib/inittest
+
+aux prepare_devs 4 16
+
+aux lvmconf "global/event_activation_batch = 1"
+
+vgcreate $vg1 "$dev1" "$dev2"
+lvcreate -n $lv1 -l 4 -a n $vg1
+vgcreate $vg2 "$dev3" "$dev4"
+lvcreate -n $lv1 -l 4 -a n $vg2
+
+_clear_online_files
+
+# a single pvscan processes its own queued device
+pvscan --cache -aay "$dev1"
+check lv_field $vg1/$lv1 lv_active ""
+test ! -f "$VGS_ONLINE_DIR/$vg1"
+pvscan --cache -aay "$dev2"
+check lv_field $vg1/$lv1 lv_active "active"
+test -f "$VGS_ONLINE_DIR/$vg1"
+ls "$PVSCAN_QUEUE_DIR" > queue
+not grep . queue
+vgchange -an $vg1
+
+_clear_online_files
+
+# concurrent pvscans activate each vg once, and leave nothing queued
+for d in "$dev1" "$dev2" "$dev3" "$dev4"; do
+	pvscan --cache -aay "$d" > "out.$(basename "$d")" 2>&1 &
+done
+wait
+cat out.*
+check lv_field $vg1/$lv1 lv_active "active"
+check lv_field $vg2/$lv1 lv_active "active"
+test "$(cat out.* | grep -c "VG $vg1 run autoactivation")" -eq 1
+test "$(cat out.* | grep -c "VG $vg2 run autoactivation")" -eq 1
+ls "$PVSCAN_QUEUE_DIR" > queue
+not grep . queue
+vgchange -an $vg1 $vg2
+
+# a queued entry is processed by the next pvscan to take the batch lock
+_clear_online_files
+read -r maj min < <(stat -L -c "%t %T" "$dev3")
+touch "$PVSCAN_QUEUE_DIR/$(printf "%d:%d" "0x$maj" "0x$min")"
+pvscan --cache -aay "$dev4"
+check lv_field $vg2/$lv1 lv_active "active"
+vgchange -an $vg2
+
+# pvscan -aay does not wait for the pvscan holding the batch lock,
+# which processes the entry after it releases the lock
+_clear_online_files
+flock "$RUNDIR/lvm/pvscan_batch" sleep 3 &
+sleep 1
+pvscan --cache -aay "$dev3"
+ls "$PVSCAN_QUEUE_DIR" > queue
+test "$(wc -l < queue)" -eq 1
+wait
+pvscan --cache -aay "$dev4"
+check lv_field $vg2/$lv1 lv_active "active"
+ls "$PVSCAN_QUEUE_DIR" > queue
+not grep . queue
+vgchange -an $vg2
+
+# the udev rule pvscan prints the result for its own device
+_clear_online_files
+_udev_pvscan "$dev1" | tee out
+grep "LVM_VG_NAME_INCOMPLETE='$vg1'" out
+_udev_pvscan "$dev2" | tee out
+grep "LVM_VG_NAME_COMPLETE='$vg1'" out
+test -f "$VGS_ONLINE_DIR/$vg1"
+_udev_pvscan "$dev2" | tee out
+not grep LVM_VG_NAME_COMPLETE out
+ls "$PVSCAN_QUEUE_DIR" > queue
+not grep . queue
+
+# udev rule pvscans for the same device in one batch each get the result
+_clear_online_files
+flock "$RUNDIR/lvm/pvscan_batch_list" sleep 2 &
+sleep 1
+_udev_pvscan "$dev1" > out.1 &
+_udev_pvscan "$dev1" > out.2 &
+wait
+cat out.1 out.2
+grep "LVM_VG_NAME_INCOMPLETE='$vg1'" out.1
+grep "LVM_VG_NAME_INCOMPLETE='$vg1'" out.2
+ls "$PVSCAN_QUEUE_DIR" > queue
+not grep . queue
+rm -f out.*
+
+# concurrent udev rule pvscans report each vg complete once
+_clear_online_files
+for d in "$dev1" "$dev2" "$dev3" "$dev4"; do
+	_udev_pvscan "$d" > "out.$(basename "$d")" 2>&1 &
+done
+wait
+cat out.*
+test "$(cat out.* | grep -c "LVM_VG_NAME_COMPLETE='$vg1'")" -eq 1
+test "$(cat out.* | grep -c "LVM_VG_NAME_COMPLETE='$vg2'")" -eq 1
+ls "$PVSCAN_QUEUE_DIR" > queue
+not grep . queue
+
+vgremove -y $vg1 $vg2
@@ -748,6 +748,34 @@ static void test_write_bad_io_stops_flush(void *context)
 	T_ASSERT(bcache_flush(cache));
 }
 
+static void test_write_bad_io_errors_di(void *context)
+{
+	struct fixture *f = context;
+	struct mock_engine *me = f->me;
+	struct bcache *cache = f->cache;
+	struct block *b;
+
+	T_ASSERT(bcache_get(cache, 17, 0, GF_ZERO, &b));
+	bcache_put(b);
+	T_ASSERT(bcache_get(cache, 18, 0, GF_ZERO, &b));
+	bcache_put(b);
+
+	_expect_write_bad_wait(me, 17, 0);
+	_expect_write(me, 18, 0);
+	_expect(me, E_WAIT);
+	_expect(me, E_WAIT);
+	T_ASSERT(!bcache_flush(cache));
+
+	// only the di with the failed write is reported
+	T_ASSERT(bcache_has_errors(cache, 17));
+	T_ASSERT(!bcache_has_errors(cache, 18));
+
+	_expect_write(me, 17, 0);
+	_expect(me, E_WAIT);
+	T_ASSERT(bcache_flush(cache));
+	T_ASSERT(!bcache_has_errors(cache, 17));
+}
+
 static void test_invalidate_not_present(void *context)
 {
 	struct fixture *f = context;
@@ -998,6 +1026,7 @@ static struct test_suite *_small_tests(void)
 	T("read-bad-io-intermittent", "failed io, followed by success", test_read_bad_wait_intermittent);
 	T("write-bad-issue-stops-flush", "flush fails temporarily if any block fails to write", test_write_bad_issue_stops_flush);
 	T("write-bad-io-stops-flush", "flush fails temporarily if any block fails to write", test_write_bad_io_stops_flush);
+	T("write-bad-io-errors-di", "failed writes are reported for their di only", test_write_bad_io_errors_di);
 	T("invalidate-not-present", "invalidate a block that isn't in the cache", test_invalidate_not_present);
 	T("invalidate-present", "invalidate a block that is in the cache", test_invalidate_present);
 	T("invalidate-read-error", "invalidate a block that errored", test_invalidate_after_read_error);
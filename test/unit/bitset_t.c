@@ -15,6 +15,8 @@
 #include "units.h"
 #include "device_mapper/all.h"
 
+#include <time.h>
+
 enum {
         NR_BITS = 137
 };
@@ -141,6 +143,170 @@ static void test_and(void *fixture)
                 T_ASSERT(!dm_bit(bs3, i));
 }
 
+static void test_get_next_clear(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+
+        int i, j, last = -1;
+        dm_bitset_t bs = dm_bitset_create(mem, NR_BITS);
+
+	T_ASSERT(bs);
+
+        dm_bit_set_all(bs);
+        T_ASSERT(dm_bit_get_first_clear(bs) == -1);
+
+        for (i = 0, j = 1; i < NR_BITS; i += j, j++)
+                dm_bit_clear(bs, i);
+
+        for (i = 0, j = 1; i < NR_BITS; i += j, j++) {
+                last = dm_bit_get_next_clear(bs, last);
+                T_ASSERT(last == i);
+        }
+
+        T_ASSERT(dm_bit_get_next_clear(bs, last) == -1);
+}
+
+static void test_count(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+
+        int i, j, n = 0;
+        dm_bitset_t bs = dm_bitset_create(mem, NR_BITS);
+
+	T_ASSERT(bs);
+        T_ASSERT(!dm_bit_count(bs));
+
+        for (i = 0, j = 1; i < NR_BITS; i += j, j++, n++)
+                dm_bit_set(bs, i);
+        T_ASSERT(dm_bit_count(bs) == n);
+
+        /* bits beyond the end of the set are not counted */
+        dm_bit_set_all(bs);
+        T_ASSERT(dm_bit_count(bs) == NR_BITS);
+}
+
+static void test_range(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+
+        unsigned start, len, i;
+        dm_bitset_t bs = dm_bitset_create(mem, NR_BITS);
+
+	T_ASSERT(bs);
+
+        for (start = 0; start < NR_BITS; start += 7)
+                for (len = 0; len < NR_BITS; len += 5) {
+                        dm_bit_clear_all(bs);
+                        dm_bit_set_range(bs, start, len);
+                        for (i = 0; i < NR_BITS; i++)
+                                T_ASSERT(!dm_bit(bs, i) ==
+                                         !(i >= start && i - start < len));
+
+                        dm_bit_set_all(bs);
+                        dm_bit_clear_range(bs, start, len);
+                        for (i = 0; i < NR_BITS; i++)
+                                T_ASSERT(!dm_bit(bs, i) ==
+                                         (i >= start && i - start < len));
+                }
+}
+
+static void test_andnot(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+        dm_bitset_t bs1 = dm_bitset_create(mem, NR_BITS);
+        dm_bitset_t bs2 = dm_bitset_create(mem, NR_BITS);
+        dm_bitset_t bs3 = dm_bitset_create(mem, NR_BITS);
+
+	int i;
+
+	T_ASSERT(bs1);
+	T_ASSERT(bs2);
+	T_ASSERT(bs3);
+
+        for (i = 0; i < NR_BITS; i++) {
+                if (i % 2)
+                        dm_bit_set(bs1, i);
+                if (i % 3)
+                        dm_bit_set(bs2, i);
+        }
+
+        dm_bit_andnot(bs3, bs1, bs2);
+        for (i = 0; i < NR_BITS; i++)
+                T_ASSERT(!dm_bit(bs3, i) == !((i % 2) && !(i % 3)));
+}
+
+/*
+ * Walk a large sparse bitset, as a mirror log resync search does, and
+ * check the word-level helpers against a bit-by-bit scan.
+ */
+static void test_large(void *fixture)
+{
+	struct dm_pool *mem = fixture;
+
+        unsigned nr_bits = 1 << 20, i, n = 0, clear = 0;
+        dm_bitset_t bs = dm_bitset_create(mem, nr_bits);
+        int last = -1;
+
+	T_ASSERT(bs);
+
+        dm_bit_set_all(bs);
+        for (i = 0; i < nr_bits; i += 4099)
+                dm_bit_clear(bs, i);
+
+        for (i = 0; i < nr_bits; i++)
+                if (dm_bit(bs, i))
+                        n++;
+        T_ASSERT(dm_bit_count(bs) == n);
+
+        while ((last = dm_bit_get_next_clear(bs, last)) >= 0) {
+                T_ASSERT(!(last % 4099));
+                clear++;
+        }
+        T_ASSERT(clear == nr_bits - n);
+}
+
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Not a pass/fail test: reports the time to find the only clear bit at
+ * the end of a 16M bit set with dm_bit_get_first_clear() and with a
+ * bit-by-bit scan.
+ */
+static void test_benchmark(void *fixture)
+{
+        unsigned nr_bits = 1 << 24, i;
+        dm_bitset_t bs = dm_bitset_create(NULL, nr_bits);
+        double t0, t1, t2;
+        int first;
+
+	T_ASSERT(bs);
+
+        dm_bit_set_all(bs);
+        dm_bit_clear(bs, nr_bits - 1);
+
+        t0 = _now();
+        first = dm_bit_get_first_clear(bs);
+        t1 = _now();
+        for (i = 0; i < nr_bits; i++)
+                if (!dm_bit(bs, i))
+                        break;
+        t2 = _now();
+
+        T_ASSERT(first == (int) nr_bits - 1);
+        T_ASSERT(i == nr_bits - 1);
+        fprintf(stderr, "  %u bits: last clear bit by words %.1f ms, by bits %.1f ms\n",
+                nr_bits, (t1 - t0) * 1e3, (t2 - t1) * 1e3);
+
+        dm_bitset_destroy(bs);
+}
+
 #define T(path, desc, fn) register_test(ts, "/base/data-struct/bitset/" path, desc, fn)
 
 void bitset_tests(struct dm_list *all_tests)
@@ -154,6 +320,12 @@ void bitset_tests(struct dm_list *all_tests)
 	T("get_next", "get next set bit", test_get_next);
 	T("equal", "equality", test_equal);
 	T("and", "and all bits", test_and);
+	T("get_next_clear", "get next clear bit", test_get_next_clear);
+	T("count", "count set bits", test_count);
+	T("range", "set and clear bit ranges", test_range);
+	T("andnot", "and with complement", test_andnot);
+	T("large", "search and count a large bitset", test_large);
+	T("benchmark", "search time of a large bitset", test_benchmark);
 
 	dm_list_add(all_tests, &ts->list);
 }
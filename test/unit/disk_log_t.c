@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU General Public License v.2.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "units.h"
+#include "daemons/cmirrord/disk_log.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------
+
+#define NR_BLOCKS 64
+#define FILE_FILL 0xaa
+
+struct fixture {
+	uint8_t *buffer;
+	uint8_t *data;
+	size_t block_size;
+	dm_bitset_t dirty;
+
+	char fname[64];
+	int fd;
+};
+
+static void *_fix_init(void)
+{
+	struct fixture *f = malloc(sizeof(*f));
+	size_t size;
+	unsigned i;
+
+	T_ASSERT(f);
+	f->block_size = PAGE_SIZE;
+	size = f->block_size * NR_BLOCKS;
+
+	if (posix_memalign((void **) &f->buffer, PAGE_SIZE, size) ||
+	    posix_memalign((void **) &f->data, PAGE_SIZE, size))
+		test_fail("posix_memalign failed");
+
+	/* each block of the in-memory log has its own pattern */
+	for (i = 0; i < NR_BLOCKS; i++)
+		memset(f->buffer + i * f->block_size, i, f->block_size);
+
+	T_ASSERT(f->dirty = dm_bitset_create(NULL, NR_BLOCKS));
+
+	snprintf(f->fname, sizeof(f->fname), "unit-test-XXXXXX");
+	/* coverity[secure_temp] don't care */
+	f->fd = mkstemp(f->fname);
+	T_ASSERT(f->fd >= 0);
+
+	memset(f->data, FILE_FILL, size);
+	T_ASSERT_EQUAL(write(f->fd, f->data, size), (ssize_t) size);
+	T_ASSERT(!fsync(f->fd));
+	(void) close(f->fd);
+
+	/*
+	 * cmirrord opens the log with O_DIRECT, where any write not aligned
+	 * to the logical block size fails.  tmpfs may not support it.
+	 */
+	if ((f->fd = open(f->fname, O_RDWR | O_DIRECT)) < 0) {
+		printf("  Running test in tmpfs, *NOT* using O_DIRECT\n");
+		f->fd = open(f->fname, O_RDWR);
+	}
+	T_ASSERT(f->fd >= 0);
+
+	return f;
+}
+
+static void _fix_exit(void *fixture)
+{
+	struct fixture *f = fixture;
+
+	if (f) {
+		(void) close(f->fd);
+		(void) unlink(f->fname);
+		dm_bitset_destroy(f->dirty);
+		free(f->buffer);
+		free(f->data);
+		free(f);
+	}
+}
+
+/* Check the blocks set in @written hold the buffer, the others are untouched. */
+static void _check_file(struct fixture *f, dm_bitset_t written)
+{
+	size_t size = f->block_size * NR_BLOCKS;
+	uint8_t *block;
+	unsigned i, j;
+
+	T_ASSERT_EQUAL(pread(f->fd, f->data, size, 0), (ssize_t) size);
+
+	for (i = 0; i < NR_BLOCKS; i++) {
+		block = f->data + i * f->block_size;
+		for (j = 0; j < f->block_size; j++)
+			T_ASSERT_EQUAL(block[j], dm_bit(written, i) ? i : FILE_FILL);
+	}
+}
+
+static void _set_blocks(dm_bitset_t bs, const int *blocks, unsigned count)
+{
+	unsigned i;
+
+	for (i = 0; i < count; i++)
+		dm_bit_set(bs, blocks[i]);
+}
+
+static void _test_mark_dirty(void *fixture)
+{
+	struct fixture *f = fixture;
+	size_t bs = f->block_size;
+
+	disk_log_mark_dirty(f->dirty, bs, 0);
+	disk_log_mark_dirty(f->dirty, bs, bs - 1);
+	T_ASSERT(dm_bit(f->dirty, 0));
+	T_ASSERT_EQUAL(dm_bit_get_next(f->dirty, 0), -1);
+
+	disk_log_mark_dirty(f->dirty, bs, bs);
+	disk_log_mark_dirty(f->dirty, bs, 5 * bs + 17);
+	disk_log_mark_dirty(f->dirty, bs, NR_BLOCKS * bs - 1);
+	T_ASSERT(dm_bit(f->dirty, 1));
+	T_ASSERT(dm_bit(f->dirty, 5));
+	T_ASSERT(dm_bit(f->dirty, NR_BLOCKS - 1));
+	T_ASSERT(!dm_bit(f->dirty, 2));
+	T_ASSERT(!dm_bit(f->dirty, 6));
+}
+
+static void _test_nothing_dirty(void *fixture)
+{
+	struct fixture *f = fixture;
+
+	T_ASSERT_EQUAL(disk_log_write_dirty(f->fd, f->buffer, f->block_size, f->dirty), 0);
+	_check_file(f, f->dirty);
+}
+
+static void _test_coalesce_runs(void *fixture)
+{
+	struct fixture *f = fixture;
+	static const int blocks[] = { 0, 1, 2, 5, 7, 8, 31, 32, 33, NR_BLOCKS - 1 };
+	dm_bitset_t written = dm_bitset_create(NULL, NR_BLOCKS);
+
+	T_ASSERT(written);
+	_set_blocks(f->dirty, blocks, DM_ARRAY_SIZE(blocks));
+	_set_blocks(written, blocks, DM_ARRAY_SIZE(blocks));
+
+	/* runs 0-2, 5, 7-8, 31-33 (across a bitset word) and the last block */
+	T_ASSERT_EQUAL(disk_log_write_dirty(f->fd, f->buffer, f->block_size, f->dirty), 5);
+	T_ASSERT_EQUAL(dm_bit_get_first(f->dirty), -1);
+	_check_file(f, written);
+
+	/* clean blocks are not written again */
+	T_ASSERT_EQUAL(disk_log_write_dirty(f->fd, f->buffer, f->block_size, f->dirty), 0);
+
+	dm_bitset_destroy(written);
+}
+
+static void _test_all_dirty(void *fixture)
+{
+	struct fixture *f = fixture;
+
+	dm_bit_set_range(f->dirty, 0, NR_BLOCKS);
+	T_ASSERT_EQUAL(disk_log_write_dirty(f->fd, f->buffer, f->block_size, f->dirty), 1);
+	T_ASSERT_EQUAL(dm_bit_get_first(f->dirty), -1);
+
+	dm_bit_set_range(f->dirty, 0, NR_BLOCKS);
+	_check_file(f, f->dirty);
+}
+
+static void _test_failed_write_stays_dirty(void *fixture)
+{
+	struct fixture *f = fixture;
+	static const int blocks[] = { 2, 3, 10 };
+	int fd;
+
+	T_ASSERT((fd = open(f->fname, O_RDONLY)) >= 0);
+
+	_set_blocks(f->dirty, blocks, DM_ARRAY_SIZE(blocks));
+	T_ASSERT_EQUAL(disk_log_write_dirty(fd, f->buffer, f->block_size, f->dirty), -EBADF);
+	(void) close(fd);
+
+	T_ASSERT(dm_bit(f->dirty, 2));
+	T_ASSERT(dm_bit(f->dirty, 3));
+	T_ASSERT(dm_bit(f->dirty, 10));
+
+	/* retried on the next flush */
+	T_ASSERT_EQUAL(disk_log_write_dirty(f->fd, f->buffer, f->block_size, f->dirty), 2);
+	T_ASSERT_EQUAL(dm_bit_get_first(f->dirty), -1);
+}
+
+#define T(path, desc, fn) register_test(ts, "/daemons/cmirrord/disk-log/" path, desc, fn)
+
+void disk_log_tests(struct dm_list *all_tests)
+{
+	struct test_suite *ts = test_suite_create(_fix_init, _fix_exit);
+	if (!ts) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	T("mark-dirty", "offsets mark the block holding them", _test_mark_dirty);
+	T("nothing-dirty", "no writes without dirty blocks", _test_nothing_dirty);
+	T("coalesce-runs", "one write per run of dirty blocks", _test_coalesce_runs);
+	T("all-dirty", "a fully dirty log is written at once", _test_all_dirty);
+	T("failed-write", "blocks of a failed write stay dirty", _test_failed_write_stays_dirty);
+
+	dm_list_add(all_tests, &ts->list);
+}
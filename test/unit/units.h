@@ -24,6 +24,7 @@ void bcache_tests(struct dm_list *suites);
 void bcache_utils_tests(struct dm_list *suites);
 void bitset_tests(struct dm_list *suites);
 void config_tests(struct dm_list *suites);
+void disk_log_tests(struct dm_list *suites);
 void dm_list_tests(struct dm_list *suites);
 void dm_status_tests(struct dm_list *suites);
 void io_engine_tests(struct dm_list *suites);
@@ -32,6 +33,7 @@ void radix_tree_tests(struct dm_list *suites);
 void regex_tests(struct dm_list *suites);
 void string_tests(struct dm_list *suites);
 void vdo_tests(struct dm_list *suites);
+void vg_import_tests(struct dm_list *suites);
 
 // ... and call it in here.
 static inline void register_all_tests(struct dm_list *suites)
@@ -40,6 +42,7 @@ static inline void register_all_tests(struct dm_list *suites)
 	bcache_utils_tests(suites);
 	bitset_tests(suites);
 	config_tests(suites);
+	disk_log_tests(suites);
 	dm_list_tests(suites);
 	dm_status_tests(suites);
 	io_engine_tests(suites);
@@ -48,6 +51,7 @@ static inline void register_all_tests(struct dm_list *suites)
 	regex_tests(suites);
 	string_tests(suites);
 	vdo_tests(suites);
+	vg_import_tests(suites);
 }
 
 //-----------------------------------------------------------------
@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2023 Red Hat, Inc. All rights reserved.
+ *
+ * This file is part of LVM2.
+ *
+ * This copyrighted material is made available to anyone wishing to use,
+ * modify, copy, or redistribute it subject to the terms and conditions
+ * of the GNU General Public License v.2.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "units.h"
+#include "lib/misc/lib.h"
+#include "lib/commands/toolcontext.h"
+#include "lib/metadata/metadata.h"
+#include "lib/metadata/segtype.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+//----------------------------------------------------------------
+
+#define NR_PVS 4
+#define BENCH_LVS 20000
+#define BENCH_WALKS 20
+#define VALIDATE_LVS 10000
+
+static void *_fix_init(void)
+{
+	struct cmd_context *cmd;
+	char dir[PATH_MAX];
+
+	/* The test runs in an empty directory: no lvm.conf there. */
+	T_ASSERT(getcwd(dir, sizeof(dir)));
+
+	if (!(cmd = create_toolcontext(0, dir, 0, 0, 0, 0)))
+		test_fail("create_toolcontext failed");
+
+	return cmd;
+}
+
+static void _fix_exit(void *fixture)
+{
+	destroy_toolcontext(fixture);
+}
+
+/* Each LV has its own sanlock lease, 1MiB apart. */
+static unsigned long long _sanlock_offset(unsigned lv)
+{
+	return 70254592ULL + lv * 1048576ULL;
+}
+
+struct text {
+	char *buf;
+	size_t size, len;
+};
+
+static void _emit(struct text *t, const char *fmt, ...)
+	__attribute__ ((format(printf, 2, 3)));
+
+static void _emit(struct text *t, const char *fmt, ...)
+{
+	va_list ap;
+	int n;
+
+	for (;;) {
+		va_start(ap, fmt);
+		n = vsnprintf(t->buf + t->len, t->size - t->len, fmt, ap);
+		va_end(ap);
+		T_ASSERT(n >= 0);
+
+		if ((size_t) n < t->size - t->len)
+			break;
+
+		t->size = t->size * 2 + n;
+		T_ASSERT(t->buf = realloc(t->buf, t->size));
+	}
+
+	t->len += n;
+}
+
+/*
+ * Metadata of a VG with @lvs LVs, each with 2 striped segments and
+ * 3 tags.  LV lock_args depend on @lock_type.  With @unique_tags the
+ * first tag of each LV is not used by any other LV.
+ */
+static struct dm_config_tree *_gen_vg(unsigned lvs, const char *lock_type, int unique_tags)
+{
+	struct dm_config_tree *cft;
+	struct text t = { 0 };
+	char tag[16];
+	unsigned i, s;
+
+	_emit(&t, "vg {\nid = \"aaaaaa-aaaa-aaaa-aaaa-aaaa-aaaa-aaaaaa\"\n"
+		  "seqno = 1\nformat = \"lvm2\"\n"
+		  "status = [\"RESIZEABLE\", \"READ\", \"WRITE\"]\nflags = []\n"
+		  "tags = [\"vgtag\"]\nextent_size = 8192\n"
+		  "max_lv = 0\nmax_pv = 0\nmetadata_copies = 0\n");
+	if (lock_type)
+		_emit(&t, "lock_type = \"%s\"\n", lock_type);
+
+	_emit(&t, "physical_volumes {\n");
+	for (i = 0; i < NR_PVS; i++)
+		_emit(&t, "pv%u {\nid = \"bbbbbb-bbbb-bbbb-bbbb-bbbb-bbbb-bbbbb%u\"\n"
+			  "device = \"/dev/sd%c\"\nstatus = [\"ALLOCATABLE\"]\nflags = []\n"
+			  "dev_size = 100000000000\npe_start = 2048\npe_count = %u\n}\n",
+		      i, i, 'a' + i, lvs * 2);
+	_emit(&t, "}\n");
+
+	_emit(&t, "logical_volumes {\n");
+	for (i = 0; i < lvs; i++) {
+		if (unique_tags)
+			snprintf(tag, sizeof(tag), "lv%u", i);
+		else
+			strcpy(tag, "daily");
+		_emit(&t, "lv%u {\nid = \"cccccc-cccc-cccc-cccc-cccc-cccc-%06u\"\n"
+			  "status = [\"READ\", \"WRITE\", \"VISIBLE\"]\nflags = []\n"
+			  "tags = [\"backup_%s\", \"storage_tier%u\", \"owner_%s_project\"]\n"
+			  "creation_time = 1600000000\ncreation_host = \"host%u\"\n"
+			  "segment_count = 2\n",
+		      i, i, tag, i % 3, (i % 2) ? "alice" : "bob", i % 4);
+		if (lock_type && !strcmp(lock_type, "dlm"))
+			_emit(&t, "lock_args = \"dlm\"\n");
+		else if (lock_type)
+			_emit(&t, "lock_args = \"1.0.0:%llu\"\n", _sanlock_offset(i));
+		for (s = 0; s < 2; s++)
+			_emit(&t, "segment%u {\nstart_extent = %u\nextent_count = 1\n"
+				  "type = \"striped\"\nstripe_count = 1\n"
+				  "stripes = [\n\"pv%u\", %u\n]\n}\n",
+			      s + 1, s, (i + s) % NR_PVS, i);
+		_emit(&t, "}\n");
+	}
+	_emit(&t, "}\n}\n");
+
+	T_ASSERT(cft = dm_config_from_string(t.buf));
+	free(t.buf);
+
+	return cft;
+}
+
+static struct volume_group *_import(struct cmd_context *cmd, unsigned lvs, const char *lock_type)
+{
+	struct dm_config_tree *cft = _gen_vg(lvs, lock_type, 0);
+	struct volume_group *vg;
+
+	T_ASSERT(vg = vg_from_config_tree(cmd, cft));
+	dm_config_destroy(cft);
+	T_ASSERT_EQUAL(dm_list_size(&vg->lvs), lvs);
+
+	return vg;
+}
+
+static void _test_dlm_lock_args(void *fixture)
+{
+	struct volume_group *vg = _import(fixture, 100, "dlm");
+	const char *lock_args = NULL;
+	struct lv_list *lvl;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		T_ASSERT(!strcmp(lvl->lv->lock_args, "dlm"));
+		if (!lock_args)
+			lock_args = lvl->lv->lock_args;
+		T_ASSERT(lvl->lv->lock_args == lock_args);
+	}
+
+	release_vg(vg);
+}
+
+static void _test_sanlock_lock_args(void *fixture)
+{
+	struct volume_group *vg = _import(fixture, 100, "sanlock");
+	struct lv_list *lvl;
+	char buf[64];
+	unsigned i = 0;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		snprintf(buf, sizeof(buf), "1.0.0:%llu", _sanlock_offset(i++));
+		T_ASSERT(!strcmp(lvl->lv->lock_args, buf));
+		/* unique values are not kept in the VG string table */
+		T_ASSERT(!dm_hash_lookup(vg->strings, buf));
+	}
+
+	release_vg(vg);
+}
+
+static void _test_shared_tags(void *fixture)
+{
+	struct volume_group *vg = _import(fixture, 100, NULL);
+	const char *owner[2] = { NULL, NULL };
+	struct dm_str_list *sl;
+	struct lv_list *lvl;
+	unsigned i = 0;
+
+	dm_list_iterate_items(lvl, &vg->lvs) {
+		T_ASSERT_EQUAL(dm_list_size(&lvl->lv->tags), 3);
+		sl = dm_list_item(dm_list_last(&lvl->lv->tags), struct dm_str_list);
+		T_ASSERT(!strcmp(sl->str, (i % 2) ? "owner_alice_project" : "owner_bob_project"));
+		if (!owner[i % 2])
+			owner[i % 2] = sl->str;
+		T_ASSERT(sl->str == owner[i % 2]);
+		i++;
+	}
+
+	release_vg(vg);
+}
+
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Allocated heap, including large mmap()ed blocks such as pool chunks. */
+static size_t _heap_used(void)
+{
+#ifdef HAVE_MALLINFO2
+	struct mallinfo2 mi = mallinfo2();
+
+	return mi.uordblks + mi.hblkhd;
+#else
+	struct mallinfo mi = mallinfo();
+
+	return (size_t) (unsigned) mi.uordblks + (size_t) (unsigned) mi.hblkhd;
+#endif
+}
+
+/*
+ * Not a pass/fail test: reports memory used by an imported VG with many
+ * LVs, import time and the time of walking LVs, segments and tags as
+ * reporting commands do.
+ */
+static void _test_benchmark(void *fixture)
+{
+	struct cmd_context *cmd = fixture;
+	struct dm_config_tree *cft = _gen_vg(BENCH_LVS, "sanlock", 0);
+	struct volume_group *vg;
+	struct lv_list *lvl;
+	struct lv_segment *seg;
+	struct dm_str_list *sl;
+	unsigned long sum = 0;
+	double t0, t1, t2;
+	size_t heap;
+	uint32_t s;
+	int i;
+
+	heap = _heap_used();
+	t0 = _now();
+	T_ASSERT(vg = vg_from_config_tree(cmd, cft));
+	t1 = _now();
+	heap = _heap_used() - heap;
+
+	for (i = 0; i < BENCH_WALKS; i++)
+		dm_list_iterate_items(lvl, &vg->lvs) {
+			sum += strlen(lvl->lv->name) + lvl->lv->lock_args[0];
+			dm_list_iterate_items(sl, &lvl->lv->tags)
+				sum += sl->str[0];
+			dm_list_iterate_items(seg, &lvl->lv->segments) {
+				sum += seg->len + seg->segtype->name[0];
+				for (s = 0; s < seg->area_count; s++)
+					if (seg_type(seg, s) == AREA_PV)
+						sum += seg_pe(seg, s) + seg_pv(seg, s)->pe_count;
+			}
+		}
+	t2 = _now();
+
+	T_ASSERT(sum);
+	fprintf(stderr, "  %u LVs: import %.1f ms, memory %.2f MiB, walk x%d %.1f ms\n",
+	       BENCH_LVS, (t1 - t0) * 1e3, heap / 1048576.0, BENCH_WALKS, (t2 - t1) * 1e3);
+
+	release_vg(vg);
+	dm_config_destroy(cft);
+}
+
+/* Imported VG with the format instance that vg_validate() needs. */
+static struct volume_group *_import_with_fid(struct cmd_context *cmd, unsigned lvs)
+{
+	struct volume_group *vg = _import(cmd, lvs, NULL);
+	struct format_instance_ctx fic = {
+		.type = FMT_INSTANCE_MDAS | FMT_INSTANCE_AUX_MDAS,
+		.context.vg_ref.vg_name = vg->name
+	};
+	struct format_instance *fid;
+
+	T_ASSERT(fid = cmd->fmt->ops->create_instance(cmd->fmt, &fic));
+	vg_set_fid(vg, fid);
+
+	return vg;
+}
+
+static void _test_validate_changed(void *fixture)
+{
+	struct volume_group *vg = _import_with_fid(fixture, 100);
+	struct logical_volume *lv = dm_list_item(dm_list_first(&vg->lvs), struct lv_list)->lv;
+	struct lv_list *lvl;
+
+	T_ASSERT(vg_validate(vg));
+	dm_list_iterate_items(lvl, &vg->lvs)
+		T_ASSERT(lvl->lv->validated);
+
+	lv_set_changed(lv);
+	T_ASSERT(!lv->validated);
+	T_ASSERT(vg_validate_changed(vg));
+	T_ASSERT(lv->validated);
+
+	release_vg(vg);
+}
+
+/*
+ * Not a pass/fail test: reports the time of checking all segments of
+ * a VG with many LVs, and of checking only those of one changed LV.
+ */
+static void _test_validate_benchmark(void *fixture)
+{
+	struct volume_group *vg = _import_with_fid(fixture, VALIDATE_LVS);
+	struct logical_volume *lv = dm_list_item(dm_list_first(&vg->lvs), struct lv_list)->lv;
+	double t0, t1, t2;
+
+	t0 = _now();
+	T_ASSERT(vg_validate(vg));
+	t1 = _now();
+	lv_set_changed(lv);
+	T_ASSERT(vg_validate_changed(vg));
+	t2 = _now();
+
+	fprintf(stderr, "  %u LVs: full validate %.1f ms, one changed LV %.1f ms\n",
+		VALIDATE_LVS, (t1 - t0) * 1e3, (t2 - t1) * 1e3);
+
+	release_vg(vg);
+}
+
+/*
+ * Not a pass/fail test: reports import time of a VG with many LVs when
+ * all LVs share their tags and when each LV has a tag of its own.
+ */
+static void _test_unique_tags_benchmark(void *fixture)
+{
+	struct cmd_context *cmd = fixture;
+	struct dm_config_tree *cft;
+	struct volume_group *vg;
+	unsigned strings[2];
+	double t[2];
+	int unique;
+
+	for (unique = 0; unique < 2; unique++) {
+		cft = _gen_vg(BENCH_LVS, NULL, unique);
+		t[unique] = _now();
+		T_ASSERT(vg = vg_from_config_tree(cmd, cft));
+		t[unique] = _now() - t[unique];
+		strings[unique] = dm_hash_get_num_entries(vg->strings);
+		release_vg(vg);
+		dm_config_destroy(cft);
+	}
+
+	/* backup_daily is replaced by one tag per LV */
+	T_ASSERT_EQUAL(strings[1], strings[0] + BENCH_LVS - 1);
+	fprintf(stderr, "  %u LVs: import with shared tags %.1f ms, unique tags %.1f ms\n",
+		BENCH_LVS, t[0] * 1e3, t[1] * 1e3);
+}
+
+#define T(path, desc, fn) register_test(ts, "/metadata/vg-import/" path, desc, fn)
+
+void vg_import_tests(struct dm_list *all_tests)
+{
+	struct test_suite *ts = test_suite_create(_fix_init, _fix_exit);
+	if (!ts) {
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	T("dlm-lock-args", "dlm lock_args are shared by all LVs", _test_dlm_lock_args);
+	T("sanlock-lock-args", "sanlock lock_args are not interned", _test_sanlock_lock_args);
+	T("shared-tags", "LV tags are shared by all LVs", _test_shared_tags);
+	T("benchmark", "import memory and walk time of a large VG", _test_benchmark);
+	T("validate-changed", "validation of changed LVs only", _test_validate_changed);
+	T("validate-benchmark", "validation time of a large VG", _test_validate_benchmark);
+	T("unique-tags-benchmark", "import time of a large VG with unique tags", _test_unique_tags_benchmark);
+
+	dm_list_add(all_tests, &ts->list);
+}
@@ -277,6 +277,12 @@ struct opt_name *opt_names_alpha[ARG_COUNT + 1];
 
 struct command lvm_all;
 
+#define MAX_LINE 1024
+#define MAX_LINE_ARGC 256
+#define DESC_LINE 1024
+
+#ifdef MAN_PAGE_GENERATOR
+
 /* saves OO_FOO lines (groups of optional options) to include in multiple defs */
 
 static int _oo_line_count;
@@ -292,19 +298,50 @@ static struct oo_line _oo_lines[MAX_OO_LINES];
 #define OPTIONAL 0  /* optional option */
 #define IGNORE (-1)   /* ignore option */
 
-#define MAX_LINE 1024
-#define MAX_LINE_ARGC 256
-#define DESC_LINE 1024
-
 /*
  * Contains _command_input[] which is command-lines.in with comments
  * removed and wrapped as a string.  The _command_input[] string is
- * used to populate commands[].
+ * parsed by the generator to populate commands[].
  */
 #include "command-lines-input.h"
 
 static void __add_optional_opt_line(struct cmd_context *cmdtool, struct command *cmd, int argc, char *argv[]);
 
+#else /* MAN_PAGE_GENERATOR */
+
+/*
+ * lvm does not parse command-lines.in, the man-generator built from
+ * this file does that at build time and writes the resulting command
+ * definitions as static tables into command-defs.h (--c-tables).
+ * define_commands() expands them into commands[].
+ */
+struct command_def {
+	const char *name;
+	const char *desc;
+	const char *command_id;
+	int command_enum;
+	unsigned int cmd_flags;
+	const char *autotype;
+	const char *autotype2;
+	const struct opt_arg *required_opt_args;
+	const struct opt_arg *optional_opt_args;
+	const struct pos_arg *required_pos_args;
+	const struct pos_arg *optional_pos_args;
+	const struct opt_arg *ignore_opt_args;
+	const struct cmd_rule *rules;
+	int any_ro_count;
+	int ro_count;
+	int oo_count;
+	int rp_count;
+	int op_count;
+	int io_count;
+	int rule_count;
+};
+
+#include "command-defs.h"
+
+#endif /* MAN_PAGE_GENERATOR */
+
 static unsigned _was_hyphen = 0;
 static void printf_hyphen(char c)
 {
@@ -313,6 +350,8 @@ static void printf_hyphen(char c)
 	_was_hyphen = 0;
 }
 
+#ifdef MAN_PAGE_GENERATOR
+
 /*
  * modifies buf, replacing the sep characters with \0
  * argv pointers point to positions in buf
@@ -432,6 +471,8 @@ static int _opt_str_to_num(struct command *cmd, char *str)
 	return ARG_UNUSED;
 }
 
+#endif /* MAN_PAGE_GENERATOR */
+
 /* "foo" string to foo_CMD int */
 
 int command_id_to_enum(const char *str)
@@ -453,6 +494,8 @@ int command_id_to_enum(const char *str)
 	return CMD_NONE;
 }
 
+#ifdef MAN_PAGE_GENERATOR
+
 /* "lv_is_prop" to is_prop_LVP */
 
 static int _lvp_name_to_enum(struct command *cmd, char *str)
@@ -527,6 +570,8 @@ static uint64_t _lv_to_bits(struct command *cmd, char *name)
 	return lvt_bits;
 }
 
+#endif /* MAN_PAGE_GENERATOR */
+
 struct command_name *find_command_name(const char *name)
 {
 	static int _command_names_count = -1;
@@ -572,6 +617,8 @@ static struct command_name *_find_command_name(const char *name)
 	return find_command_name(name);
 }
 
+#ifdef MAN_PAGE_GENERATOR
+
 static const char *_is_command_name(char *str)
 {
 	const struct command_name *c;
@@ -1318,6 +1365,8 @@ static void _add_rule(struct cmd_context *cmdtool, struct command *cmd, char *li
 	}
 }
 
+#endif /* MAN_PAGE_GENERATOR */
+
 /* The given option is common to all lvm commands (set in lvm_all). */
 
 static int _is_lvm_all_opt(int opt)
@@ -1433,6 +1482,8 @@ static void _create_opt_names_alpha(void)
 	qsort(opt_names_alpha, ARG_COUNT, sizeof(long), _long_name_compare);
 }
 
+#ifdef MAN_PAGE_GENERATOR
+
 static int _copy_line(char *line, int max_line, int *position)
 {
 	int p = *position;
@@ -1670,6 +1721,86 @@ int define_commands(struct cmd_context *cmdtool, const char *run_name)
 	return 1;
 }
 
+#else /* MAN_PAGE_GENERATOR */
+
+int define_commands(struct cmd_context *cmdtool, const char *run_name)
+{
+	const struct command_def *def;
+	struct command_name *cname = NULL;
+	struct command *cmd;
+	int i;
+
+	if (run_name && !strcmp(run_name, "help"))
+		run_name = NULL;
+
+	_create_opt_names_alpha();
+
+	/* Expand the tables generated from command-lines.in into commands[] */
+
+	for (i = 0; i < COMMAND_COUNT; i++) {
+		def = &_command_defs[i];
+		cmd = &commands[i];
+
+		/* command defs with the same name are adjacent in command-lines.in */
+		if (!cname || strcmp(cname->name, def->name)) {
+			if (!(cname = find_command_name(def->name))) {
+				log_error("Unknown command name %s in command definitions.", def->name);
+				return 0;
+			}
+			cname->first_command = i;
+			cname->num_commands = 0;
+		}
+		cname->num_commands++;
+
+		cmd->command_index = i;
+		cmd->name = def->name;
+		cmd->command_id = def->command_id;
+		cmd->command_enum = def->command_enum;
+
+		if (run_name && strcmp(run_name, def->name))
+			continue;
+
+		cmd->desc = def->desc;
+		cmd->cmd_flags = def->cmd_flags;
+		cmd->autotype = def->autotype;
+		cmd->autotype2 = def->autotype2;
+
+		cmd->any_ro_count = def->any_ro_count;
+		cmd->ro_count = def->ro_count;
+		cmd->oo_count = def->oo_count;
+		cmd->rp_count = def->rp_count;
+		cmd->op_count = def->op_count;
+		cmd->io_count = def->io_count;
+		cmd->rule_count = def->rule_count;
+
+		if (def->ro_count + def->any_ro_count)
+			memcpy(cmd->required_opt_args, def->required_opt_args,
+			       (def->ro_count + def->any_ro_count) * sizeof(struct opt_arg));
+		if (def->oo_count)
+			memcpy(cmd->optional_opt_args, def->optional_opt_args,
+			       def->oo_count * sizeof(struct opt_arg));
+		if (def->rp_count)
+			memcpy(cmd->required_pos_args, def->required_pos_args,
+			       def->rp_count * sizeof(struct pos_arg));
+		if (def->op_count)
+			memcpy(cmd->optional_pos_args, def->optional_pos_args,
+			       def->op_count * sizeof(struct pos_arg));
+		if (def->io_count)
+			memcpy(cmd->ignore_opt_args, def->ignore_opt_args,
+			       def->io_count * sizeof(struct opt_arg));
+		if (def->rule_count)
+			memcpy(cmd->rules, def->rules,
+			       def->rule_count * sizeof(struct cmd_rule));
+	}
+
+	lvm_all.oo_count = DM_ARRAY_SIZE(_lvm_all_oo);
+	memcpy(lvm_all.optional_opt_args, _lvm_all_oo, sizeof(_lvm_all_oo));
+
+	return 1;
+}
+
+#endif /* MAN_PAGE_GENERATOR */
+
 /*
  * The opt_names[] table describes each option.  It is indexed by the
  * option typedef, e.g. size_ARG.  The size_ARG entry specifies the
@@ -3940,6 +4071,248 @@ static int _check_overlap(void)
 	return r;
 }
 
+/*
+ * Print the parsed command definitions as C tables that lvm
+ * includes (command-defs.h) instead of parsing command-lines.in
+ * each time it starts.
+ */
+
+static void _print_c_string(const char *str)
+{
+	if (!str) {
+		printf("NULL");
+		return;
+	}
+
+	putchar('"');
+	for (; *str; str++) {
+		if ((*str == '"') || (*str == '\\'))
+			putchar('\\');
+		putchar(*str);
+	}
+	putchar('"');
+}
+
+static void _print_c_arg_def(const struct arg_def *def)
+{
+	printf("{ 0x%llxULL, 0x%llxULL, %lluULL, ",
+	       (unsigned long long)def->val_bits,
+	       (unsigned long long)def->lvt_bits,
+	       (unsigned long long)def->num);
+	_print_c_string(def->str);
+	printf(", 0x%x }", def->flags);
+}
+
+static int _opt_args_equal(const struct opt_arg *args1, const struct opt_arg *args2, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if ((args1[i].opt != args2[i].opt) ||
+		    (args1[i].def.val_bits != args2[i].def.val_bits) ||
+		    (args1[i].def.lvt_bits != args2[i].def.lvt_bits) ||
+		    (args1[i].def.num != args2[i].def.num) ||
+		    (args1[i].def.flags != args2[i].def.flags) ||
+		    (!args1[i].def.str != !args2[i].def.str) ||
+		    (args1[i].def.str && strcmp(args1[i].def.str, args2[i].def.str)))
+			return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Many command defs share the same list of optional options,
+ * so the list printed for the first of them is reused.
+ */
+static int _first_same_oo(int ci)
+{
+	int cj;
+
+	for (cj = 0; cj < ci; cj++) {
+		if ((commands[cj].oo_count == commands[ci].oo_count) &&
+		    _opt_args_equal(commands[cj].optional_opt_args,
+				    commands[ci].optional_opt_args, commands[ci].oo_count))
+			return cj;
+	}
+
+	return ci;
+}
+
+static void _print_c_opt_args(const char *array, int ci, const struct opt_arg *args, int count)
+{
+	int i;
+
+	if (!count)
+		return;
+
+	printf("static const struct opt_arg _cmd%d_%s[] = {\n", ci, array);
+	for (i = 0; i < count; i++) {
+		printf("\t{ %s, ", opt_names[args[i].opt].name);
+		_print_c_arg_def(&args[i].def);
+		printf(" },\n");
+	}
+	printf("};\n");
+}
+
+static void _print_c_pos_args(const char *array, int ci, const struct pos_arg *args, int count)
+{
+	int i;
+
+	if (!count)
+		return;
+
+	printf("static const struct pos_arg _cmd%d_%s[] = {\n", ci, array);
+	for (i = 0; i < count; i++) {
+		printf("\t{ %d, ", args[i].pos);
+		_print_c_arg_def(&args[i].def);
+		printf(" },\n");
+	}
+	printf("};\n");
+}
+
+static void _print_c_rule_opts(const char *array, int ci, int ri, const int *opts, int count)
+{
+	int i;
+
+	if (!count)
+		return;
+
+	printf("static int _cmd%d_rule%d_%s[] = {", ci, ri, array);
+	for (i = 0; i < count; i++)
+		printf(" %s,", opt_names[opts[i]].name);
+	printf(" };\n");
+}
+
+static void _print_c_array_ref(const char *array, int ci, int count)
+{
+	if (count)
+		printf("_cmd%d_%s", ci, array);
+	else
+		printf("NULL");
+}
+
+static void _print_c_rules(int ci, const struct command *cmd)
+{
+	const struct cmd_rule *rule;
+	int ri;
+
+	if (!cmd->rule_count)
+		return;
+
+	for (ri = 0; ri < cmd->rule_count; ri++) {
+		rule = &cmd->rules[ri];
+		_print_c_rule_opts("opts", ci, ri, rule->opts, rule->opts_count);
+		_print_c_rule_opts("check_opts", ci, ri, rule->check_opts, rule->check_opts_count);
+	}
+
+	printf("static const struct cmd_rule _cmd%d_rules[] = {\n", ci);
+	for (ri = 0; ri < cmd->rule_count; ri++) {
+		rule = &cmd->rules[ri];
+		printf("\t{ .opts = ");
+		if (rule->opts_count)
+			printf("_cmd%d_rule%d_opts", ci, ri);
+		else
+			printf("NULL");
+		printf(", .lvt_bits = 0x%llxULL, .lvp_bits = 0x%llxULL,\n\t  .check_opts = ",
+		       (unsigned long long)rule->lvt_bits,
+		       (unsigned long long)rule->lvp_bits);
+		if (rule->check_opts_count)
+			printf("_cmd%d_rule%d_check_opts", ci, ri);
+		else
+			printf("NULL");
+		printf(", .check_lvt_bits = 0x%llxULL, .check_lvp_bits = 0x%llxULL,\n"
+		       "\t  .rule = %u, .opts_count = %d, .check_opts_count = %d },\n",
+		       (unsigned long long)rule->check_lvt_bits,
+		       (unsigned long long)rule->check_lvp_bits,
+		       rule->rule, rule->opts_count, rule->check_opts_count);
+	}
+	printf("};\n");
+}
+
+static int _print_c_tables(void)
+{
+	struct command *cmd;
+	int ci, i;
+
+	for (ci = 0; ci < COMMAND_COUNT; ci++) {
+		cmd = &commands[ci];
+
+		if (!cmd->name || !cmd->command_id || !command_id_to_enum(cmd->command_id)) {
+			log_error("Incomplete command definition %d.", ci);
+			return 0;
+		}
+
+		/* define_commands() expects the defs of each name to be adjacent. */
+		if (ci && strcmp(cmd->name, commands[ci - 1].name))
+			for (i = 0; i < ci - 1; i++)
+				if (!strcmp(cmd->name, commands[i].name)) {
+					log_error("Definitions of command %s (%s) are not adjacent in command-lines.in.",
+						  cmd->name, cmd->command_id);
+					return 0;
+				}
+	}
+
+	printf("/* Do not edit. This file is generated by man-generator --c-tables. */\n\n");
+
+	for (ci = 0; ci < COMMAND_COUNT; ci++) {
+		cmd = &commands[ci];
+
+		_print_c_opt_args("ro", ci, cmd->required_opt_args, cmd->ro_count + cmd->any_ro_count);
+		if (_first_same_oo(ci) == ci)
+			_print_c_opt_args("oo", ci, cmd->optional_opt_args, cmd->oo_count);
+		_print_c_pos_args("rp", ci, cmd->required_pos_args, cmd->rp_count);
+		_print_c_pos_args("op", ci, cmd->optional_pos_args, cmd->op_count);
+		_print_c_opt_args("io", ci, cmd->ignore_opt_args, cmd->io_count);
+		_print_c_rules(ci, cmd);
+	}
+
+	printf("\nstatic const struct command_def _command_defs[COMMAND_COUNT] = {\n");
+	for (ci = 0; ci < COMMAND_COUNT; ci++) {
+		cmd = &commands[ci];
+
+		printf("{\n\t.name = ");
+		_print_c_string(cmd->name);
+		printf(",\n\t.desc = ");
+		_print_c_string(cmd->desc);
+		printf(",\n\t.command_id = ");
+		_print_c_string(cmd->command_id);
+		printf(",\n\t.command_enum = %s_CMD,\n", cmd->command_id);
+		printf("\t.cmd_flags = 0x%x,\n\t.autotype = ", cmd->cmd_flags);
+		_print_c_string(cmd->autotype);
+		printf(",\n\t.autotype2 = ");
+		_print_c_string(cmd->autotype2);
+		printf(",\n\t.required_opt_args = ");
+		_print_c_array_ref("ro", ci, cmd->ro_count + cmd->any_ro_count);
+		printf(",\n\t.optional_opt_args = ");
+		_print_c_array_ref("oo", _first_same_oo(ci), cmd->oo_count);
+		printf(",\n\t.required_pos_args = ");
+		_print_c_array_ref("rp", ci, cmd->rp_count);
+		printf(",\n\t.optional_pos_args = ");
+		_print_c_array_ref("op", ci, cmd->op_count);
+		printf(",\n\t.ignore_opt_args = ");
+		_print_c_array_ref("io", ci, cmd->io_count);
+		printf(",\n\t.rules = ");
+		_print_c_array_ref("rules", ci, cmd->rule_count);
+		printf(",\n\t.any_ro_count = %d, .ro_count = %d, .oo_count = %d,"
+		       " .rp_count = %d, .op_count = %d, .io_count = %d, .rule_count = %d\n},\n",
+		       cmd->any_ro_count, cmd->ro_count, cmd->oo_count,
+		       cmd->rp_count, cmd->op_count, cmd->io_count, cmd->rule_count);
+	}
+	printf("};\n\n");
+
+	/* OO_ALL options common to all commands (lvm_all). */
+	printf("static const struct opt_arg _lvm_all_oo[] = {\n");
+	for (ci = 0; ci < lvm_all.oo_count; ci++) {
+		printf("\t{ %s, ", opt_names[lvm_all.optional_opt_args[ci].opt].name);
+		_print_c_arg_def(&lvm_all.optional_opt_args[ci].def);
+		printf(" },\n");
+	}
+	printf("};\n");
+
+	return 1;
+}
+
 #define	STDOUT_BUF_SIZE	 (MAX_MAN_DESC + 4 * 1024)
 
 int main(int argc, char *argv[])
@@ -3951,6 +4324,7 @@ int main(int argc, char *argv[])
 	int primary = 0;
 	int secondary = 0;
 	int check = 0;
+	int c_tables = 0;
 	int r = 0;
 	size_t sz = STDOUT_BUF_SIZE;
 
@@ -3958,6 +4332,7 @@ int main(int argc, char *argv[])
 		{"primary", no_argument, 0, 'p' },
 		{"secondary", no_argument, 0, 's' },
 		{"check", no_argument, 0, 'c' },
+		{"c-tables", no_argument, 0, 't' },
 		{0, 0, 0, 0 }
 	};
 
@@ -3972,7 +4347,7 @@ int main(int argc, char *argv[])
 		int c;
 		int option_index = 0;
 
-		c = getopt_long(argc, argv, "psc", long_options, &option_index);
+		c = getopt_long(argc, argv, "psct", long_options, &option_index);
 		if (c == -1)
 			break;
 
@@ -3988,11 +4363,21 @@ int main(int argc, char *argv[])
 		case 'c':
 			check = 1;
 			break;
+		case 't':
+			c_tables = 1;
+			break;
 		}
 	}
 
+	if (c_tables) {
+		if (define_commands(&cmdtool, NULL))
+			r = _print_c_tables();
+		goto out_free;
+	}
+
 	if (!primary && !secondary && !check) {
 		log_error("Usage: %s --primary|--secondary|--check <command> [/path/to/description-file].", argv[0]);
+		log_error("       %s --c-tables", argv[0]);
 		goto out_free;
 	}
 
@@ -40,6 +40,10 @@ struct command_name {
 	int valid_args[ARG_COUNT]; /* used for getopt */
 	int num_args;
 
+	/* command defs with this name are commands[first_command..+num_commands] */
+	int first_command;
+	int num_commands;
+
 	/* the following are for generating help and man page output */
 	int common_options[ARG_COUNT]; /* options common to all defs */
 	int all_options[ARG_COUNT];    /* union of options from all defs */
@@ -209,8 +213,8 @@ struct command {
 	struct cmd_rule rules[CMD_MAX_RULES];
 
 	/* usually only one autotype, in one case there are two */
-	char *autotype;
-	char *autotype2;
+	const char *autotype;
+	const char *autotype2;
 
 	int any_ro_count;
 
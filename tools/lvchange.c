@@ -899,6 +899,7 @@ static int _lvchange_writemostly(struct logical_volume *lv,
 		return 0;
 	}
 
+	lv_set_changed(raid_seg->lv);
 	if (arg_is_set(cmd, writebehind_ARG))
 		raid_seg->writebehind = arg_uint_value(cmd, writebehind_ARG, 0);
 
@@ -1107,6 +1108,7 @@ static int _lvchange_compression(struct logical_volume *lv, uint32_t *mr)
 		return 0;
 	}
 
+	lv_set_changed(seg->lv);
 	seg->vdo_params.use_compression = compression;
 
 	/* Request caller to commit and reload metadata */
@@ -1135,6 +1137,7 @@ static int _lvchange_deduplication(struct logical_volume *lv, uint32_t *mr)
 		return 0;
 	}
 
+	lv_set_changed(seg->lv);
 	seg->vdo_params.use_deduplication = deduplication;
 
 	/* Request caller to commit and reload metadata */
@@ -1920,6 +1920,7 @@ static int _lvconvert_split_and_keep_cachevol(struct cmd_context *cmd,
 		}
 
 		/* Switch internally to WRITETHROUGH which does not require flushing */
+		lv_set_changed(cache_seg->lv);
 		cache_seg->cache_mode = CACHE_MODE_WRITETHROUGH;
 	}
 
@@ -2948,6 +2949,7 @@ static int _lvconvert_swap_pool_metadata(struct cmd_context *cmd,
 			}
 		}
 
+		lv_set_changed(seg->lv);
 		seg->chunk_size = chunk_size;
 	}
 
@@ -3403,6 +3405,7 @@ static int _lvconvert_to_pool(struct cmd_context *cmd,
 		if (!cache_set_params(seg, chunk_size, cache_metadata_format, cache_mode, policy_name, policy_settings))
 			goto_bad;
 	} else {
+		lv_set_changed(seg->lv);
 		seg->transaction_id = 0;
 		seg->crop_metadata = crop_metadata;
 		seg->chunk_size = chunk_size;
@@ -81,7 +81,6 @@ extern struct command_name command_names[];
  * Table of commands (as defined in command-lines.in)
  */
 struct command commands[COMMAND_COUNT];
-struct command *commands_idx[COMMAND_COUNT];
 
 static struct cmdline_context _cmdline;
 
@@ -1229,32 +1228,11 @@ static void _set_valid_args_for_command_name(int ci)
 	int opt_enum; /* foo_ARG from args.h */
 	int opt_syn;
 	int i, ro, oo, io;
-	int first = 0, last = COMMAND_COUNT - 1, middle;
-	const char *name = command_names[ci].name;
+	int first = command_names[ci].first_command;
+	int last = first + command_names[ci].num_commands;
 
 	/* all_args is indexed by the foo_ARG enum vals */
-	/* Binary search in sorted array of long options (with duplicates) */
-	while (first <= last) {
-		middle = first + (last - first) / 2;
-		if ((i = strcmp(commands_idx[middle]->name, name)) < 0)
-			first = middle + 1;
-		else if (i > 0)
-			last = middle - 1;
-		else {
-			/* Matching command found.
-			 * As sorted array contains duplicates, found 1st. and last such cmd. */
-			i = middle;
-			while (middle > first && !strcmp(commands_idx[middle - 1]->name, name))
-				middle--;
-			while (i < last && !strcmp(commands_idx[i + 1]->name, name))
-				i++;
-			last = i;
-			break;
-		}
-	}
-
-	while (middle <= last) {
-		i = commands_idx[middle++]->command_index;
+	for (i = first; i < last; i++) {
 		for (ro = 0; ro < (commands[i].ro_count + commands[i].any_ro_count); ro++) {
 			opt_enum = commands[i].required_opt_args[ro].opt;
 			all_args[opt_enum] = 1;
@@ -1327,14 +1305,6 @@ static void _unregister_commands(void)
 	memset(&commands, 0, sizeof(commands));
 }
 
-static int _command_name_compare(const void *on1, const void *on2)
-{
-	const struct command * const *optname1 = on1;
-	const struct command * const *optname2 = on2;
-
-	return strcmp((*optname1)->name, (*optname2)->name);
-}
-
 int lvm_register_commands(struct cmd_context *cmd, const char *run_name)
 {
 	int i;
@@ -1347,10 +1317,10 @@ int lvm_register_commands(struct cmd_context *cmd, const char *run_name)
 
 	/*
 	 * populate commands[] array with command definitions
-	 * by parsing command-lines.in/command-lines-input.h
+	 * from the tables generated from command-lines.in
 	 */
 	if (!define_commands(cmd, run_name)) {
-		log_error(INTERNAL_ERROR "Failed to parse command definitions.");
+		log_error(INTERNAL_ERROR "Failed to set up command definitions.");
 		return 0;
 	}
 
@@ -1358,17 +1328,6 @@ int lvm_register_commands(struct cmd_context *cmd, const char *run_name)
 	_cmdline.num_commands = COMMAND_COUNT;
 
 	for (i = 0; i < COMMAND_COUNT; i++) {
-		commands_idx[i] = &commands[i];
-		commands[i].command_index = i;
-		commands[i].command_enum = command_id_to_enum(commands[i].command_id);
-
-		if (!commands[i].command_enum) {
-			log_error(INTERNAL_ERROR "Failed to find command id %s.", commands[i].command_id);
-			_cmdline.commands = NULL;
-			_cmdline.num_commands = 0;
-			return 0;
-		}
-
 		/* new style */
 		commands[i].functions = _find_command_id_function(commands[i].command_enum);
 
@@ -1380,9 +1339,6 @@ int lvm_register_commands(struct cmd_context *cmd, const char *run_name)
 		}
 	}
 
-	/* Sort all commands by its name for quick binary search */
-	qsort(commands_idx, COMMAND_COUNT, sizeof(long), _command_name_compare);
-
 	for (i = 0; command_names[i].name; i++)
 		_set_valid_args_for_command_name(i);
 
@@ -1684,25 +1640,22 @@ static struct command *_find_command(struct cmd_context *cmd, const char *path,
 	int i, j;
 	int opt_enum, opt_i;
 	int accepted, count;
-	int variants = 0;
+	int first = 0, last = 0;
+	struct command_name *cname;
 
 	name = last_path_component(path);
 
-	/* factor_common_options() is only for usage, so cname->variants is not set. */
-	for (i = 0; i < COMMAND_COUNT; i++) {
-		if (strcmp(name, commands[i].name))
-			continue;
-		variants++;
+	/* Only the command defs with this name are candidates. */
+	if ((cname = find_command_name(name))) {
+		first = cname->first_command;
+		last = first + cname->num_commands;
 	}
 
 	if (arg_is_set(cmd, type_ARG))
 		type_arg = arg_str_value(cmd, type_ARG, "");
 
-	for (i = 0; i < COMMAND_COUNT; i++) {
-		if (strcmp(name, commands[i].name))
-			continue;
-
-		if (variants == 1)
+	for (i = first; i < last; i++) {
+		if (cname->num_commands == 1)
 			only_i = i;
 
 		/* For help and version just return the first entry with matching name. */
@@ -2558,6 +2511,14 @@ static int _get_current_settings(struct cmd_context *cmd)
 	if (arg_is_set(cmd, nohints_ARG))
 		cmd->use_hints = 0;
 
+	/*
+	 * The same commands can limit scanning to the devices file
+	 * entries recorded for the VG they name.
+	 */
+	cmd->use_devicesfile_vgs = (cmd->cname->flags & ALLOW_HINTS) &&
+				   !arg_is_set(cmd, sysinit_ARG) &&
+				   find_config_tree_bool(cmd, devices_devicesfile_vg_scan_CFG, NULL);
+
 	if ((hint_mode = find_config_tree_str(cmd, devices_hints_CFG, NULL))) {
 		if (!strcmp(hint_mode, "none")) {
 			cmd->enable_hints = 0;
@@ -38,6 +38,9 @@ progress_t poll_mirror_progress(struct cmd_context *cmd,
 		return PROGRESS_CHECK_FAILED;
 	}
 
+	/* Baseline for _kernel_progress_changed() */
+	parms->event_nr = event_nr;
+
 	overall_percent = copy_percent(lv);
 	if (parms->progress_display)
 		log_print_unless_silent("%s: %s: %s%%", name, parms->progress_title,
@@ -127,17 +130,22 @@ static void _nanosleep(unsigned secs, unsigned allow_zero_time)
 	sigint_restore();
 }
 
+static void _drop_devices(struct cmd_context *cmd)
+{
+	/*
+	 * FIXME: do we really need to drop everything and then rescan
+	 * everything between each iteration?  What change exactly does
+	 * each iteration check for, and does seeing that require
+	 * rescanning everything?
+	 */
+	lvmcache_destroy(cmd, 1, 0);
+	label_scan_destroy(cmd);
+}
+
 static int _sleep_and_rescan_devices(struct cmd_context *cmd, struct daemon_parms *parms)
 {
 	if (!parms->aborting) {
-		/*
-		 * FIXME: do we really need to drop everything and then rescan
-		 * everything between each iteration?  What change exactly does
-		 * each iteration check for, and does seeing that require
-		 * rescanning everything?
-		 */
-		lvmcache_destroy(cmd, 1, 0);
-		label_scan_destroy(cmd);
+		_drop_devices(cmd);
 		_nanosleep(parms->interval, 0);
 		if (sigint_caught())
 			return_0;
@@ -147,11 +155,55 @@ static int _sleep_and_rescan_devices(struct cmd_context *cmd, struct daemon_parm
 	return 1;
 }
 
+/*
+ * Check progress of a mirror copy from the kernel status alone, using
+ * the LV from the previous VG read.  With a zero interval, wait for the
+ * next event on the device.
+ *
+ * Returns 1 when the VG needs to be read again: the current segment is
+ * in sync, the device raised an event, or its table no longer matches
+ * the LV (e.g. the operation was aborted or finished elsewhere).
+ */
+static int _kernel_progress_changed(struct cmd_context *cmd,
+				    struct logical_volume *lv,
+				    const char *name, struct daemon_parms *parms)
+{
+	dm_percent_t segment_percent = DM_PERCENT_0, overall_percent;
+	uint32_t event_nr = parms->event_nr;
+
+	if (parms->interval) {
+		_nanosleep(parms->interval, 0);
+		if (sigint_caught())
+			return 1;
+	}
+
+	if (!lv_mirror_percent(cmd, lv, !parms->interval, &segment_percent, &event_nr) ||
+	    (segment_percent == DM_PERCENT_INVALID) ||
+	    (segment_percent == DM_PERCENT_100) ||
+	    (event_nr != parms->event_nr)) {
+		log_debug("%s: Rereading VG after device status change.", name);
+		return 1;
+	}
+
+	overall_percent = copy_percent(lv);
+	if (parms->progress_display)
+		log_print_unless_silent("%s: %s: %s%%", name, parms->progress_title,
+					display_percent(cmd, overall_percent));
+	else
+		log_verbose("%s: %s: %s%%", name, parms->progress_title,
+			    display_percent(cmd, overall_percent));
+	fflush(stdout);
+
+	return 0;
+}
+
 int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
 		       struct daemon_parms *parms)
 {
 	struct volume_group *vg = NULL;
+	struct volume_group *status_vg = NULL;
 	struct logical_volume *lv;
+	struct logical_volume *status_lv = NULL;
 	int finished = 0;
 	uint32_t lockd_state = 0;
 	uint32_t error_flags = 0;
@@ -163,8 +215,24 @@ int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
 
 	/* Poll for completion */
 	while (!finished) {
-		if (wait_before_testing &&
-		    !_sleep_and_rescan_devices(cmd, parms)) {
+		if (status_lv) {
+			/*
+			 * Mirror progress is read from the kernel between
+			 * VG reads.  The VG is read again, with a device
+			 * rescan, only once the kernel reports a change.
+			 */
+			while (!_kernel_progress_changed(cmd, status_lv, id->display_name, parms))
+				;
+			release_vg(status_vg);
+			status_vg = NULL;
+			status_lv = NULL;
+			if (sigint_caught()) {
+				log_error("ABORTING: Polling interrupted for %s.", id->display_name);
+				return 0;
+			}
+			lvmcache_label_scan(cmd);
+		} else if (wait_before_testing &&
+			   !_sleep_and_rescan_devices(cmd, parms)) {
 			log_error("ABORTING: Polling interrupted for %s.", id->display_name);
 			return 0;
 		}
@@ -225,7 +293,18 @@ int wait_for_single_lv(struct cmd_context *cmd, struct poll_operation_id *id,
 			goto_out;
 		}
 
-		unlock_and_release_vg(cmd, vg, vg->name);
+		/*
+		 * Keep the LV of an unfinished mirror copy for checking its
+		 * kernel status without the VG lock held.
+		 */
+		if (!finished && !parms->aborting &&
+		    (parms->poll_fns->poll_progress == poll_mirror_progress)) {
+			unlock_vg(cmd, vg, vg->name);
+			status_vg = vg;
+			status_lv = lv;
+			_drop_devices(cmd);
+		} else
+			unlock_and_release_vg(cmd, vg, vg->name);
 
 		if (!lockd_vg(cmd, id->vg_name, "un", 0, &lockd_state))
 			stack;
@@ -671,6 +750,7 @@ static int _daemon_parms_init(struct cmd_context *cmd, struct daemon_parms *parm
 			    parms->interval);
 
 	parms->progress_display = parms->interval ? 1 : 0;
+	parms->event_nr = 0;
 
 	memset(parms->devicesfile, 0, sizeof(parms->devicesfile));
 	if (cmd->devicesfile) {
@@ -22,6 +22,7 @@
 #include "lib/filters/filter.h"
 
 #include <dirent.h>
+#include <sys/file.h>
 
 struct pvscan_params {
 	int new_pvs_found;
@@ -40,9 +41,51 @@ struct pvscan_aa_params {
 
 /*
  * Used by _pvscan_aa_quick() which is an optimization used
- * when one vg is being activated.
+ * when a vg is completed by the devices being scanned.
+ * struct vg_list, one entry per completed vg.
  */
-static struct volume_group *saved_vg;
+static struct dm_list _saved_vgs = DM_LIST_HEAD_INIT(_saved_vgs);
+
+static struct vg_list *_find_saved_vg(const char *vgname)
+{
+	struct vg_list *vgl;
+
+	dm_list_iterate_items(vgl, &_saved_vgs)
+		if (!strcmp(vgl->vg->name, vgname))
+			return vgl;
+
+	return NULL;
+}
+
+static int _save_vg(struct cmd_context *cmd, struct volume_group *vg)
+{
+	struct vg_list *vgl;
+
+	if (_find_saved_vg(vg->name))
+		return 0;
+
+	if (!(vgl = dm_pool_zalloc(cmd->mem, sizeof(*vgl))))
+		return_0;
+
+	vgl->vg = vg;
+	dm_list_add(&_saved_vgs, &vgl->list);
+
+	return 1;
+}
+
+static void _release_saved_vg(struct vg_list *vgl)
+{
+	dm_list_del(&vgl->list);
+	release_vg(vgl->vg);
+}
+
+static void _release_saved_vgs(void)
+{
+	struct vg_list *vgl, *vgl2;
+
+	dm_list_iterate_items_safe(vgl, vgl2, &_saved_vgs)
+		_release_saved_vg(vgl);
+}
 
 static int _pvscan_display_pv(struct cmd_context *cmd,
 				  struct physical_volume *pv,
@@ -501,6 +544,7 @@ static int _get_devs_from_saved_vg(struct cmd_context *cmd, const char *vgname,
 	struct pv_list *pvl;
 	struct device_list *devl;
 	struct device *dev;
+	struct vg_list *vgl;
 	struct volume_group *vg;
 	const char *name1, *name2;
 	dev_t devno;
@@ -513,8 +557,10 @@ static int _get_devs_from_saved_vg(struct cmd_context *cmd, const char *vgname,
 	 * reading all the pvid online files, see which have a matching vg
 	 * name, and getting the device numbers from those files.)
 	 */
-	if (!(vg = saved_vg))
-		goto_bad;
+	if (!(vgl = _find_saved_vg(vgname)))
+		return_0;
+
+	vg = vgl->vg;
 
 	dm_list_iterate_items(pvl, &vg->pvs) {
 		memcpy(pvid, &pvl->pv->id.uuid, ID_LEN);
@@ -569,10 +615,7 @@ static int _get_devs_from_saved_vg(struct cmd_context *cmd, const char *vgname,
 	return 1;
 
 bad:
-	if (saved_vg) {
-		release_vg(saved_vg);
-		saved_vg = NULL;
-	}
+	_release_saved_vg(vgl);
 	return 0;
 }
 
@@ -761,14 +804,26 @@ static int _pvscan_aa(struct cmd_context *cmd, struct pvscan_aa_params *pp,
 	}
 
 	/*
-	 * When saved_vg is set there should only be one vgname.
-	 * If the optimized "quick" function finds something amiss
-	 * it will set no_quick and return so that the slow version
-	 * can be used.
+	 * A vg completed by the scanned devices has been saved, and can use
+	 * the optimized "quick" function.  If it finds something amiss it
+	 * will set no_quick and return so that the slow version can be used.
 	 */
-	if (!do_all && saved_vg && (dm_list_size(vgnames) == 1)) {
-		log_debug("autoactivate quick");
-		ret = _pvscan_aa_quick(cmd, pp, saved_vg->name, &no_quick);
+	ret = ECMD_PROCESSED;
+
+	dm_list_iterate_items_safe(sl, sl2, vgnames) {
+		if (do_all || !_find_saved_vg(sl->str))
+			continue;
+
+		log_debug("autoactivate quick %s", sl->str);
+		no_quick = 0;
+
+		if (_pvscan_aa_quick(cmd, pp, sl->str, &no_quick) != ECMD_PROCESSED) {
+			if (no_quick)
+				continue;
+			ret = ECMD_FAILED;
+		}
+
+		str_list_del(vgnames, sl->str);
 	}
 
 	/*
@@ -776,7 +831,7 @@ static int _pvscan_aa(struct cmd_context *cmd, struct pvscan_aa_params *pp,
 	 * pvscan_cache_all() has already done lvmcache_label_scan
 	 * which does not need to be repeated by process_each_vg.
 	 */
-	if (!saved_vg || (dm_list_size(vgnames) > 1) || no_quick) {
+	if (!dm_list_empty(vgnames)) {
 		uint32_t read_flags = READ_FOR_ACTIVATE;
 
 		log_debug("autoactivate slow");
@@ -791,15 +846,13 @@ static int _pvscan_aa(struct cmd_context *cmd, struct pvscan_aa_params *pp,
 
 		read_flags |= PROCESS_SKIP_SCAN;
 
-		ret = process_each_vg(cmd, 0, NULL, NULL, vgnames, read_flags, 0, handle, _pvscan_aa_single);
+		if (process_each_vg(cmd, 0, NULL, NULL, vgnames, read_flags, 0, handle, _pvscan_aa_single) != ECMD_PROCESSED)
+			ret = ECMD_FAILED;
 	}
 
 	destroy_processing_handle(cmd, handle);
 out:
-	if (saved_vg) {
-		release_vg(saved_vg);
-		saved_vg = NULL;
-	}
+	_release_saved_vgs();
 	return ret;
 }
 
@@ -1020,6 +1073,93 @@ static void _set_pv_devices_online(struct cmd_context *cmd, struct volume_group
 	}
 }
 
+/*
+ * A pvscan --cache --listvg --checkcomplete waiting for a batch
+ * coordinator (see _pvscan_cache_batch).  The coordinator writes the
+ * VG state of the device to a result file named for the waiting pvscan,
+ * which prints it and removes the file.
+ */
+struct batch_waiter {
+	struct dm_list list;
+	dev_t devno;
+	pid_t pid;
+};
+
+/* Set while a batch coordinator processes queued --listvg entries. */
+static struct dm_list *_batch_waiters;
+
+static int _batch_path(char *path, size_t size, dev_t devno, const char *suffix)
+{
+	return dm_snprintf(path, size, "%s/%d:%d%s", PVSCAN_QUEUE_DIR,
+			   (int)MAJOR(devno), (int)MINOR(devno), suffix) >= 0;
+}
+
+static int _batch_result_path(char *path, size_t size, dev_t devno, pid_t pid)
+{
+	char suffix[32];
+
+	return (dm_snprintf(suffix, sizeof(suffix), ".result.%d", (int)pid) >= 0) &&
+		_batch_path(path, size, devno, suffix);
+}
+
+static void _batch_write_result(struct cmd_context *cmd, dev_t devno,
+				const char *state, const char *vgname)
+{
+	struct batch_waiter *bw;
+	char path[PATH_MAX];
+	FILE *fp;
+
+	dm_list_iterate_items(bw, _batch_waiters) {
+		if (bw->devno != devno)
+			continue;
+
+		if (!_batch_result_path(path, sizeof(path), devno, bw->pid))
+			continue;
+
+		if (!(fp = fopen(path, "w"))) {
+			log_error_pvscan(cmd, "Failed to create %s: %d", path, errno);
+			continue;
+		}
+
+		if (vgname)
+			fprintf(fp, "%s %s\n", state, vgname);
+		else
+			fprintf(fp, "%s\n", state);
+
+		if (fclose(fp))
+			log_sys_debug("fclose", path);
+	}
+}
+
+static void _list_vg(struct cmd_context *cmd, const char *vgname, int vg_complete)
+{
+	if (!vgname) {
+		log_print("VG unknown");
+	} else if (!arg_is_set(cmd, checkcomplete_ARG)) {
+		log_print("VG %s", vgname);
+	} else if (vg_complete) {
+		if (arg_is_set(cmd, vgonline_ARG) && !online_vg_file_create(cmd, vgname)) {
+			log_print("VG %s finished", vgname);
+		} else {
+			/*
+			 * A udev rule imports KEY=val from a program's stdout.
+			 * Other output causes udev to ignore everything.
+			 * Run pvscan from udev rule using --udevoutput to
+			 * enable this printf, and suppress all log output
+			 */
+			if (arg_is_set(cmd, udevoutput_ARG))
+				printf("LVM_VG_NAME_COMPLETE='%s'\n", vgname);
+			else
+				log_print("VG %s complete", vgname);
+		}
+	} else {
+		if (arg_is_set(cmd, udevoutput_ARG))
+			printf("LVM_VG_NAME_INCOMPLETE='%s'\n", vgname);
+		else
+			log_print("VG %s incomplete", vgname);
+	}
+}
+
 static int _online_devs(struct cmd_context *cmd, int do_all, struct dm_list *pvscan_devs,
 			int *pv_count, struct dm_list *complete_vgnames)
 {
@@ -1040,7 +1180,6 @@ static int _online_devs(struct cmd_context *cmd, int do_all, struct dm_list *pvs
 	int do_list_lvs = arg_is_set(cmd, listlvs_ARG);
 	int do_list_vg = arg_is_set(cmd, listvg_ARG);
 	int do_check_complete = arg_is_set(cmd, checkcomplete_ARG);
-	int do_vgonline = arg_is_set(cmd, vgonline_ARG);
 	int pvs_online;
 	int pvs_offline;
 	int pvs_unknown;
@@ -1163,6 +1302,8 @@ static int _online_devs(struct cmd_context *cmd, int do_all, struct dm_list *pvs
 		 */
 		if (do_cache && !online_pvid_file_create(cmd, dev, vg ? vg->name : NULL)) {
 			log_error_pvscan(cmd, "PV %s failed to create online file.", dev_name(dev));
+			if (_batch_waiters)
+				_batch_write_result(cmd, dev->dev, "failed", NULL);
 			release_vg(vg);
 			ret = 0;
 			continue;
@@ -1258,31 +1399,10 @@ static int _online_devs(struct cmd_context *cmd, int do_all, struct dm_list *pvs
 			vgname = vg->name;
 
 		if (do_list_vg || do_list_lvs) {
-			if (!vgname) {
-				log_print("VG unknown");
-			} else if (!do_check_complete) {
-				log_print("VG %s", vgname);
-			} else if (vg_complete) {
-				if (do_vgonline && !online_vg_file_create(cmd, vgname)) {
-					log_print("VG %s finished", vgname);
-				} else {
-					/*
-					 * A udev rule imports KEY=val from a program's stdout.
-					 * Other output causes udev to ignore everything.
-					 * Run pvscan from udev rule using --udevoutput to
-					 * enable this printf, and suppress all log output
-					 */
-					if (arg_is_set(cmd, udevoutput_ARG))
-						printf("LVM_VG_NAME_COMPLETE='%s'\n", vgname);
-					else
-						log_print("VG %s complete", vgname);
-				}
-			} else {
-				if (arg_is_set(cmd, udevoutput_ARG))
-					printf("LVM_VG_NAME_INCOMPLETE='%s'\n", vgname);
-				else
-					log_print("VG %s incomplete", vgname);
-			}
+			if (_batch_waiters)
+				_batch_write_result(cmd, dev->dev, vg_complete ? "complete" : "incomplete", vgname);
+			else
+				_list_vg(cmd, vgname, vg_complete);
 
 			/*
 			 * When the VG is complete|finished, we could print
@@ -1349,9 +1469,7 @@ static int _online_devs(struct cmd_context *cmd, int do_all, struct dm_list *pvs
 		 * When "pvscan --cache -aay <dev>" completes the vg, save the
 		 * struct vg to use for quick activation function.
 		 */
-		if (do_activate && !saved_vg && vg && vg_complete && !do_all && (dm_list_size(pvscan_devs) == 1))
-			saved_vg = vg;
-		else
+		if (!(do_activate && vg && vg_complete && !do_all && _save_vg(cmd, vg)))
 			release_vg(vg);
 	}
 
@@ -1445,10 +1563,9 @@ static void _warn_excluded_root(struct cmd_context *cmd, struct device *dev)
 	free((void*) cur_idname);
 }
 
-static int _pvscan_cache_args(struct cmd_context *cmd, int argc, char **argv,
-			      struct dm_list *complete_vgnames)
+static int _pvscan_cache_arg_list(struct cmd_context *cmd, struct dm_list *pvscan_args,
+				  struct dm_list *complete_vgnames)
 {
-	struct dm_list pvscan_args; /* struct pvscan_arg */
 	struct dm_list pvscan_devs; /* struct device_list */
 	struct pvscan_arg *arg;
 	struct device_list *devl, *devl2;
@@ -1456,40 +1573,19 @@ static int _pvscan_cache_args(struct cmd_context *cmd, int argc, char **argv,
 	int pv_count = 0;
 	int ret;
 
-	dm_list_init(&pvscan_args);
 	dm_list_init(&pvscan_devs);
 
-	cmd->expect_missing_vg_device = 1;
-
-	/*
-	 * Special pvscan-specific setup steps to avoid looking
-	 * at any devices except for device args.
-	 * Read devices file and determine if devices file will be used.
-	 * Does not do dev_cache_scan (adds nothing to dev-cache), and
-	 * does not do any device id matching.
-	 */
-	if (!setup_devices_for_online_autoactivation(cmd)) {
-		log_error_pvscan(cmd, "Failed to set up devices.");
-		return 0;
-	}
-
-	/*
-	 * Get list of args.  Do not use filters.
-	 */
-	if (!_get_args(cmd, argc, argv, &pvscan_args))
-		return_0;
-
 	/*
 	 * Get list of devs for args.  Do not use filters.
 	 */
-	if (!_get_args_devs(cmd, &pvscan_args, &pvscan_devs))
+	if (!_get_args_devs(cmd, pvscan_args, &pvscan_devs))
 		return_0;
 
 	/*
 	 * Remove pvid online files for major/minor args for which the dev has
 	 * been removed.
 	 */
-	dm_list_iterate_items(arg, &pvscan_args) {
+	dm_list_iterate_items(arg, pvscan_args) {
 		if (arg->dev || !arg->devno)
 			continue;
 		_online_pvid_file_remove_devno((int)MAJOR(arg->devno), (int)MINOR(arg->devno));
@@ -1655,6 +1751,403 @@ static int _pvscan_cache_args(struct cmd_context *cmd, int argc, char **argv,
 	return ret;
 }
 
+static int _pvscan_cache_setup(struct cmd_context *cmd)
+{
+	cmd->expect_missing_vg_device = 1;
+
+	/*
+	 * Special pvscan-specific setup steps to avoid looking
+	 * at any devices except for device args.
+	 * Read devices file and determine if devices file will be used.
+	 * Does not do dev_cache_scan (adds nothing to dev-cache), and
+	 * does not do any device id matching.
+	 */
+	if (!setup_devices_for_online_autoactivation(cmd)) {
+		log_error_pvscan(cmd, "Failed to set up devices.");
+		return 0;
+	}
+
+	return 1;
+}
+
+static int _pvscan_cache_args(struct cmd_context *cmd, int argc, char **argv,
+			      struct dm_list *complete_vgnames)
+{
+	struct dm_list pvscan_args; /* struct pvscan_arg */
+
+	dm_list_init(&pvscan_args);
+
+	if (!_pvscan_cache_setup(cmd))
+		return_0;
+
+	/*
+	 * Get list of args.  Do not use filters.
+	 */
+	if (!_get_args(cmd, argc, argv, &pvscan_args))
+		return_0;
+
+	return _pvscan_cache_arg_list(cmd, &pvscan_args, complete_vgnames);
+}
+
+/*
+ * Batched event activation (global/event_activation_batch).
+ *
+ * When many PVs appear together, udev starts a pvscan for each one, and
+ * each of them would set up devices, read its PV and count the online
+ * files of the VG.  In batch mode each pvscan creates an entry in
+ * pvscan_queue for its devices and then takes the batch lock.  The
+ * pvscan holding the lock repeatedly takes all queued entries and
+ * processes them together until the queue is empty.
+ *
+ * pvscan --cache -aay is batched with entries named <major>:<minor>,
+ * and the pvscan holding the lock activates the VGs completed by the
+ * batch.  It has nothing to report per device, so it does not wait:
+ * when the lock is held, it leaves its entries to the lock holder and
+ * exits.  The lock holder checks the queue again after releasing the
+ * lock, so entries queued just after its last batch are not missed.
+ *
+ * pvscan --cache --listvg --checkcomplete (used by the udev rule) is
+ * batched with entries named <major>:<minor>.list.<pid>.  The pvscan
+ * holding the lock writes the VG state found for each device to
+ * <major>:<minor>.result.<pid> of each pvscan that queued the device,
+ * and each pvscan prints the result for its own devices the same way
+ * it would have printed it without batching, so that --vgonline and
+ * --udevoutput keep working per device.  These pvscans wait for the
+ * batch lock, so a udev event is not finished until the batch that
+ * includes its device is done.  A batch reads only the PV headers of
+ * the queued devices, which keeps this well within the udev event
+ * timeout (180 seconds by default) even with thousands of devices.
+ */
+
+static int _batch_queue_devno(struct cmd_context *cmd, dev_t devno, const char *suffix)
+{
+	char path[PATH_MAX];
+	int fd;
+
+	if (!_batch_path(path, sizeof(path), devno, suffix)) {
+		log_error_pvscan(cmd, "Path %s/%d:%d is too long.", PVSCAN_QUEUE_DIR,
+				 (int)MAJOR(devno), (int)MINOR(devno));
+		return 0;
+	}
+
+	log_debug("Queue pvscan: %s", path);
+
+	if ((fd = open(path, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR)) < 0) {
+		log_error_pvscan(cmd, "Failed to create %s: %d", path, errno);
+		return 0;
+	}
+
+	if (close(fd))
+		log_sys_debug("close", path);
+
+	return 1;
+}
+
+/*
+ * Parse a queue entry name: <major>:<minor> for -aay or
+ * <major>:<minor>.list.<pid> for --listvg.
+ */
+static int _batch_entry(const char *name, int list, dev_t *devno, pid_t *pid)
+{
+	int major, minor, p, len, len2;
+
+	if ((sscanf(name, "%d:%d%n", &major, &minor, &len) != 2) ||
+	    (major < 0) || (minor < 0))
+		return 0;
+
+	if (!list) {
+		if (name[len])
+			return 0;
+		*pid = 0;
+	} else {
+		if (strncmp(name + len, ".list.", 6) ||
+		    (sscanf(name + len + 6, "%d%n", &p, &len2) != 1) ||
+		    (p <= 0) || name[len + 6 + len2])
+			return 0;
+		*pid = (pid_t) p;
+	}
+
+	*devno = MKDEV(major, minor);
+
+	return 1;
+}
+
+/* Are there queued entries for -aay (list == 0) or --listvg (list == 1)? */
+static int _batch_pending(int list)
+{
+	DIR *dir;
+	struct dirent *de;
+	dev_t devno;
+	pid_t pid;
+	int found = 0;
+
+	if (!(dir = opendir(PVSCAN_QUEUE_DIR)))
+		return 0;
+
+	while (!found && (de = readdir(dir)))
+		found = _batch_entry(de->d_name, list, &devno, &pid);
+
+	if (closedir(dir))
+		log_sys_debug("closedir", PVSCAN_QUEUE_DIR);
+
+	return found;
+}
+
+/*
+ * Move queued entries of the given kind to pvscan_args, one arg per
+ * device, and for --listvg entries add the pvscan that queued each of
+ * them to waiters.  Returns the number of entries moved.
+ */
+static int _batch_dequeue(struct cmd_context *cmd, int list,
+			  struct dm_list *pvscan_args, struct dm_list *waiters)
+{
+	char path[PATH_MAX];
+	struct pvscan_arg *arg;
+	struct batch_waiter *bw;
+	DIR *dir;
+	struct dirent *de;
+	dev_t devno;
+	pid_t pid;
+	int count = 0;
+	int found;
+
+	if (!(dir = opendir(PVSCAN_QUEUE_DIR)))
+		return 0;
+
+	while ((de = readdir(dir))) {
+		if (!_batch_entry(de->d_name, list, &devno, &pid))
+			continue;
+
+		if (dm_snprintf(path, sizeof(path), "%s/%s", PVSCAN_QUEUE_DIR, de->d_name) < 0)
+			continue;
+
+		if (unlink(path)) {
+			log_sys_debug("unlink", path);
+			continue;
+		}
+
+		count++;
+
+		if (list) {
+			if (!(bw = dm_pool_zalloc(cmd->mem, sizeof(*bw))))
+				continue;
+
+			bw->devno = devno;
+			bw->pid = pid;
+			dm_list_add(waiters, &bw->list);
+
+			/*
+			 * The waiter reads its result only after this batch,
+			 * so a result with its name is left from an earlier
+			 * process with the same pid.
+			 */
+			if (_batch_result_path(path, sizeof(path), devno, pid) &&
+			    unlink(path) && (errno != ENOENT))
+				log_sys_debug("unlink", path);
+		}
+
+		found = 0;
+		dm_list_iterate_items(arg, pvscan_args)
+			if (arg->devno == devno)
+				found = 1;
+		if (found)
+			continue;
+
+		if (!(arg = dm_pool_zalloc(cmd->mem, sizeof(*arg))))
+			continue;
+
+		arg->devno = devno;
+		dm_list_add(pvscan_args, &arg->list);
+	}
+
+	if (closedir(dir))
+		log_sys_debug("closedir", PVSCAN_QUEUE_DIR);
+
+	return count;
+}
+
+/*
+ * Print the VG state the batch recorded for a device queued by this
+ * command, and remove the result.  No result means the device has no
+ * VG to report.
+ */
+static int _batch_print_result(struct cmd_context *cmd, dev_t devno)
+{
+	char path[PATH_MAX];
+	char line[NAME_LEN + 32];
+	char *vgname;
+	FILE *fp;
+	int ret = 1;
+
+	if (!_batch_result_path(path, sizeof(path), devno, getpid()))
+		return 1;
+
+	if (!(fp = fopen(path, "r")))
+		return 1;
+
+	if (fgets(line, sizeof(line), fp)) {
+		line[strcspn(line, "\n")] = '\0';
+
+		if ((vgname = strchr(line, ' ')))
+			*vgname++ = '\0';
+
+		if (!strcmp(line, "failed"))
+			ret = 0;
+		else
+			_list_vg(cmd, vgname, !strcmp(line, "complete"));
+	}
+
+	if (fclose(fp))
+		log_sys_debug("fclose", path);
+
+	if (unlink(path))
+		log_sys_debug("unlink", path);
+
+	return ret;
+}
+
+/*
+ * Returns the locked fd, or -1.  Without wait, *busy is set when
+ * another pvscan holds the lock.
+ */
+static int _batch_lock(struct cmd_context *cmd, const char *lock_file, int wait, int *busy)
+{
+	int fd;
+
+	*busy = 0;
+
+	if ((fd = open(lock_file, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR)) < 0) {
+		log_error_pvscan(cmd, "Failed to open %s: %d", lock_file, errno);
+		return -1;
+	}
+
+	while (flock(fd, wait ? LOCK_EX : (LOCK_EX | LOCK_NB))) {
+		if (errno == EINTR)
+			continue;
+		if (errno == EWOULDBLOCK)
+			*busy = 1;
+		else
+			log_error_pvscan(cmd, "Failed to lock %s: %d", lock_file, errno);
+		if (close(fd))
+			log_sys_debug("close", lock_file);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void _batch_unlock(int fd, const char *lock_file)
+{
+	if (flock(fd, LOCK_UN))
+		log_sys_debug("flock", lock_file);
+	if (close(fd))
+		log_sys_debug("close", lock_file);
+}
+
+static int _pvscan_cache_batch(struct cmd_context *cmd, int argc, char **argv,
+			       struct pvscan_aa_params *pp)
+{
+	struct dm_list pvscan_args; /* struct pvscan_arg */
+	struct dm_list batch_args; /* struct pvscan_arg */
+	struct dm_list waiters; /* struct batch_waiter */
+	struct dm_list complete_vgnames;
+	struct pvscan_arg *arg;
+	struct stat st;
+	int do_activate = arg_is_set(cmd, activate_ARG);
+	const char *lock_file = do_activate ? PVSCAN_BATCH_LOCK_FILE : PVSCAN_LIST_BATCH_LOCK_FILE;
+	char suffix[32] = "";
+	unsigned batches = 0;
+	int setup_done = 0;
+	int queued = 0;
+	int ret = ECMD_PROCESSED;
+	int count;
+	int busy;
+	int fd;
+
+	dm_list_init(&pvscan_args);
+
+	if (!_get_args(cmd, argc, argv, &pvscan_args))
+		return_ECMD_FAILED;
+
+	if (!do_activate &&
+	    (dm_snprintf(suffix, sizeof(suffix), ".list.%d", (int)getpid()) < 0))
+		return_ECMD_FAILED;
+
+	dm_list_iterate_items(arg, &pvscan_args) {
+		if (!arg->devno) {
+			if (stat(arg->devname, &st) || !S_ISBLK(st.st_mode)) {
+				log_print_pvscan(cmd, "%s not found for batch.", arg->devname);
+				continue;
+			}
+			arg->devno = st.st_rdev;
+		}
+
+		if (!_batch_queue_devno(cmd, arg->devno, suffix))
+			return ECMD_FAILED;
+		queued++;
+	}
+
+	if (!queued)
+		return ECMD_PROCESSED;
+
+	while (1) {
+		if ((fd = _batch_lock(cmd, lock_file, !do_activate, &busy)) < 0) {
+			if (!busy)
+				return ECMD_FAILED;
+			log_debug("pvscan queued devices for the pvscan holding the batch lock.");
+			break;
+		}
+
+		/* Entries of this command may have been taken by an earlier batch. */
+		while (1) {
+			dm_list_init(&batch_args);
+			dm_list_init(&waiters);
+			dm_list_init(&complete_vgnames);
+
+			if (!(count = _batch_dequeue(cmd, !do_activate, &batch_args, &waiters)))
+				break;
+
+			if (!do_activate)
+				_batch_waiters = &waiters;
+
+			if (!setup_done && !(setup_done = _pvscan_cache_setup(cmd))) {
+				/* Waiting pvscans report the failure for their devices. */
+				if (_batch_waiters)
+					dm_list_iterate_items(arg, &batch_args)
+						_batch_write_result(cmd, arg->devno, "failed", NULL);
+				_batch_waiters = NULL;
+				ret = ECMD_FAILED;
+				break;
+			}
+
+			batches++;
+			log_debug("pvscan batch %u processing %d queued devices.", batches, count);
+
+			if (!_pvscan_cache_arg_list(cmd, &batch_args, &complete_vgnames))
+				ret = ECMD_FAILED;
+
+			_batch_waiters = NULL;
+
+			if (do_activate && !dm_list_empty(&complete_vgnames) &&
+			    (_pvscan_aa(cmd, pp, 0, &complete_vgnames) != ECMD_PROCESSED))
+				ret = ECMD_FAILED;
+		}
+
+		if (!do_activate)
+			dm_list_iterate_items(arg, &pvscan_args)
+				if (arg->devno && !_batch_print_result(cmd, arg->devno))
+					ret = ECMD_FAILED;
+
+		_batch_unlock(fd, lock_file);
+
+		/* pvscan -aay commands that found the lock held left entries. */
+		if (!do_activate || !_batch_pending(0))
+			break;
+	}
+
+	return ret;
+}
+
 static int _get_autoactivation(struct cmd_context *cmd, int event_activation, int *skip_command)
 {
 	const char *aa_str;
@@ -1760,6 +2253,25 @@ int pvscan_cache_cmd(struct cmd_context *cmd, int argc, char **argv)
 		if (skip_command)
 			return ECMD_PROCESSED;
 
+		/*
+		 * Batch pvscan --cache -aay, and pvscan --cache --listvg
+		 * --checkcomplete run by the udev rule.  --listlvs prints
+		 * per-LV state that is not recorded in batch results.
+		 */
+		if (!arg_is_set(cmd, listlvs_ARG) &&
+		    (do_activate ? !arg_is_set(cmd, listvg_ARG) :
+		     (arg_is_set(cmd, listvg_ARG) && arg_is_set(cmd, checkcomplete_ARG))) &&
+		    find_config_tree_bool(cmd, global_event_activation_batch_CFG, NULL)) {
+			ret = _pvscan_cache_batch(cmd, argc, argv, &pp);
+
+			if (pp.activate_errors)
+				ret = ECMD_FAILED;
+
+			if (!sync_local_dev_names(cmd))
+				stack;
+			return ret;
+		}
+
 		if (!_pvscan_cache_args(cmd, argc, argv, &complete_vgnames))
 			return ECMD_FAILED;
 	}
@@ -33,6 +33,8 @@ static int _monitor_lvs_in_vg(struct cmd_context *cmd,
 	struct logical_volume *lv;
 	int r = 1;
 
+	monitor_batch_begin(cmd);
+
 	dm_list_iterate_items(lvl, &vg->lvs) {
 		lv = lvl->lv;
 
@@ -53,6 +55,9 @@ static int _monitor_lvs_in_vg(struct cmd_context *cmd,
 		(*count)++;
 	}
 
+	if (!monitor_batch_end(cmd))
+		r = 0;
+
 	return r;
 }
 
@@ -89,9 +94,13 @@ static int _activate_lvs_in_vg(struct cmd_context *cmd, struct volume_group *vg,
 	int count = 0, expected_count = 0, r = 1;
 
 	sigint_allow();
+	monitor_batch_begin(cmd);
 	dm_list_iterate_items(lvl, &vg->lvs) {
-		if (sigint_caught())
+		if (sigint_caught()) {
+			if (!monitor_batch_end(cmd))
+				stack;
 			return_0;
+		}
 
 		lv = lvl->lv;
 
@@ -135,6 +144,9 @@ static int _activate_lvs_in_vg(struct cmd_context *cmd, struct volume_group *vg,
 		count++;
 	}
 
+	if (!monitor_batch_end(cmd))
+		r = 0;
+
 	sigint_restore();
 
 	if (expected_count)